@@ -52,10 +52,11 @@ std::string CManagedAccountData::ToString() const
 {
     std::string output = ValueFromRoles(GetRoles()).get_str() + " | " + EncodeDestination(GetParent()) + " | ";
 
-    for(size_t i=0; i<accountChildren.size(); i++) {
-        output += EncodeDestination(accountChildren.at(i));
+    const std::vector<std::string> children = EncodeDestinations(accountChildren);
+    for(size_t i=0; i<children.size(); i++) {
+        output += children.at(i);
 
-        if(i != accountChildren.size() - 1) {
+        if(i != children.size() - 1) {
             output += " , ";
         }
     }
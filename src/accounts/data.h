@@ -46,10 +46,11 @@ public:
     {
         out << ValueFromRoles(obj.GetRoles()).get_str() << ";" << EncodeDestination(obj.GetParent()) << ";";
 
-        for(size_t i=0; i<obj.GetChildren().size(); i++) {
-            out << EncodeDestination(obj.GetChildren().at(i));
+        const std::vector<std::string> children = EncodeDestinations(obj.GetChildren());
+        for(size_t i=0; i<children.size(); i++) {
+            out << children.at(i);
 
-            if(i != obj.GetChildren().size()-1) {
+            if(i != children.size()-1) {
                 out << "|";
             }
         }
@@ -78,8 +79,8 @@ public:
             std::vector<std::string> accountChildrenRaw;
             boost::split(accountChildrenRaw, accountData.at(2), [](char c){return c == '|';});
 
-            for(size_t i=0; i<accountChildrenRaw.size(); i++) {
-                obj.AddChild(DecodeDestination(accountChildrenRaw.at(i)));
+            for(const CTxDestination& child : DecodeDestinations(accountChildrenRaw)) {
+                obj.AddChild(child);
             }
         }
 
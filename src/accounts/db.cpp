@@ -101,6 +101,10 @@ int CManagedAccountDB::size() {
     return accountDB.size();
 }
 
+const std::map<CTxDestination, CManagedAccountData>& CManagedAccountDB::GetAccounts() const {
+    return accountDB;
+}
+
 void CManagedAccountDB::ResetDB() {
     accountDB = std::map<CTxDestination, CManagedAccountData>();
     SaveToDisk();
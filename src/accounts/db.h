@@ -32,6 +32,7 @@ public:
     bool GetAccountByAddress(CTxDestination address, CManagedAccountData& account);
     bool ExistsAccountForAddress(CTxDestination address);
     int size();
+    const std::map<CTxDestination, CManagedAccountData>& GetAccounts() const;
     std::string ToString();
 
 private:
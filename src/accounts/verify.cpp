@@ -0,0 +1,247 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <accounts/verify.h>
+
+#include <chainparams.h>
+#include <txdb.h>
+#include <ui_interface.h>
+#include <utiltime.h>
+
+#include <atomic>
+
+#include <boost/thread.hpp>
+
+/** The first byte of the txids of partition p out of nPartitions */
+static unsigned int PartitionBegin(int p, int nPartitions)
+{
+    return p * 256 / nPartitions;
+}
+
+/** Scan the coins from the cursor on, up to the first txid starting with nEnd */
+static bool ScanRoleCoinsPartition(CCoinsViewCursor* pcursor, unsigned int nEnd,
+                                   RoleCoinMap& roleCoins, uint64_t& nCoinsScanned)
+{
+    CTxDestination dest;
+
+    for (; pcursor->Valid(); pcursor->Next()) {
+        COutPoint key;
+        Coin coin;
+        if (!pcursor->GetKey(key))
+            return false;
+        if (*key.hash.begin() >= nEnd)
+            break;
+        if (!pcursor->GetValue(coin))
+            return false;
+        nCoinsScanned++;
+        if (coin.out.nTxType != CTxOut::ROLE_CHANGE)
+            continue;
+        if (!ExtractDestination(coin.out.scriptPubKey, dest))
+            continue;
+        roleCoins[dest].push_back(coin.out.nRole);
+    }
+    return true;
+}
+
+RoleCoinCursors OpenRoleCoinCursors(const CCoinsViewDB& view, int nPartitions)
+{
+    nPartitions = std::max(1, std::min(nPartitions, 256));
+
+    RoleCoinCursors cursors;
+    for (int p = 0; p < nPartitions; p++) {
+        uint256 hashStart;
+        *hashStart.begin() = (unsigned char)PartitionBegin(p, nPartitions);
+        cursors.emplace_back(view.Cursor(hashStart));
+    }
+    return cursors;
+}
+
+bool ScanRoleCoins(RoleCoinCursors& cursors, RoleCoinMap& roleCoins, uint64_t& nCoinsScanned,
+                   const std::function<void(int)>& progress)
+{
+    const int nPartitions = cursors.size();
+    if (nPartitions == 0)
+        return false;
+
+    std::vector<RoleCoinMap> vRoleCoins(nPartitions);
+    std::vector<uint64_t> vCoinsScanned(nPartitions, 0);
+    std::vector<char> vResults(nPartitions, 0);
+    std::atomic<int> nDone(0);
+
+    // Each thread takes every nThreads-th partition
+    const int nThreads = std::min(nPartitions, std::max(1, GetNumCores()));
+    boost::thread_group threadGroup;
+    for (int t = 0; t < nThreads; t++) {
+        threadGroup.create_thread([&, t] {
+            for (int p = t; p < nPartitions; p += nThreads) {
+                vResults[p] = ScanRoleCoinsPartition(cursors[p].get(), PartitionBegin(p + 1, nPartitions),
+                                                     vRoleCoins[p], vCoinsScanned[p]);
+                nDone++;
+            }
+        });
+    }
+    while (nDone < nPartitions) {
+        if (progress)
+            progress(nDone * 100 / nPartitions);
+        MilliSleep(100);
+    }
+    threadGroup.join_all();
+    if (progress)
+        progress(100);
+
+    if (std::find(vResults.begin(), vResults.end(), 0) != vResults.end())
+        return false;
+
+    // Merge the partitions
+    nCoinsScanned = 0;
+    roleCoins.clear();
+    for (int p = 0; p < nPartitions; p++) {
+        nCoinsScanned += vCoinsScanned[p];
+        for (auto& entry : vRoleCoins[p]) {
+            std::vector<CRoleChangeMode>& roles = roleCoins[entry.first];
+            roles.insert(roles.end(), entry.second.begin(), entry.second.end());
+        }
+    }
+    return true;
+}
+
+bool ScanRoleCoins(const CCoinsViewDB& view, RoleCoinMap& roleCoins, uint64_t& nCoinsScanned,
+                   int nPartitions, const std::function<void(int)>& progress)
+{
+    RoleCoinCursors cursors = OpenRoleCoinCursors(view, nPartitions);
+    return ScanRoleCoins(cursors, roleCoins, nCoinsScanned, progress);
+}
+
+/** Add the role coins created by the genesis block */
+static void AddGenesisRoleCoins(const CBlock& genesis, RoleCoinMap& roleCoins)
+{
+    CTxDestination dest;
+    for (const CTransactionRef& tx : genesis.vtx) {
+        for (const CTxOut& txout : tx->vout) {
+            if (txout.nTxType == CTxOut::ROLE_CHANGE && ExtractDestination(txout.scriptPubKey, dest)) {
+                roleCoins[dest].push_back(txout.nRole);
+            }
+        }
+    }
+}
+
+void CheckAccountTree(const CManagedAccountDB& accountDB, CAccountCheckResult& result)
+{
+    const std::map<CTxDestination, CManagedAccountData>& accounts = accountDB.GetAccounts();
+
+    for (const auto& entry : accounts) {
+        const CTxDestination& address = entry.first;
+        const CTxDestination& parent = entry.second.GetParent();
+
+        if (!IsValidDestination(parent)) {
+            result.vRoots.push_back(address);
+            continue;
+        }
+
+        // The parent must exist and list this account among its children
+        auto parentIter = accounts.find(parent);
+        if (parentIter == accounts.end()) {
+            result.vOrphanedChildren.push_back(address);
+            continue;
+        }
+        const std::vector<CTxDestination>& siblings = parentIter->second.GetChildren();
+        if (std::find(siblings.begin(), siblings.end(), address) == siblings.end()) {
+            result.vOrphanedChildren.push_back(address);
+        }
+    }
+
+    // Children listed by a parent must exist and point back to that parent
+    for (const auto& entry : accounts) {
+        for (const CTxDestination& child : entry.second.GetChildren()) {
+            auto childIter = accounts.find(child);
+            if (childIter == accounts.end() || childIter->second.GetParent() != entry.first) {
+                result.vOrphanedChildren.push_back(child);
+            }
+        }
+    }
+
+    // A broken link may have been reported from both sides
+    std::sort(result.vOrphanedChildren.begin(), result.vOrphanedChildren.end());
+    result.vOrphanedChildren.erase(std::unique(result.vOrphanedChildren.begin(), result.vOrphanedChildren.end()), result.vOrphanedChildren.end());
+}
+
+void CheckAccountRoles(const CManagedAccountDB& accountDB, const RoleCoinMap& roleCoins, CAccountCheckResult& result)
+{
+    const std::map<CTxDestination, CManagedAccountData>& accounts = accountDB.GetAccounts();
+
+    for (const auto& entry : roleCoins) {
+        result.nRoleCoins += entry.second.size();
+        if (entry.second.size() > 1) {
+            result.vDuplicateCredentials.push_back(entry.first);
+        }
+        if (accounts.find(entry.first) == accounts.end()) {
+            result.vMismatchedRoles.push_back(entry.first);
+        }
+    }
+
+    for (const auto& entry : accounts) {
+        auto coinsIter = roleCoins.find(entry.first);
+        if (coinsIter == roleCoins.end()) {
+            result.vMismatchedRoles.push_back(entry.first);
+            continue;
+        }
+        const std::vector<CRoleChangeMode>& roles = coinsIter->second;
+        if (std::find(roles.begin(), roles.end(), entry.second.GetRoles()) == roles.end()) {
+            result.vMismatchedRoles.push_back(entry.first);
+        }
+    }
+}
+
+bool VerifyAccounts(const CManagedAccountDB& accountDB, const CCoinsViewDB& view, int nCheckLevel, CAccountCheckResult& result)
+{
+    RoleCoinCursors cursors;
+    if (nCheckLevel >= 2)
+        cursors = OpenRoleCoinCursors(view);
+    return VerifyAccounts(accountDB, cursors, nCheckLevel, result);
+}
+
+bool VerifyAccounts(const CManagedAccountDB& accountDB, RoleCoinCursors& cursors, int nCheckLevel, CAccountCheckResult& result)
+{
+    if (nCheckLevel <= 0)
+        return true;
+
+    LogPrintf("Verifying %u accounts at level %i\n", accountDB.GetAccounts().size(), nCheckLevel);
+    CheckAccountTree(accountDB, result);
+
+    if (nCheckLevel >= 2) {
+        RoleCoinMap roleCoins;
+        int nReported = -1;
+        LogPrintf("[0%%]...");
+        bool fScanned = ScanRoleCoins(cursors, roleCoins, result.nCoinsScanned,
+            [&nReported](int percentageDone) {
+                if (percentageDone / 10 != nReported / 10) {
+                    nReported = percentageDone;
+                    LogPrintf("[%d%%]...", percentageDone);
+                }
+                uiInterface.ShowProgress(_("Verifying accounts..."), percentageDone, false);
+            });
+        uiInterface.ShowProgress("", 100, false);
+        LogPrintf("\n");
+        if (!fScanned)
+            return error("%s: unable to read the chainstate", __func__);
+        // The account tree is given the accounts of the genesis block when it
+        // is loaded, but its coins only enter the chainstate once it is
+        // connected, which a fresh node has not done yet.
+        if (cursors.front()->GetBestBlock().IsNull())
+            AddGenesisRoleCoins(Params().GenesisBlock(), roleCoins);
+        CheckAccountRoles(accountDB, roleCoins, result);
+    }
+
+    for (const CTxDestination& address : result.vMismatchedRoles)
+        LogPrintf("VerifyAccounts(): roles mismatch for %s\n", EncodeDestination(address));
+    for (const CTxDestination& address : result.vOrphanedChildren)
+        LogPrintf("VerifyAccounts(): orphaned child %s\n", EncodeDestination(address));
+    for (const CTxDestination& address : result.vDuplicateCredentials)
+        LogPrintf("VerifyAccounts(): duplicate credentials for %s\n", EncodeDestination(address));
+    if (result.vRoots.size() != 1)
+        LogPrintf("VerifyAccounts(): expected one root account, found %u\n", result.vRoots.size());
+
+    LogPrintf("%s: account tree is %s\n", __func__, result.IsValid() ? "consistent" : "inconsistent");
+    return result.IsValid();
+}
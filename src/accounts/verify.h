@@ -0,0 +1,84 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+#ifndef BITCOIN_ACCOUNT_VERIFY_H
+#define BITCOIN_ACCOUNT_VERIFY_H
+
+#include <accounts/db.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+class CCoinsViewCursor;
+class CCoinsViewDB;
+
+/** Default for -checkaccounts */
+static const int DEFAULT_CHECKACCOUNTS = 0;
+/** Number of txid ranges the chainstate is split into when scanning */
+static const int DEFAULT_ACCOUNT_SCAN_PARTITIONS = 16;
+
+/** Unspent role change coins in the chainstate, by address */
+typedef std::map<CTxDestination, std::vector<CRoleChangeMode>> RoleCoinMap;
+
+/** Inconsistencies found between accounts.dat and the chainstate */
+struct CAccountCheckResult
+{
+    uint64_t nCoinsScanned = 0;
+    uint64_t nRoleCoins = 0;
+
+    //! Accounts whose roles differ between accounts.dat and the chainstate,
+    //! including accounts that are only present on one side
+    std::vector<CTxDestination> vMismatchedRoles;
+    //! Accounts whose parent is unknown or does not list them as a child
+    std::vector<CTxDestination> vOrphanedChildren;
+    //! Accounts without a parent; exactly one is expected
+    std::vector<CTxDestination> vRoots;
+    //! Addresses holding more than one unspent role change coin
+    std::vector<CTxDestination> vDuplicateCredentials;
+
+    bool IsValid() const
+    {
+        return vMismatchedRoles.empty() && vOrphanedChildren.empty() && vRoots.size() == 1 && vDuplicateCredentials.empty();
+    }
+};
+
+/**
+ * Cursors at the start of each of the txid ranges the chainstate is split into
+ * for a scan. A cursor reads the chainstate as it was when it was opened, so
+ * cursors opened together while holding cs_main are a consistent snapshot
+ * that can be scanned after releasing it.
+ */
+typedef std::vector<std::unique_ptr<CCoinsViewCursor>> RoleCoinCursors;
+
+/** Open cursors on nPartitions ranges of the txid space of the chainstate. */
+RoleCoinCursors OpenRoleCoinCursors(const CCoinsViewDB& view, int nPartitions = DEFAULT_ACCOUNT_SCAN_PARTITIONS);
+
+/**
+ * Collect all unspent role change coins from the given cursors, scanning
+ * their ranges in parallel. progress is called from the calling thread with
+ * the percentage done.
+ */
+bool ScanRoleCoins(RoleCoinCursors& cursors, RoleCoinMap& roleCoins, uint64_t& nCoinsScanned,
+                   const std::function<void(int)>& progress = nullptr);
+
+/** Collect all unspent role change coins of the chainstate, split in nPartitions ranges. */
+bool ScanRoleCoins(const CCoinsViewDB& view, RoleCoinMap& roleCoins, uint64_t& nCoinsScanned,
+                   int nPartitions = DEFAULT_ACCOUNT_SCAN_PARTITIONS,
+                   const std::function<void(int)>& progress = nullptr);
+
+/** Check the structure of the account tree: roots and parent/child links. */
+void CheckAccountTree(const CManagedAccountDB& accountDB, CAccountCheckResult& result);
+
+/** Compare the roles recorded in the account tree with the given role coins. */
+void CheckAccountRoles(const CManagedAccountDB& accountDB, const RoleCoinMap& roleCoins, CAccountCheckResult& result);
+
+/**
+ * Verify the account tree. Level 1 only checks the tree structure, level 2
+ * also scans the chainstate through the given cursors and compares the roles.
+ */
+bool VerifyAccounts(const CManagedAccountDB& accountDB, RoleCoinCursors& cursors, int nCheckLevel, CAccountCheckResult& result);
+bool VerifyAccounts(const CManagedAccountDB& accountDB, const CCoinsViewDB& view, int nCheckLevel, CAccountCheckResult& result);
+
+#endif // BITCOIN_ACCOUNT_VERIFY_H
@@ -0,0 +1,53 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addressindex.h>
+
+#include <hash.h>
+
+uint160 GetAddressIndexHash(const CTxDestination& dest)
+{
+    const CScript script = GetScriptForDestination(dest);
+    return Hash160(script.begin(), script.end());
+}
+
+bool GetAddressIndexHash(const CScript& scriptPubKey, uint160& hashRet)
+{
+    CTxDestination dest;
+    if (!ExtractDestination(scriptPubKey, dest))
+        return false;
+    hashRet = GetAddressIndexHash(dest);
+    return true;
+}
+
+void AddAddressOutputs(const CTransaction& tx, int nHeight, AddressUnspentUpdates& updates)
+{
+    const bool fCoinBase = tx.IsCoinBase();
+    for (size_t i = 0; i < tx.vout.size(); i++) {
+        const CTxOut& txout = tx.vout[i];
+        uint160 hashDest;
+        if (txout.scriptPubKey.IsUnspendable() || !GetAddressIndexHash(txout.scriptPubKey, hashDest))
+            continue;
+        updates.emplace_back(CAddressUnspentKey(hashDest, COutPoint(tx.GetHash(), i)), Coin(txout, nHeight, fCoinBase));
+    }
+}
+
+void RemoveAddressOutputs(const CTransaction& tx, AddressUnspentUpdates& updates)
+{
+    for (size_t i = 0; i < tx.vout.size(); i++) {
+        const CTxOut& txout = tx.vout[i];
+        uint160 hashDest;
+        if (txout.scriptPubKey.IsUnspendable() || !GetAddressIndexHash(txout.scriptPubKey, hashDest))
+            continue;
+        updates.emplace_back(CAddressUnspentKey(hashDest, COutPoint(tx.GetHash(), i)), Coin());
+    }
+}
+
+void UpdateAddressInput(const COutPoint& prevout, const Coin& coin, bool fRestore, AddressUnspentUpdates& updates)
+{
+    uint160 hashDest;
+    if (!GetAddressIndexHash(coin.out.scriptPubKey, hashDest))
+        return;
+    updates.emplace_back(CAddressUnspentKey(hashDest, prevout), fRestore ? coin : Coin());
+}
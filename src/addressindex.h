@@ -0,0 +1,60 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ADDRESSINDEX_H
+#define BITCOIN_ADDRESSINDEX_H
+
+#include <coins.h>
+#include <primitives/transaction.h>
+#include <pubkey.h>
+#include <script/standard.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <utility>
+#include <vector>
+
+/** Default for -addressindex */
+static const bool DEFAULT_ADDRESSINDEX = false;
+
+/**
+ * Hash a destination is indexed under: the Hash160 of its standard script.
+ * Pay-to-pubkey outputs are thus found under the key hash of their pubkey.
+ */
+uint160 GetAddressIndexHash(const CTxDestination& dest);
+
+/** The index hash of the destination paid by a script, if it has one */
+bool GetAddressIndexHash(const CScript& scriptPubKey, uint160& hashRet);
+
+/** Key of an unspent output in the address index */
+struct CAddressUnspentKey {
+    uint160 hashDest;
+    COutPoint outpoint;
+
+    CAddressUnspentKey() {}
+    CAddressUnspentKey(const uint160& hashDestIn, const COutPoint& outpointIn) : hashDest(hashDestIn), outpoint(outpointIn) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(hashDest);
+        READWRITE(outpoint);
+    }
+};
+
+/**
+ * Changes to the address index made by a block: the unspent coin stored at
+ * each key, or a spent coin to remove the key. Later entries win.
+ */
+typedef std::vector<std::pair<CAddressUnspentKey, Coin>> AddressUnspentUpdates;
+
+/** Record the outputs of tx created at nHeight */
+void AddAddressOutputs(const CTransaction& tx, int nHeight, AddressUnspentUpdates& updates);
+/** Record the removal of the outputs of tx, when disconnecting it */
+void RemoveAddressOutputs(const CTransaction& tx, AddressUnspentUpdates& updates);
+/** Record the coin spent by an input, or restored when disconnecting it with fRestore */
+void UpdateAddressInput(const COutPoint& prevout, const Coin& coin, bool fRestore, AddressUnspentUpdates& updates);
+
+#endif // BITCOIN_ADDRESSINDEX_H
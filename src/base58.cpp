@@ -20,94 +20,206 @@
 
 /** All alphanumeric characters except for "0", "I", "O", and "l" */
 static const char* pszBase58 = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+static const int8_t mapBase58[256] = {
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1, 0, 1, 2, 3, 4, 5, 6,  7, 8,-1,-1,-1,-1,-1,-1,
+    -1, 9,10,11,12,13,14,15, 16,-1,17,18,19,20,21,-1,
+    22,23,24,25,26,27,28,29, 30,31,32,-1,-1,-1,-1,-1,
+    -1,33,34,35,36,37,38,39, 40,41,42,43,-1,44,45,46,
+    47,48,49,50,51,52,53,54, 55,56,57,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+};
 
-bool DecodeBase58(const char* psz, std::vector<unsigned char>& vch)
+/**
+ * The conversions work on limbs rather than on single digits: 32-bit limbs
+ * for base256, and limbs of 5 digits for base58, as 58^5 is the largest power
+ * of 58 that fits in 32 bits. A limb times 2^32 plus a carry then fits in 64
+ * bits, which makes for four times fewer multiplications than a digit at a
+ * time.
+ */
+static const uint32_t BASE58_LIMB = 58 * 58 * 58 * 58 * 58;
+static const int BASE58_LIMB_DIGITS = 5;
+
+namespace {
+
+/** Buffers for the conversions, which a batch reuses from one item to the next */
+struct Base58Buffers {
+    //! limbs of the number being converted, least significant first
+    std::vector<uint32_t> limbs;
+    //! the decoded bytes, or the bytes to encode along with their checksum
+    std::vector<unsigned char> bytes;
+};
+
+void EncodeBase58Buffered(const unsigned char* pbegin, const unsigned char* pend, std::vector<uint32_t>& b58, std::string& str)
+{
+    // Skip & count leading zeroes.
+    int zeroes = 0;
+    while (pbegin != pend && *pbegin == 0) {
+        pbegin++;
+        zeroes++;
+    }
+    // Allocate enough limbs for the base58 representation.
+    size_t size = ((pend - pbegin) * 138 / 100 + 1) / BASE58_LIMB_DIGITS + 1; // log(256) / log(58), rounded up.
+    b58.assign(size, 0);
+    size_t length = 0;
+    // Process the bytes 4 at a time, the first chunk taking the remainder.
+    size_t nChunk = (pend - pbegin) % 4;
+    if (nChunk == 0) {
+        nChunk = 4;
+    }
+    while (pbegin != pend) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < nChunk; j++) {
+            carry = (carry << 8) | *pbegin++;
+        }
+        // Apply "b58 = b58 * 256^nChunk + chunk".
+        const int shift = 8 * nChunk;
+        size_t i = 0;
+        for (; i < length; i++) {
+            carry += (uint64_t)b58[i] << shift;
+            b58[i] = carry % BASE58_LIMB;
+            carry /= BASE58_LIMB;
+        }
+        for (; carry != 0; i++) {
+            assert(i < size);
+            b58[i] = carry % BASE58_LIMB;
+            carry /= BASE58_LIMB;
+        }
+        length = i;
+        nChunk = 4;
+    }
+    // Translate the result into a string, skipping the leading zeroes of the
+    // most significant limb.
+    str.reserve(zeroes + length * BASE58_LIMB_DIGITS);
+    str.assign(zeroes, '1');
+    for (size_t i = length; i-- > 0;) {
+        char digits[BASE58_LIMB_DIGITS];
+        uint32_t limb = b58[i];
+        for (int j = BASE58_LIMB_DIGITS - 1; j >= 0; j--) {
+            digits[j] = pszBase58[limb % 58];
+            limb /= 58;
+        }
+        int skip = 0;
+        if (i == length - 1) {
+            while (digits[skip] == '1') {
+                skip++;
+            }
+        }
+        str.append(digits + skip, BASE58_LIMB_DIGITS - skip);
+    }
+}
+
+bool DecodeBase58Buffered(const char* psz, std::vector<uint32_t>& b256, std::vector<unsigned char>& vch)
 {
     // Skip leading spaces.
     while (*psz && isspace(*psz))
         psz++;
     // Skip and count leading '1's.
     int zeroes = 0;
-    int length = 0;
     while (*psz == '1') {
         zeroes++;
         psz++;
     }
-    // Allocate enough space in big-endian base256 representation.
-    int size = strlen(psz) * 733 /1000 + 1; // log(58) / log(256), rounded up.
-    std::vector<unsigned char> b256(size);
-    // Process the characters.
+    // Allocate enough limbs for the base256 representation.
+    size_t size = strlen(psz) * 733 / 1000 / 4 + 2; // log(58) / log(256), rounded up.
+    b256.assign(size, 0);
+    size_t length = 0;
+    // Process the characters up to 5 at a time.
     while (*psz && !isspace(*psz)) {
-        // Decode base58 character
-        const char* ch = strchr(pszBase58, *psz);
-        if (ch == nullptr)
-            return false;
-        // Apply "b256 = b256 * 58 + ch".
-        int carry = ch - pszBase58;
-        int i = 0;
-        for (std::vector<unsigned char>::reverse_iterator it = b256.rbegin(); (carry != 0 || i < length) && (it != b256.rend()); ++it, ++i) {
-            carry += 58 * (*it);
-            *it = carry % 256;
-            carry /= 256;
+        uint64_t carry = 0;
+        uint32_t mul = 1;
+        for (int j = 0; j < BASE58_LIMB_DIGITS && *psz && !isspace(*psz); j++, psz++) {
+            // Decode base58 character
+            int8_t digit = mapBase58[(uint8_t)*psz];
+            if (digit == -1)
+                return false;
+            carry = carry * 58 + digit;
+            mul *= 58;
+        }
+        // Apply "b256 = b256 * 58^j + chunk".
+        size_t i = 0;
+        for (; i < length; i++) {
+            carry += (uint64_t)b256[i] * mul;
+            b256[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        for (; carry != 0; i++) {
+            assert(i < size);
+            b256[i] = (uint32_t)carry;
+            carry >>= 32;
         }
-        assert(carry == 0);
         length = i;
-        psz++;
     }
     // Skip trailing spaces.
     while (isspace(*psz))
         psz++;
     if (*psz != 0)
         return false;
-    // Skip leading zeroes in b256.
-    std::vector<unsigned char>::iterator it = b256.begin() + (size - length);
-    while (it != b256.end() && *it == 0)
-        it++;
-    // Copy result into output vector.
-    vch.reserve(zeroes + (b256.end() - it));
+    // Copy result into output vector, skipping the leading zeroes of the most
+    // significant limb.
+    vch.reserve(zeroes + length * 4);
     vch.assign(zeroes, 0x00);
-    while (it != b256.end())
-        vch.push_back(*(it++));
+    for (size_t i = length; i-- > 0;) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            unsigned char c = b256[i] >> shift;
+            if (i == length - 1 && vch.size() == (size_t)zeroes && c == 0)
+                continue;
+            vch.push_back(c);
+        }
+    }
     return true;
 }
 
-std::string EncodeBase58(const unsigned char* pbegin, const unsigned char* pend)
+void EncodeBase58CheckBuffered(const unsigned char* pbegin, const unsigned char* pend, Base58Buffers& buffers, std::string& str)
 {
-    // Skip & count leading zeroes.
-    int zeroes = 0;
-    int length = 0;
-    while (pbegin != pend && *pbegin == 0) {
-        pbegin++;
-        zeroes++;
-    }
-    // Allocate enough space in big-endian base58 representation.
-    int size = (pend - pbegin) * 138 / 100 + 1; // log(256) / log(58), rounded up.
-    std::vector<unsigned char> b58(size);
-    // Process the bytes.
-    while (pbegin != pend) {
-        int carry = *pbegin;
-        int i = 0;
-        // Apply "b58 = b58 * 256 + ch".
-        for (std::vector<unsigned char>::reverse_iterator it = b58.rbegin(); (carry != 0 || i < length) && (it != b58.rend()); it++, i++) {
-            carry += 256 * (*it);
-            *it = carry % 58;
-            carry /= 58;
-        }
+    // add 4-byte hash check to the end
+    std::vector<unsigned char>& vch = buffers.bytes;
+    vch.assign(pbegin, pend);
+    uint256 hash;
+    CHash256().Write(pbegin, pend - pbegin).Finalize(hash.begin());
+    vch.insert(vch.end(), hash.begin(), hash.begin() + 4);
+    EncodeBase58Buffered(vch.data(), vch.data() + vch.size(), buffers.limbs, str);
+}
 
-        assert(carry == 0);
-        length = i;
-        pbegin++;
+bool DecodeBase58CheckBuffered(const char* psz, Base58Buffers& buffers, std::vector<unsigned char>& vchRet)
+{
+    if (!DecodeBase58Buffered(psz, buffers.limbs, vchRet) ||
+        (vchRet.size() < 4)) {
+        vchRet.clear();
+        return false;
     }
-    // Skip leading zeroes in base58 result.
-    std::vector<unsigned char>::iterator it = b58.begin() + (size - length);
-    while (it != b58.end() && *it == 0)
-        it++;
-    // Translate the result into a string.
+    // re-calculate the checksum, ensure it matches the included 4-byte checksum
+    uint256 hash = Hash(vchRet.begin(), vchRet.end() - 4);
+    if (memcmp(&hash, &vchRet[vchRet.size() - 4], 4) != 0) {
+        vchRet.clear();
+        return false;
+    }
+    vchRet.resize(vchRet.size() - 4);
+    return true;
+}
+
+} // namespace
+
+bool DecodeBase58(const char* psz, std::vector<unsigned char>& vch)
+{
+    std::vector<uint32_t> b256;
+    return DecodeBase58Buffered(psz, b256, vch);
+}
+
+std::string EncodeBase58(const unsigned char* pbegin, const unsigned char* pend)
+{
+    std::vector<uint32_t> b58;
     std::string str;
-    str.reserve(zeroes + (b58.end() - it));
-    str.assign(zeroes, '1');
-    while (it != b58.end())
-        str += pszBase58[*(it++)];
+    EncodeBase58Buffered(pbegin, pend, b58, str);
     return str;
 }
 
@@ -123,28 +235,26 @@ bool DecodeBase58(const std::string& str, std::vector<unsigned char>& vchRet)
 
 std::string EncodeBase58Check(const std::vector<unsigned char>& vchIn)
 {
-    // add 4-byte hash check to the end
-    std::vector<unsigned char> vch(vchIn);
-    uint256 hash = Hash(vch.begin(), vch.end());
-    vch.insert(vch.end(), (unsigned char*)&hash, (unsigned char*)&hash + 4);
-    return EncodeBase58(vch);
+    Base58Buffers buffers;
+    std::string str;
+    EncodeBase58CheckBuffered(vchIn.data(), vchIn.data() + vchIn.size(), buffers, str);
+    return str;
 }
 
-bool DecodeBase58Check(const char* psz, std::vector<unsigned char>& vchRet)
+std::vector<std::string> EncodeBase58CheckBatch(const std::vector<std::vector<unsigned char>>& vchIn)
 {
-    if (!DecodeBase58(psz, vchRet) ||
-        (vchRet.size() < 4)) {
-        vchRet.clear();
-        return false;
+    Base58Buffers buffers;
+    std::vector<std::string> ret(vchIn.size());
+    for (size_t i = 0; i < vchIn.size(); i++) {
+        EncodeBase58CheckBuffered(vchIn[i].data(), vchIn[i].data() + vchIn[i].size(), buffers, ret[i]);
     }
-    // re-calculate the checksum, ensure it matches the included 4-byte checksum
-    uint256 hash = Hash(vchRet.begin(), vchRet.end() - 4);
-    if (memcmp(&hash, &vchRet[vchRet.size() - 4], 4) != 0) {
-        vchRet.clear();
-        return false;
-    }
-    vchRet.resize(vchRet.size() - 4);
-    return true;
+    return ret;
+}
+
+bool DecodeBase58Check(const char* psz, std::vector<unsigned char>& vchRet)
+{
+    Base58Buffers buffers;
+    return DecodeBase58CheckBuffered(psz, buffers, vchRet);
 }
 
 bool DecodeBase58Check(const std::string& str, std::vector<unsigned char>& vchRet)
@@ -152,6 +262,17 @@ bool DecodeBase58Check(const std::string& str, std::vector<unsigned char>& vchRe
     return DecodeBase58Check(str.c_str(), vchRet);
 }
 
+std::vector<bool> DecodeBase58CheckBatch(const std::vector<std::string>& str, std::vector<std::vector<unsigned char>>& vchRet)
+{
+    Base58Buffers buffers;
+    std::vector<bool> ret(str.size());
+    vchRet.resize(str.size());
+    for (size_t i = 0; i < str.size(); i++) {
+        ret[i] = DecodeBase58CheckBuffered(str[i].c_str(), buffers, vchRet[i]);
+    }
+    return ret;
+}
+
 CBase58Data::CBase58Data()
 {
     vchVersion.clear();
@@ -215,11 +336,53 @@ int CBase58Data::CompareTo(const CBase58Data& b58) const
 
 namespace
 {
+/** The bech32 values of a witness destination: its version followed by its
+ *  program in 5-bit groups. Empty for other destinations. */
+class WitnessValues : public boost::static_visitor<std::vector<unsigned char>>
+{
+public:
+    std::vector<unsigned char> operator()(const CKeyID& id) const { return {}; }
+    std::vector<unsigned char> operator()(const CScriptID& id) const { return {}; }
+
+    std::vector<unsigned char> operator()(const WitnessV0KeyHash& id) const
+    {
+        std::vector<unsigned char> data = {0};
+        ConvertBits<8, 5, true>(data, id.begin(), id.end());
+        return data;
+    }
+
+    std::vector<unsigned char> operator()(const WitnessV0ScriptHash& id) const
+    {
+        std::vector<unsigned char> data = {0};
+        ConvertBits<8, 5, true>(data, id.begin(), id.end());
+        return data;
+    }
+
+    std::vector<unsigned char> operator()(const WitnessUnknown& id) const
+    {
+        if (id.version < 1 || id.version > 16 || id.length < 2 || id.length > 40) {
+            return {};
+        }
+        std::vector<unsigned char> data = {(unsigned char)id.version};
+        ConvertBits<8, 5, true>(data, id.program, id.program + id.length);
+        return data;
+    }
+
+    std::vector<unsigned char> operator()(const CNoDestination& no) const { return {}; }
+};
+
 class DestinationEncoder : public boost::static_visitor<std::string>
 {
 private:
     const CChainParams& m_params;
 
+    template <typename T>
+    std::string EncodeWitness(const T& id) const
+    {
+        std::vector<unsigned char> data = WitnessValues()(id);
+        return data.empty() ? std::string() : bech32::Encode(m_params.Bech32HRP(), data);
+    }
+
 public:
     DestinationEncoder(const CChainParams& params) : m_params(params) {}
 
@@ -237,56 +400,39 @@ public:
         return EncodeBase58Check(data);
     }
 
-    std::string operator()(const WitnessV0KeyHash& id) const
-    {
-        std::vector<unsigned char> data = {0};
-        ConvertBits<8, 5, true>(data, id.begin(), id.end());
-        return bech32::Encode(m_params.Bech32HRP(), data);
-    }
-
-    std::string operator()(const WitnessV0ScriptHash& id) const
-    {
-        std::vector<unsigned char> data = {0};
-        ConvertBits<8, 5, true>(data, id.begin(), id.end());
-        return bech32::Encode(m_params.Bech32HRP(), data);
-    }
-
-    std::string operator()(const WitnessUnknown& id) const
-    {
-        if (id.version < 1 || id.version > 16 || id.length < 2 || id.length > 40) {
-            return {};
-        }
-        std::vector<unsigned char> data = {(unsigned char)id.version};
-        ConvertBits<8, 5, true>(data, id.program, id.program + id.length);
-        return bech32::Encode(m_params.Bech32HRP(), data);
-    }
+    std::string operator()(const WitnessV0KeyHash& id) const { return EncodeWitness(id); }
+    std::string operator()(const WitnessV0ScriptHash& id) const { return EncodeWitness(id); }
+    std::string operator()(const WitnessUnknown& id) const { return EncodeWitness(id); }
 
     std::string operator()(const CNoDestination& no) const { return {}; }
 };
 
-CTxDestination DecodeDestination(const std::string& str, const CChainParams& params)
+/** The destination of a decoded base58check payload, if it starts with one of the address prefixes */
+CTxDestination DecodeBase58Destination(const std::vector<unsigned char>& data, const CChainParams& params)
 {
-    std::vector<unsigned char> data;
     uint160 hash;
-    if (DecodeBase58Check(str, data)) {
-        // base58-encoded Bitcoin addresses.
-        // Public-key-hash-addresses have version 0 (or 111 testnet).
-        // The data vector contains RIPEMD160(SHA256(pubkey)), where pubkey is the serialized public key.
-        const std::vector<unsigned char>& pubkey_prefix = params.Base58Prefix(CChainParams::PUBKEY_ADDRESS);
-        if (data.size() == hash.size() + pubkey_prefix.size() && std::equal(pubkey_prefix.begin(), pubkey_prefix.end(), data.begin())) {
-            std::copy(data.begin() + pubkey_prefix.size(), data.end(), hash.begin());
-            return CKeyID(hash);
-        }
-        // Script-hash-addresses have version 5 (or 196 testnet).
-        // The data vector contains RIPEMD160(SHA256(cscript)), where cscript is the serialized redemption script.
-        const std::vector<unsigned char>& script_prefix = params.Base58Prefix(CChainParams::SCRIPT_ADDRESS);
-        if (data.size() == hash.size() + script_prefix.size() && std::equal(script_prefix.begin(), script_prefix.end(), data.begin())) {
-            std::copy(data.begin() + script_prefix.size(), data.end(), hash.begin());
-            return CScriptID(hash);
-        }
+    // base58-encoded Bitcoin addresses.
+    // Public-key-hash-addresses have version 0 (or 111 testnet).
+    // The data vector contains RIPEMD160(SHA256(pubkey)), where pubkey is the serialized public key.
+    const std::vector<unsigned char>& pubkey_prefix = params.Base58Prefix(CChainParams::PUBKEY_ADDRESS);
+    if (data.size() == hash.size() + pubkey_prefix.size() && std::equal(pubkey_prefix.begin(), pubkey_prefix.end(), data.begin())) {
+        std::copy(data.begin() + pubkey_prefix.size(), data.end(), hash.begin());
+        return CKeyID(hash);
     }
-    data.clear();
-    auto bech = bech32::Decode(str);
+    // Script-hash-addresses have version 5 (or 196 testnet).
+    // The data vector contains RIPEMD160(SHA256(cscript)), where cscript is the serialized redemption script.
+    const std::vector<unsigned char>& script_prefix = params.Base58Prefix(CChainParams::SCRIPT_ADDRESS);
+    if (data.size() == hash.size() + script_prefix.size() && std::equal(script_prefix.begin(), script_prefix.end(), data.begin())) {
+        std::copy(data.begin() + script_prefix.size(), data.end(), hash.begin());
+        return CScriptID(hash);
+    }
+    return CNoDestination();
+}
+
+/** The destination of a decoded bech32 string */
+CTxDestination DecodeBech32Destination(const std::pair<std::string, std::vector<uint8_t>>& bech, const CChainParams& params)
+{
+    std::vector<unsigned char> data;
     if (bech.second.size() > 0 && bech.first == params.Bech32HRP()) {
         // Bech32 decoding
         int version = bech.second[0]; // The first 5 bit symbol is the witness version (0-16)
@@ -321,6 +467,18 @@ CTxDestination DecodeDestination(const std::string& str, const CChainParams& par
     }
     return CNoDestination();
 }
+
+CTxDestination DecodeDestination(const std::string& str, const CChainParams& params)
+{
+    std::vector<unsigned char> data;
+    if (DecodeBase58Check(str, data)) {
+        CTxDestination dest = DecodeBase58Destination(data, params);
+        if (IsValidDestination(dest)) {
+            return dest;
+        }
+    }
+    return DecodeBech32Destination(bech32::Decode(str), params);
+}
 } // namespace
 
 void CBitcoinSecret::SetKey(const CKey& vchSecret)
@@ -366,6 +524,72 @@ CTxDestination DecodeDestination(const std::string& str)
     return DecodeDestination(str, Params());
 }
 
+std::vector<std::string> EncodeDestinations(const std::vector<CTxDestination>& dests)
+{
+    const CChainParams& params = Params();
+    const std::vector<unsigned char>& pubkey_prefix = params.Base58Prefix(CChainParams::PUBKEY_ADDRESS);
+    const std::vector<unsigned char>& script_prefix = params.Base58Prefix(CChainParams::SCRIPT_ADDRESS);
+    std::vector<std::string> ret(dests.size());
+
+    // Encode the base58 addresses in place, and gather the witness ones so
+    // that they share the checksum state of the HRP.
+    Base58Buffers buffers;
+    std::vector<unsigned char> payload;
+    std::vector<std::vector<unsigned char>> witness;
+    std::vector<size_t> witness_pos;
+    for (size_t i = 0; i < dests.size(); i++) {
+        if (const CKeyID* id = boost::get<CKeyID>(&dests[i])) {
+            payload.assign(pubkey_prefix.begin(), pubkey_prefix.end());
+            payload.insert(payload.end(), id->begin(), id->end());
+        } else if (const CScriptID* id = boost::get<CScriptID>(&dests[i])) {
+            payload.assign(script_prefix.begin(), script_prefix.end());
+            payload.insert(payload.end(), id->begin(), id->end());
+        } else {
+            std::vector<unsigned char> values = boost::apply_visitor(WitnessValues(), dests[i]);
+            if (!values.empty()) {
+                witness.push_back(std::move(values));
+                witness_pos.push_back(i);
+            }
+            continue;
+        }
+        EncodeBase58CheckBuffered(payload.data(), payload.data() + payload.size(), buffers, ret[i]);
+    }
+
+    std::vector<std::string> bech = bech32::EncodeBatch(params.Bech32HRP(), witness);
+    for (size_t j = 0; j < bech.size(); j++) {
+        ret[witness_pos[j]] = std::move(bech[j]);
+    }
+    return ret;
+}
+
+std::vector<CTxDestination> DecodeDestinations(const std::vector<std::string>& strs)
+{
+    const CChainParams& params = Params();
+    std::vector<CTxDestination> ret(strs.size());
+
+    // Decode the base58 addresses in place, and gather the others so that
+    // they share the checksum state of the HRP.
+    Base58Buffers buffers;
+    std::vector<unsigned char> data;
+    std::vector<std::string> bech_strs;
+    std::vector<size_t> bech_pos;
+    for (size_t i = 0; i < strs.size(); i++) {
+        if (DecodeBase58CheckBuffered(strs[i].c_str(), buffers, data)) {
+            ret[i] = DecodeBase58Destination(data, params);
+        }
+        if (!IsValidDestination(ret[i])) {
+            bech_strs.push_back(strs[i]);
+            bech_pos.push_back(i);
+        }
+    }
+
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> bech = bech32::DecodeBatch(bech_strs);
+    for (size_t j = 0; j < bech.size(); j++) {
+        ret[bech_pos[j]] = DecodeBech32Destination(bech[j], params);
+    }
+    return ret;
+}
+
 bool IsValidDestinationString(const std::string& str, const CChainParams& params)
 {
     return IsValidDestination(DecodeDestination(str, params));
@@ -52,6 +52,12 @@ bool DecodeBase58(const std::string& str, std::vector<unsigned char>& vchRet);
  */
 std::string EncodeBase58Check(const std::vector<unsigned char>& vchIn);
 
+/**
+ * Encode many byte vectors as by EncodeBase58Check, reusing the buffers of the
+ * conversion across them
+ */
+std::vector<std::string> EncodeBase58CheckBatch(const std::vector<std::vector<unsigned char>>& vchIn);
+
 /**
  * Decode a base58-encoded string (psz) that includes a checksum into a byte
  * vector (vchRet), return true if decoding is successful
@@ -64,6 +70,13 @@ inline bool DecodeBase58Check(const char* psz, std::vector<unsigned char>& vchRe
  */
 inline bool DecodeBase58Check(const std::string& str, std::vector<unsigned char>& vchRet);
 
+/**
+ * Decode many base58-encoded strings as by DecodeBase58Check, reusing the
+ * buffers of the conversion across them. Returns whether each one was decoded;
+ * the byte vectors of the failed ones are empty.
+ */
+std::vector<bool> DecodeBase58CheckBatch(const std::vector<std::string>& str, std::vector<std::vector<unsigned char>>& vchRet);
+
 /**
  * Base class for all base58-encoded data
  */
@@ -144,6 +157,9 @@ typedef CBitcoinExtKeyBase<CExtPubKey, BIP32_EXTKEY_SIZE, CChainParams::EXT_PUBL
 
 std::string EncodeDestination(const CTxDestination& dest);
 CTxDestination DecodeDestination(const std::string& str);
+/** Encode or decode many destinations, with the same results as one at a time */
+std::vector<std::string> EncodeDestinations(const std::vector<CTxDestination>& dests);
+std::vector<CTxDestination> DecodeDestinations(const std::vector<std::string>& strs);
 bool IsValidDestinationString(const std::string& str);
 bool IsValidDestinationString(const std::string& str, const CChainParams& params);
 
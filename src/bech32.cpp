@@ -24,17 +24,11 @@ const int8_t CHARSET_REV[128] = {
      1,  0,  3, 16, 11, 28, 12, 14,  6,  4,  2, -1, -1, -1, -1, -1
 };
 
-/** Concatenate two byte arrays. */
-data Cat(data x, const data& y)
-{
-    x.insert(x.end(), y.begin(), y.end());
-    return x;
-}
-
 /** This function will compute what 6 5-bit values to XOR into the last 6 input values, in order to
  *  make the checksum 0. These 6 values are packed together in a single 30-bit integer. The higher
- *  bits correspond to earlier values. */
-uint32_t PolyMod(const data& v)
+ *  bits correspond to earlier values. A c other than 1 continues from the result of a previous call,
+ *  as if its input came before v. */
+uint32_t PolyMod(const data& v, uint32_t c = 1)
 {
     // The input is interpreted as a list of coefficients of a polynomial over F = GF(32), with an
     // implicit 1 in front. If the input is [v0,v1,v2,v3,v4], that polynomial is v(x) =
@@ -61,7 +55,6 @@ uint32_t PolyMod(const data& v)
     // the above example, `c` initially corresponds to 1 mod (x), and after processing 2 inputs of
     // v, it corresponds to x^2 + v0*x + v1 mod g(x). As 1 mod g(x) = 1, that is the starting value
     // for `c`.
-    uint32_t c = 1;
     for (auto v_i : v) {
         // We want to update `c` to correspond to a polynomial with one extra term. If the initial
         // value of `c` consists of the coefficients of c(x) = f(x) mod g(x), we modify it to
@@ -114,22 +107,27 @@ data ExpandHRP(const std::string& hrp)
     return ret;
 }
 
-/** Verify a checksum. */
-bool VerifyChecksum(const std::string& hrp, const data& values)
+/** The PolyMod of an expanded HRP, which the checksums of all strings with that HRP start from. */
+uint32_t HRPState(const std::string& hrp)
+{
+    return PolyMod(ExpandHRP(hrp));
+}
+
+/** Verify a checksum, given the HRPState of the HRP. */
+bool VerifyChecksum(uint32_t hrp_state, const data& values)
 {
     // PolyMod computes what value to xor into the final values to make the checksum 0. However,
     // if we required that the checksum was 0, it would be the case that appending a 0 to a valid
     // list of values would result in a new valid list. For that reason, Bech32 requires the
     // resulting checksum to be 1 instead.
-    return PolyMod(Cat(ExpandHRP(hrp), values)) == 1;
+    return PolyMod(values, hrp_state) == 1;
 }
 
-/** Create a checksum. */
-data CreateChecksum(const std::string& hrp, const data& values)
+/** Create a checksum, given the HRPState of the HRP. */
+data CreateChecksum(uint32_t hrp_state, const data& values)
 {
-    data enc = Cat(ExpandHRP(hrp), values);
-    enc.resize(enc.size() + 6); // Append 6 zeroes
-    uint32_t mod = PolyMod(enc) ^ 1; // Determine what to XOR into those 6 zeroes.
+    // Append 6 zeroes, and determine what to XOR into them.
+    uint32_t mod = PolyMod(data(6), PolyMod(values, hrp_state)) ^ 1;
     data ret(6);
     for (size_t i = 0; i < 6; ++i) {
         // Convert the 5-bit groups in mod to checksum values.
@@ -138,25 +136,23 @@ data CreateChecksum(const std::string& hrp, const data& values)
     return ret;
 }
 
-} // namespace
-
-namespace bech32
-{
-
-/** Encode a Bech32 string. */
-std::string Encode(const std::string& hrp, const data& values) {
-    data checksum = CreateChecksum(hrp, values);
-    data combined = Cat(values, checksum);
+/** Encode a Bech32 string, given the HRPState of hrp. */
+std::string EncodeWithState(const std::string& hrp, uint32_t hrp_state, const data& values) {
+    data checksum = CreateChecksum(hrp_state, values);
     std::string ret = hrp + '1';
-    ret.reserve(ret.size() + combined.size());
-    for (auto c : combined) {
+    ret.reserve(ret.size() + values.size() + checksum.size());
+    for (auto c : values) {
+        ret += CHARSET[c];
+    }
+    for (auto c : checksum) {
         ret += CHARSET[c];
     }
     return ret;
 }
 
-/** Decode a Bech32 string. */
-std::pair<std::string, data> Decode(const std::string& str) {
+/** Decode a Bech32 string. The HRPState of the last HRP seen is kept in
+ *  last_hrp and last_state, so that strings with the same HRP share it. */
+std::pair<std::string, data> DecodeWithState(const std::string& str, std::string& last_hrp, uint32_t& last_state) {
     bool lower = false, upper = false;
     for (size_t i = 0; i < str.size(); ++i) {
         unsigned char c = str[i];
@@ -182,10 +178,54 @@ std::pair<std::string, data> Decode(const std::string& str) {
     for (size_t i = 0; i < pos; ++i) {
         hrp += LowerCase(str[i]);
     }
-    if (!VerifyChecksum(hrp, values)) {
+    if (hrp != last_hrp) {
+        last_state = HRPState(hrp);
+        last_hrp = hrp;
+    }
+    if (!VerifyChecksum(last_state, values)) {
         return {};
     }
     return {hrp, data(values.begin(), values.end() - 6)};
 }
 
+} // namespace
+
+namespace bech32
+{
+
+/** Encode a Bech32 string. */
+std::string Encode(const std::string& hrp, const data& values) {
+    return EncodeWithState(hrp, HRPState(hrp), values);
+}
+
+/** Decode a Bech32 string. */
+std::pair<std::string, data> Decode(const std::string& str) {
+    std::string last_hrp;
+    uint32_t last_state = 0;
+    return DecodeWithState(str, last_hrp, last_state);
+}
+
+/** Encode many Bech32 strings with the same human-readable part. */
+std::vector<std::string> EncodeBatch(const std::string& hrp, const std::vector<data>& values) {
+    const uint32_t hrp_state = HRPState(hrp);
+    std::vector<std::string> ret;
+    ret.reserve(values.size());
+    for (const data& v : values) {
+        ret.push_back(EncodeWithState(hrp, hrp_state, v));
+    }
+    return ret;
+}
+
+/** Decode many Bech32 strings. */
+std::vector<std::pair<std::string, data>> DecodeBatch(const std::vector<std::string>& strs) {
+    std::string last_hrp;
+    uint32_t last_state = 0;
+    std::vector<std::pair<std::string, data>> ret;
+    ret.reserve(strs.size());
+    for (const std::string& str : strs) {
+        ret.push_back(DecodeWithState(str, last_hrp, last_state));
+    }
+    return ret;
+}
+
 } // namespace bech32
@@ -22,4 +22,10 @@ std::string Encode(const std::string& hrp, const std::vector<uint8_t>& values);
 /** Decode a Bech32 string. Returns (hrp, data). Empty hrp means failure. */
 std::pair<std::string, std::vector<uint8_t>> Decode(const std::string& str);
 
+/** Encode many Bech32 strings with the same human-readable part. */
+std::vector<std::string> EncodeBatch(const std::string& hrp, const std::vector<std::vector<uint8_t>>& values);
+
+/** Decode many Bech32 strings, as by Decode. */
+std::vector<std::pair<std::string, std::vector<uint8_t>>> DecodeBatch(const std::vector<std::string>& strs);
+
 } // namespace bech32
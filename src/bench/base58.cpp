@@ -6,6 +6,8 @@
 
 #include <validation.h>
 #include <base58.h>
+#include <chainparams.h>
+#include <random.h>
 
 #include <array>
 #include <vector>
@@ -54,6 +56,61 @@ static void Base58Decode(benchmark::State& state)
 }
 
 
+// A list of pay-to-pubkey-hash addresses, as rendered by RPC output or stored
+// by the account database
+static std::vector<CTxDestination> RandomAddresses(size_t n)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    FastRandomContext rand(true);
+    std::vector<CTxDestination> dests;
+    for (size_t i = 0; i < n; i++) {
+        std::vector<unsigned char> hash = rand.randbytes(20);
+        dests.push_back(CKeyID(uint160(hash)));
+    }
+    return dests;
+}
+
+static void AddressEncode(benchmark::State& state)
+{
+    const std::vector<CTxDestination> dests = RandomAddresses(1000);
+    while (state.KeepRunning()) {
+        for (const CTxDestination& dest : dests) {
+            EncodeDestination(dest);
+        }
+    }
+}
+
+static void AddressEncodeBatch(benchmark::State& state)
+{
+    const std::vector<CTxDestination> dests = RandomAddresses(1000);
+    while (state.KeepRunning()) {
+        EncodeDestinations(dests);
+    }
+}
+
+static void AddressDecode(benchmark::State& state)
+{
+    const std::vector<std::string> strs = EncodeDestinations(RandomAddresses(1000));
+    while (state.KeepRunning()) {
+        for (const std::string& str : strs) {
+            DecodeDestination(str);
+        }
+    }
+}
+
+static void AddressDecodeBatch(benchmark::State& state)
+{
+    const std::vector<std::string> strs = EncodeDestinations(RandomAddresses(1000));
+    while (state.KeepRunning()) {
+        DecodeDestinations(strs);
+    }
+}
+
+
 BENCHMARK(Base58Encode, 470 * 1000);
 BENCHMARK(Base58CheckEncode, 320 * 1000);
 BENCHMARK(Base58Decode, 800 * 1000);
+BENCHMARK(AddressEncode, 200);
+BENCHMARK(AddressEncodeBatch, 200);
+BENCHMARK(AddressDecode, 200);
+BENCHMARK(AddressDecodeBatch, 200);
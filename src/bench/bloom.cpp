@@ -0,0 +1,54 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <bloom.h>
+#include <primitives/transaction.h>
+#include <pubkey.h>
+#include <random.h>
+#include <script/standard.h>
+
+#include <vector>
+
+// A transaction spending 2 outpoints to 2 pay-to-pubkey-hash outputs
+static CTransaction RandomTransaction(FastRandomContext& rand)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(2);
+    for (CTxIn& txin : tx.vin) {
+        txin.prevout = COutPoint(rand.rand256(), rand.randrange(4));
+        std::vector<unsigned char> sig = rand.randbytes(72);
+        std::vector<unsigned char> pubkey = rand.randbytes(33);
+        txin.scriptSig << sig << pubkey;
+    }
+    tx.vout.resize(2);
+    for (CTxOut& txout : tx.vout) {
+        txout.nValue = 1000;
+        txout.scriptPubKey = GetScriptForDestination(CKeyID(uint160(rand.randbytes(20))));
+    }
+    return CTransaction(tx);
+}
+
+// The per transaction check of a peer that loaded a filter of 1000 of its own
+// keys, run against transactions that do not match it
+static void IsRelevantAndUpdate(benchmark::State& state)
+{
+    FastRandomContext rand(true);
+    CBloomFilter filter(1000, 0.0001, 0, BLOOM_UPDATE_ALL);
+    for (int i = 0; i < 1000; i++) {
+        filter.insert(rand.randbytes(20));
+    }
+    std::vector<CTransaction> txs;
+    for (int i = 0; i < 100; i++) {
+        txs.push_back(RandomTransaction(rand));
+    }
+    while (state.KeepRunning()) {
+        for (const CTransaction& tx : txs) {
+            filter.IsRelevantAndUpdate(tx);
+        }
+    }
+}
+
+BENCHMARK(IsRelevantAndUpdate, 2000);
@@ -52,6 +52,15 @@ static void SHA256_32b(benchmark::State& state)
     }
 }
 
+// A level of a merkle tree over 1024 leaves, as hashed by SHA256D64
+static void SHA256D64_1024(benchmark::State& state)
+{
+    std::vector<uint8_t> in(64 * 1024, 0);
+    while (state.KeepRunning()) {
+        SHA256D64(in.data(), in.data(), 1024);
+    }
+}
+
 static void SHA512(benchmark::State& state)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -69,6 +78,21 @@ static void SipHash_32b(benchmark::State& state)
     }
 }
 
+static void SipHash_32b_Batch1024(benchmark::State& state)
+{
+    std::vector<uint256> vals(1024);
+    std::vector<const uint256*> ptrs(vals.size());
+    for (size_t i = 0; i < vals.size(); i++) {
+        *((uint64_t*)vals[i].begin()) = i;
+        ptrs[i] = &vals[i];
+    }
+    std::vector<uint64_t> out(vals.size());
+    uint64_t k1 = 0;
+    while (state.KeepRunning()) {
+        SipHashUint256Batch(0, ++k1, ptrs.data(), out.data(), out.size());
+    }
+}
+
 static void FastRandom_32bit(benchmark::State& state)
 {
     FastRandomContext rng(true);
@@ -93,6 +117,8 @@ BENCHMARK(SHA256, 340);
 BENCHMARK(SHA512, 330);
 
 BENCHMARK(SHA256_32b, 4700 * 1000);
+BENCHMARK(SHA256D64_1024, 7400);
 BENCHMARK(SipHash_32b, 40 * 1000 * 1000);
+BENCHMARK(SipHash_32b_Batch1024, 40 * 1000);
 BENCHMARK(FastRandom_32bit, 110 * 1000 * 1000);
 BENCHMARK(FastRandom_1bit, 440 * 1000 * 1000);
@@ -0,0 +1,374 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <accounts/db.h>
+#include <base58.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <consensus/tx_verify.h>
+#include <consensus/validation.h>
+#include <fs.h>
+#include <policy/policy.h>
+#include <random.h>
+#include <script/standard.h>
+#include <txmempool.h>
+#include <util.h>
+#include <utilmoneystr.h>
+#include <validation.h>
+
+#include <fstream>
+#include <vector>
+
+// The account database reports every operation on stdout; silence it while
+// benchmarking so that the numbers reflect the database work only.
+class SilenceStdout
+{
+public:
+    SilenceStdout() : m_buf(std::cout.rdbuf(nullptr)) {}
+    ~SilenceStdout()
+    {
+        std::cout.rdbuf(m_buf);
+    }
+
+private:
+    std::streambuf* m_buf;
+};
+
+// Point -datadir to a fresh directory, since UpdateAccountTree always opens
+// GetDataDir()/accounts.dat. Removed again on destruction.
+class TempDataDir
+{
+public:
+    TempDataDir()
+    {
+        SelectParams(CBaseChainParams::REGTEST);
+        m_path = fs::temp_directory_path() / strprintf("bench_bitcoin_managed_%lu_%i", (unsigned long)GetTime(), (int)GetRand(100000));
+        fs::create_directories(m_path);
+        gArgs.ForceSetArg("-datadir", m_path.string());
+        ClearDatadirCache();
+    }
+    ~TempDataDir()
+    {
+        fs::remove_all(m_path);
+        gArgs.ForceSetArg("-datadir", "");
+        ClearDatadirCache();
+    }
+    fs::path AccountsFile() const { return GetDataDir() / "accounts.dat"; }
+
+private:
+    fs::path m_path;
+};
+
+static CScript RandomScript(FastRandomContext& rand)
+{
+    return GetScriptForDestination(CKeyID(uint160(rand.randbytes(20))));
+}
+
+static CRoleChangeMode Roles(const std::string& strRoles)
+{
+    CRoleChangeMode roles;
+    bool fParsed = ParseRoles(strRoles, roles);
+    assert(fParsed);
+    return roles;
+}
+
+static COutPoint AddRandomCoin(CCoinsViewCache& coins, FastRandomContext& rand, const CTxOut& out)
+{
+    COutPoint outpoint(rand.rand256(), 0);
+    coins.AddCoin(outpoint, Coin(out, 1, false), false);
+    return outpoint;
+}
+
+// Build a valid managed transaction of the given version along with the
+// coins it spends. The issuing account gets the single role required for
+// the operation.
+static CMutableTransaction SetupManagedTx(int32_t nVersion, CCoinsViewCache& coins, FastRandomContext& rand)
+{
+    const CScript issuer = RandomScript(rand);
+    const CScript other = RandomScript(rand);
+
+    std::string strRoles = "M..R..";
+    if (nVersion == CTransaction::VERSION_COIN_TRANSFER)
+        strRoles = "...R..";
+    else if (nVersion == CTransaction::VERSION_COIN_CREATION || nVersion == CTransaction::VERSION_COIN_CREATION_FEE)
+        strRoles = ".C.R..";
+    else if (nVersion == CTransaction::VERSION_COIN_FORFEITURE)
+        strRoles = "..LR..";
+    const CRoleChangeMode roles = Roles(strRoles);
+
+    CMutableTransaction tx;
+    tx.nVersion = nVersion;
+    tx.vin.emplace_back(AddRandomCoin(coins, rand, CTxOut(roles, issuer)));
+    tx.vout.emplace_back(roles, issuer);
+
+    // Fee paying input and change, the forfeited coin for a forfeiture
+    const bool fFee = CTransaction(tx).GetExtraOutputOffset() > 1;
+    if (fFee)
+        tx.vin.emplace_back(AddRandomCoin(coins, rand, CTxOut(10 * COIN, issuer)));
+    else if (nVersion == CTransaction::VERSION_COIN_FORFEITURE)
+        tx.vin.emplace_back(AddRandomCoin(coins, rand, CTxOut(10 * COIN, other)));
+    if (fFee)
+        tx.vout.emplace_back(9 * COIN, issuer);
+
+    switch (nVersion) {
+        case CTransaction::VERSION_COIN_TRANSFER:
+        case CTransaction::VERSION_COIN_CREATION:
+        case CTransaction::VERSION_COIN_CREATION_FEE:
+            tx.vout.emplace_back(COIN / 2, other);
+            break;
+        case CTransaction::VERSION_COIN_FORFEITURE:
+            tx.vout.emplace_back(9 * COIN, issuer);
+            break;
+        case CTransaction::VERSION_ROLE_CREATION:
+        case CTransaction::VERSION_ROLE_CREATION_FEE:
+            tx.vout.emplace_back(Roles("...R.."), other);
+            break;
+        case CTransaction::VERSION_ROLE_CHANGE:
+        case CTransaction::VERSION_ROLE_CHANGE_FEE:
+            tx.vin.emplace_back(AddRandomCoin(coins, rand, CTxOut(Roles("...R.."), other)));
+            tx.vout.emplace_back(Roles("...R.D"), other);
+            break;
+        case CTransaction::VERSION_POLICY_CHANGE:
+        case CTransaction::VERSION_POLICY_CHANGE_FEE:
+            tx.vout.emplace_back(false, 1, 1, other);
+            break;
+    }
+    return tx;
+}
+
+static void CheckManagedTxInputs(benchmark::State& state, int32_t nVersion)
+{
+    FastRandomContext rand(true);
+    CCoinsView coinsDummy;
+    CCoinsViewCache coins(&coinsDummy);
+    const CTransaction tx(SetupManagedTx(nVersion, coins, rand));
+
+    while (state.KeepRunning()) {
+        CValidationState validationState;
+        CAmount txfee = 0;
+        bool success = Consensus::CheckTxInputs(tx, validationState, coins, 2, txfee);
+        assert(success);
+    }
+}
+
+static void CheckTxInputsCoinTransfer(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_COIN_TRANSFER); }
+static void CheckTxInputsCoinForfeiture(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_COIN_FORFEITURE); }
+static void CheckTxInputsCoinCreation(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_COIN_CREATION); }
+static void CheckTxInputsCoinCreationFee(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_COIN_CREATION_FEE); }
+static void CheckTxInputsRoleCreation(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_ROLE_CREATION); }
+static void CheckTxInputsRoleCreationFee(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_ROLE_CREATION_FEE); }
+static void CheckTxInputsRoleChange(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_ROLE_CHANGE); }
+static void CheckTxInputsRoleChangeFee(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_ROLE_CHANGE_FEE); }
+static void CheckTxInputsPolicyChange(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_POLICY_CHANGE); }
+static void CheckTxInputsPolicyChangeFee(benchmark::State& state) { CheckManagedTxInputs(state, CTransaction::VERSION_POLICY_CHANGE_FEE); }
+
+// The pre-filter run on received transactions, which does not look up any coin
+static void WellFormedManagedTx(benchmark::State& state, int32_t nVersion)
+{
+    FastRandomContext rand(true);
+    CCoinsView coinsDummy;
+    CCoinsViewCache coins(&coinsDummy);
+    const CTransaction tx(SetupManagedTx(nVersion, coins, rand));
+
+    while (state.KeepRunning()) {
+        std::string reason;
+        bool success = IsWellFormedManagedTx(tx, reason);
+        assert(success);
+    }
+}
+
+static void IsWellFormedCoinTransfer(benchmark::State& state) { WellFormedManagedTx(state, CTransaction::VERSION_COIN_TRANSFER); }
+static void IsWellFormedRoleChange(benchmark::State& state) { WellFormedManagedTx(state, CTransaction::VERSION_ROLE_CHANGE); }
+
+// Role creation transaction granting roles to 100 new accounts
+static void IsAuthorizedRoleCreation(benchmark::State& state)
+{
+    FastRandomContext rand(true);
+    CCoinsView coinsDummy;
+    CCoinsViewCache coins(&coinsDummy);
+    CMutableTransaction mtx = SetupManagedTx(CTransaction::VERSION_ROLE_CREATION, coins, rand);
+    for (int i = 1; i < 100; i++)
+        mtx.vout.emplace_back(Roles("...R.."), RandomScript(rand));
+    const CTransaction tx(mtx);
+    const CRoleChangeMode inRole = coins.AccessCoin(tx.vin[0].prevout).out.nRole;
+
+    while (state.KeepRunning()) {
+        bool success = isAuthorized(tx, inRole, coins);
+        assert(success);
+    }
+}
+
+// Fill the cache with nCoins coins, one in four being a role change coin,
+// and look up an address without an account, which scans the whole cache.
+static void CoinsCheckIfAccountExists(benchmark::State& state, int nCoins)
+{
+    FastRandomContext rand(true);
+    CCoinsView coinsDummy;
+    CCoinsViewCache coins(&coinsDummy);
+    for (int i = 0; i < nCoins; i++) {
+        if (i % 4 == 0)
+            AddRandomCoin(coins, rand, CTxOut(Roles("...R.."), RandomScript(rand)));
+        else
+            AddRandomCoin(coins, rand, CTxOut(COIN, RandomScript(rand)));
+    }
+    const Coin coin(CTxOut(Roles("...R.."), RandomScript(rand)), 1, false);
+
+    while (state.KeepRunning()) {
+        bool exists = coins.CheckIfAccountExists(coin);
+        assert(!exists);
+    }
+}
+
+static void CheckIfAccountExists1k(benchmark::State& state) { CoinsCheckIfAccountExists(state, 1000); }
+static void CheckIfAccountExists10k(benchmark::State& state) { CoinsCheckIfAccountExists(state, 10000); }
+static void CheckIfAccountExists100k(benchmark::State& state) { CoinsCheckIfAccountExists(state, 100000); }
+
+// Fill the mempool with nTxs coin transfers from distinct accounts and look
+// up the role of an address that has no transaction in the pool.
+static void MempoolGetRoleByDest(benchmark::State& state, int nTxs)
+{
+    FastRandomContext rand(true);
+    CTxMemPool pool;
+    LockPoints lp;
+    for (int i = 0; i < nTxs; i++) {
+        const CScript issuer = RandomScript(rand);
+        CMutableTransaction tx;
+        tx.nVersion = CTransaction::VERSION_COIN_TRANSFER;
+        tx.vin.emplace_back(COutPoint(rand.rand256(), 0));
+        tx.vin.emplace_back(COutPoint(rand.rand256(), 0));
+        tx.vout.emplace_back(Roles("...R.."), issuer);
+        tx.vout.emplace_back(COIN, issuer);
+        tx.vout.emplace_back(COIN, RandomScript(rand));
+        pool.addUnchecked(tx.GetHash(), CTxMemPoolEntry(MakeTransactionRef(tx), 1000, 0, 1, false, 4, lp));
+    }
+    const CTxDestination dest = CKeyID(uint160(rand.randbytes(20)));
+
+    while (state.KeepRunning()) {
+        Coin coin = pool.GetRoleByDest(dest);
+        assert(coin.IsSpent());
+    }
+}
+
+static void MempoolGetRoleByDest100(benchmark::State& state) { MempoolGetRoleByDest(state, 100); }
+static void MempoolGetRoleByDest1k(benchmark::State& state) { MempoolGetRoleByDest(state, 1000); }
+static void MempoolGetRoleByDest10k(benchmark::State& state) { MempoolGetRoleByDest(state, 10000); }
+
+// Connect a block of nTxs role creation transactions, each creating one
+// account under the same manager, to an empty account tree.
+static void BlockUpdateAccountTree(benchmark::State& state, int nTxs)
+{
+    FastRandomContext rand(true);
+    TempDataDir datadir;
+    SilenceStdout silence;
+    const CScript manager = RandomScript(rand);
+
+    CBlock block;
+    for (int i = 0; i < nTxs; i++) {
+        CMutableTransaction tx;
+        tx.nVersion = CTransaction::VERSION_ROLE_CREATION;
+        tx.vin.emplace_back(COutPoint(rand.rand256(), 0));
+        tx.vout.emplace_back(Roles("M..R.."), manager);
+        tx.vout.emplace_back(Roles("...R.."), RandomScript(rand));
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    while (state.KeepRunning()) {
+        fs::remove(datadir.AccountsFile());
+        UpdateAccountTree(Params(), block);
+    }
+}
+
+static void UpdateAccountTree10(benchmark::State& state) { BlockUpdateAccountTree(state, 10); }
+static void UpdateAccountTree100(benchmark::State& state) { BlockUpdateAccountTree(state, 100); }
+
+// Write an accounts.dat holding nAccounts accounts, arranged as a tree
+// with a fan-out of 16 below a single root.
+static void WriteAccountsFile(const fs::path& path, int nAccounts)
+{
+    FastRandomContext rand(true);
+    std::vector<CTxDestination> addresses;
+    std::vector<CManagedAccountData> accounts;
+    addresses.reserve(nAccounts);
+    accounts.reserve(nAccounts);
+    for (int i = 0; i < nAccounts; i++) {
+        addresses.emplace_back(CKeyID(uint160(rand.randbytes(20))));
+        if (i == 0) {
+            accounts.emplace_back(Roles("M..R.."));
+        } else {
+            accounts.emplace_back(Roles("...R.."), addresses[(i - 1) / 16]);
+            accounts[(i - 1) / 16].AddChild(addresses[i]);
+        }
+    }
+
+    std::ofstream file(path.string().c_str());
+    for (int i = 0; i < nAccounts; i++) {
+        file << EncodeDestination(addresses[i]) << std::endl;
+        file << accounts[i] << std::endl;
+    }
+}
+
+static void AccountDBLoad(benchmark::State& state, int nAccounts)
+{
+    TempDataDir datadir;
+    WriteAccountsFile(datadir.AccountsFile(), nAccounts);
+    SilenceStdout silence;
+
+    while (state.KeepRunning()) {
+        CManagedAccountDB accountDB(datadir.AccountsFile().string());
+        assert(accountDB.size() == nAccounts);
+    }
+}
+
+// Every update of the account tree rewrites the whole file
+static void AccountDBSave(benchmark::State& state, int nAccounts)
+{
+    TempDataDir datadir;
+    WriteAccountsFile(datadir.AccountsFile(), nAccounts);
+    SilenceStdout silence;
+    CManagedAccountDB accountDB(datadir.AccountsFile().string());
+    const CTxDestination root = accountDB.GetRootAddress();
+    CManagedAccountData rootData;
+    accountDB.GetAccountByAddress(root, rootData);
+
+    while (state.KeepRunning()) {
+        bool success = accountDB.UpdateAccount(root, rootData);
+        assert(success);
+    }
+}
+
+static void AccountDBLoad10k(benchmark::State& state) { AccountDBLoad(state, 10000); }
+static void AccountDBLoad100k(benchmark::State& state) { AccountDBLoad(state, 100000); }
+static void AccountDBLoad1M(benchmark::State& state) { AccountDBLoad(state, 1000000); }
+static void AccountDBSave10k(benchmark::State& state) { AccountDBSave(state, 10000); }
+static void AccountDBSave100k(benchmark::State& state) { AccountDBSave(state, 100000); }
+static void AccountDBSave1M(benchmark::State& state) { AccountDBSave(state, 1000000); }
+
+BENCHMARK(CheckTxInputsCoinTransfer, 1000 * 1000);
+BENCHMARK(CheckTxInputsCoinForfeiture, 1000 * 1000);
+BENCHMARK(CheckTxInputsCoinCreation, 1000 * 1000);
+BENCHMARK(CheckTxInputsCoinCreationFee, 1000 * 1000);
+BENCHMARK(CheckTxInputsRoleCreation, 1000 * 1000);
+BENCHMARK(CheckTxInputsRoleCreationFee, 1000 * 1000);
+BENCHMARK(CheckTxInputsRoleChange, 1000 * 1000);
+BENCHMARK(CheckTxInputsRoleChangeFee, 1000 * 1000);
+BENCHMARK(CheckTxInputsPolicyChange, 1000 * 1000);
+BENCHMARK(CheckTxInputsPolicyChangeFee, 1000 * 1000);
+BENCHMARK(IsWellFormedCoinTransfer, 5000 * 1000);
+BENCHMARK(IsWellFormedRoleChange, 5000 * 1000);
+BENCHMARK(IsAuthorizedRoleCreation, 2000 * 1000);
+BENCHMARK(CheckIfAccountExists1k, 15 * 1000);
+BENCHMARK(CheckIfAccountExists10k, 1200);
+BENCHMARK(CheckIfAccountExists100k, 70);
+BENCHMARK(MempoolGetRoleByDest100, 20 * 1000);
+BENCHMARK(MempoolGetRoleByDest1k, 2000);
+BENCHMARK(MempoolGetRoleByDest10k, 130);
+BENCHMARK(UpdateAccountTree10, 200);
+BENCHMARK(UpdateAccountTree100, 4);
+BENCHMARK(AccountDBLoad10k, 5);
+BENCHMARK(AccountDBLoad100k, 1);
+BENCHMARK(AccountDBLoad1M, 1);
+BENCHMARK(AccountDBSave10k, 5);
+BENCHMARK(AccountDBSave100k, 1);
+BENCHMARK(AccountDBSave1M, 1);
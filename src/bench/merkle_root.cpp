@@ -0,0 +1,53 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <consensus/merkle.h>
+#include <random.h>
+#include <uint256.h>
+
+#include <cassert>
+
+static std::vector<uint256> RandomLeaves(size_t nLeaves)
+{
+    FastRandomContext rand(true);
+    std::vector<uint256> leaves(nLeaves);
+    for (uint256& leaf : leaves) {
+        leaf = rand.rand256();
+    }
+    return leaves;
+}
+
+// The root as computed for every block, hashing the tree level by level
+static void MerkleRoot(benchmark::State& state, size_t nLeaves)
+{
+    const std::vector<uint256> leaves = RandomLeaves(nLeaves);
+    bool mutated;
+    while (state.KeepRunning()) {
+        uint256 root = ComputeMerkleRoot(leaves, &mutated);
+        assert(!mutated && !root.IsNull());
+    }
+}
+
+// The branch computation hashes every inner node of the tree one pair at a
+// time, as the root computation used to
+static void MerkleRootPerPair(benchmark::State& state, size_t nLeaves)
+{
+    const std::vector<uint256> leaves = RandomLeaves(nLeaves);
+    while (state.KeepRunning()) {
+        std::vector<uint256> branch = ComputeMerkleBranch(leaves, 0);
+        assert(!branch.empty());
+    }
+}
+
+static void MerkleRoot_1k(benchmark::State& state) { MerkleRoot(state, 1000); }
+static void MerkleRoot_10k(benchmark::State& state) { MerkleRoot(state, 10000); }
+static void MerkleRootPerPair_1k(benchmark::State& state) { MerkleRootPerPair(state, 1000); }
+static void MerkleRootPerPair_10k(benchmark::State& state) { MerkleRootPerPair(state, 10000); }
+
+BENCHMARK(MerkleRoot_1k, 7300);
+BENCHMARK(MerkleRoot_10k, 750);
+BENCHMARK(MerkleRootPerPair_1k, 3800);
+BENCHMARK(MerkleRootPerPair_10k, 370);
@@ -0,0 +1,65 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <policy/fees.h>
+#include <policy/policy.h>
+#include <txmempool.h>
+
+#include <vector>
+
+// Feed the estimator blocks of 2000 transactions, out of which
+// nManagementPercent are fee exempt role changes, each transaction
+// confirming in the block after it entered the mempool.
+static void ProcessBlocks(benchmark::State& state, int nManagementPercent)
+{
+    static const int NUM_TXS = 2000;
+
+    std::vector<CTxMemPoolEntry> entries;
+    for (int i = 0; i < NUM_TXS; i++) {
+        bool fManagement = i % 100 < nManagementPercent;
+        CMutableTransaction tx;
+        tx.nVersion = fManagement ? CTransaction::VERSION_ROLE_CHANGE : CTransaction::VERSION_COIN_TRANSFER;
+        tx.vin.resize(1);
+        tx.vin[0].scriptSig = CScript() << OP_1;
+        tx.vin[0].prevout.n = i;
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+        tx.vout[0].nTxType = CTxOut::COIN_TRANSFER;
+        tx.vout[0].nValue = 10 * COIN;
+        LockPoints lp;
+        entries.emplace_back(MakeTransactionRef(tx), fManagement ? 0 : 1000 + 10 * (i % 100),
+                             0, 0, false, 4, lp);
+    }
+
+    CBlockPolicyEstimator feeEst;
+    std::vector<const CTxMemPoolEntry*> block;
+    for (const CTxMemPoolEntry& entry : entries) {
+        block.push_back(&entry);
+    }
+
+    unsigned int nHeight = 0;
+    while (state.KeepRunning()) {
+        // The entries carry the height they entered the mempool at, which
+        // has to be the best height the estimator has seen
+        for (CTxMemPoolEntry& entry : entries) {
+            entry = CTxMemPoolEntry(entry.GetSharedTx(), entry.GetFee(), 0, nHeight, false, 4, LockPoints());
+            feeEst.processTransaction(entry, true);
+        }
+        feeEst.processBlock(++nHeight, block);
+    }
+}
+
+static void PolicyEstimatorTransferBlock(benchmark::State& state)
+{
+    ProcessBlocks(state, 0);
+}
+
+static void PolicyEstimatorManagementBlock(benchmark::State& state)
+{
+    ProcessBlocks(state, 90);
+}
+
+BENCHMARK(PolicyEstimatorTransferBlock, 50);
+BENCHMARK(PolicyEstimatorManagementBlock, 50);
@@ -6,6 +6,7 @@
 
 #include <bench/bench.h>
 #include <bloom.h>
+#include <random.h>
 
 static void RollingBloom(benchmark::State& state)
 {
@@ -29,4 +30,19 @@ static void RollingBloom(benchmark::State& state)
     }
 }
 
+// Lookups of uint256 hashes that were not inserted, as for every inv a peer sends
+static void RollingBloomContains(benchmark::State& state)
+{
+    CRollingBloomFilter filter(50000, 0.000001);
+    FastRandomContext rand(true);
+    for (int i = 0; i < 50000; i++) {
+        filter.insert(rand.rand256());
+    }
+    uint64_t match = 0;
+    while (state.KeepRunning()) {
+        match += filter.contains(rand.rand256());
+    }
+}
+
 BENCHMARK(RollingBloom, 1500 * 1000);
+BENCHMARK(RollingBloomContains, 1500 * 1000);
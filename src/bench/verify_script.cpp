@@ -3,13 +3,17 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <checkqueue.h>
 #include <key.h>
 #if defined(HAVE_CONSENSUS_LIB)
 #include <script/bitcoinconsensus.h>
 #endif
 #include <script/script.h>
 #include <script/sign.h>
+#include <script/sigcache.h>
+#include <script/standard.h>
 #include <streams.h>
+#include <validation.h>
 
 #include <array>
 
@@ -107,4 +111,74 @@ static void VerifyScriptBench(benchmark::State& state)
     }
 }
 
+// A transaction whose inputs are all P2PKH outputs of the same key, like the
+// transactions of a managed credential, checked the way block validation
+// checks them: one by one, as a batch of the check queue, or without the
+// caches of CachingTransactionSignatureChecker, which parses the key of every
+// input.
+enum class ScriptCheckMode { SINGLE, BATCH, UNCACHED };
+
+static void RunScriptChecks(benchmark::State& state, ScriptCheckMode mode)
+{
+    static const int nInputs = 128;
+    const int flags = SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_DERSIG | SCRIPT_VERIFY_LOW_S;
+
+    static bool fSigCache = false;
+    if (!fSigCache) {
+        InitSignatureCache();
+        fSigCache = true;
+    }
+
+    CKey key;
+    key.MakeNewKey(true);
+    CPubKey pubkey = key.GetPubKey();
+    CScript scriptPubKey = GetScriptForDestination(pubkey.GetID());
+
+    CMutableTransaction txCredit = BuildCreditingTransaction(scriptPubKey);
+    txCredit.vout.resize(nInputs, txCredit.vout[0]);
+    CMutableTransaction txSpend = BuildSpendingTransaction(CScript(), txCredit);
+    txSpend.vin.resize(nInputs, txSpend.vin[0]);
+    for (int i = 0; i < nInputs; i++) {
+        txSpend.vin[i].prevout.n = i;
+    }
+    for (int i = 0; i < nInputs; i++) {
+        std::vector<unsigned char> vchSig;
+        key.Sign(SignatureHash(scriptPubKey, txSpend, i, SIGHASH_ALL, txCredit.vout[i].nValue, SIGVERSION_BASE), vchSig);
+        vchSig.push_back(static_cast<unsigned char>(SIGHASH_ALL));
+        txSpend.vin[i].scriptSig = CScript() << vchSig << ToByteVector(pubkey);
+    }
+    const CTransaction tx(txSpend);
+    PrecomputedTransactionData txdata(tx);
+
+    while (state.KeepRunning()) {
+        bool success = true;
+        if (mode == ScriptCheckMode::UNCACHED) {
+            for (int i = 0; i < nInputs; i++) {
+                success &= VerifyScript(tx.vin[i].scriptSig, scriptPubKey, &tx.vin[i].scriptWitness, flags,
+                                        TransactionSignatureChecker(&tx, i, txCredit.vout[i].GetSigHashAmount(), txdata), nullptr);
+            }
+        } else {
+            std::vector<CScriptCheck> vChecks;
+            for (int i = 0; i < nInputs; i++) {
+                vChecks.emplace_back(txCredit.vout[i], tx, i, flags, false, &txdata);
+            }
+            if (mode == ScriptCheckMode::BATCH) {
+                success = RunCheckBatch(vChecks);
+            } else {
+                for (CScriptCheck& check : vChecks) {
+                    success &= check();
+                }
+            }
+        }
+        assert(success);
+    }
+}
+
+static void VerifyScriptChecks(benchmark::State& state) { RunScriptChecks(state, ScriptCheckMode::SINGLE); }
+static void VerifyScriptChecksBatch(benchmark::State& state) { RunScriptChecks(state, ScriptCheckMode::BATCH); }
+static void VerifyScriptChecksUncached(benchmark::State& state) { RunScriptChecks(state, ScriptCheckMode::UNCACHED); }
+
 BENCHMARK(VerifyScriptBench, 6300);
+BENCHMARK(VerifyScriptChecks, 70);
+BENCHMARK(VerifyScriptChecksBatch, 70);
+BENCHMARK(VerifyScriptChecksUncached, 70);
@@ -0,0 +1,177 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
+#include <base58.h>
+#include <chainparams.h>
+#include <clientversion.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <util.h>
+#include <utilstrencodings.h>
+#include <validation.h>
+#include <workload.h>
+
+#include <memory>
+#include <stdio.h>
+
+static const int64_t DEFAULT_CHAINGEN_SEED = 0;
+static const int64_t DEFAULT_CHAINGEN_BLOCKS = 1000;
+static const int64_t DEFAULT_CHAINGEN_TXS = 100;
+static const int64_t DEFAULT_CHAINGEN_DEPTH = 8;
+static const int64_t DEFAULT_CHAINGEN_SPACING = 60;
+static const char* DEFAULT_CHAINGEN_PROFILE = "mixed";
+static const int CONTINUE_EXECUTION=-1;
+
+//
+// This function returns either one of EXIT_ codes when it's expected to stop the process or
+// CONTINUE_EXECUTION when it's expected to continue further.
+//
+static int AppInitChainGen(int argc, char* argv[])
+{
+    gArgs.ParseParameters(argc, argv);
+
+    if (gArgs.IsArgSet("-?") || gArgs.IsArgSet("-h") || gArgs.IsArgSet("-help")) {
+        std::string strUsage = strprintf(_("%s bitcoin-chaingen utility version"), _(PACKAGE_NAME)) + " " + FormatFullVersion() + "\n\n" +
+            _("Usage:") + "\n" +
+              "  bitcoin-chaingen [options]  " + _("Write a synthetic regtest chain of managed transactions to blk*.dat files") + "\n" +
+              "\n";
+        strUsage += HelpMessageGroup(_("Options:"));
+        strUsage += HelpMessageOpt("-?", _("This help message"));
+        strUsage += HelpMessageOpt("-blocks=<n>", strprintf(_("Number of blocks to generate on top of the genesis block (default: %u)"), DEFAULT_CHAINGEN_BLOCKS));
+        strUsage += HelpMessageOpt("-depth=<n>", strprintf(_("Maximum depth of the account hierarchy (default: %u)"), DEFAULT_CHAINGEN_DEPTH));
+        strUsage += HelpMessageOpt("-out=<dir>", _("Directory the block files are written to (default: current directory)"));
+        strUsage += HelpMessageOpt("-profile=<name>", strprintf(_("Workload profile, one of %s (default: %s)"), WorkloadProfileNames(), DEFAULT_CHAINGEN_PROFILE));
+        strUsage += HelpMessageOpt("-seed=<n>", strprintf(_("Seed for the keys and the workload; the same seed and options always produce the same chain (default: %u)"), DEFAULT_CHAINGEN_SEED));
+        strUsage += HelpMessageOpt("-spacing=<n>", strprintf(_("Seconds between block timestamps (default: %u)"), DEFAULT_CHAINGEN_SPACING));
+        strUsage += HelpMessageOpt("-txs=<n>", strprintf(_("Number of transactions per block, besides the coinbase (default: %u)"), DEFAULT_CHAINGEN_TXS));
+        fprintf(stdout, "%s", strUsage.c_str());
+        return EXIT_SUCCESS;
+    }
+
+    if (gArgs.GetArg("-blocks", DEFAULT_CHAINGEN_BLOCKS) < 0 || gArgs.GetArg("-txs", DEFAULT_CHAINGEN_TXS) < 0 ||
+        gArgs.GetArg("-depth", DEFAULT_CHAINGEN_DEPTH) < 1 || gArgs.GetArg("-spacing", DEFAULT_CHAINGEN_SPACING) < 1) {
+        fprintf(stderr, "Error: -blocks and -txs must not be negative, -depth and -spacing must be positive\n");
+        return EXIT_FAILURE;
+    }
+    if (!FindWorkloadProfile(gArgs.GetArg("-profile", DEFAULT_CHAINGEN_PROFILE))) {
+        fprintf(stderr, "Error: unknown workload profile %s\n", gArgs.GetArg("-profile", DEFAULT_CHAINGEN_PROFILE).c_str());
+        return EXIT_FAILURE;
+    }
+
+    // The generated chain is always a regtest chain
+    SelectParams(CBaseChainParams::REGTEST);
+    return CONTINUE_EXECUTION;
+}
+
+/** Writes blocks in the blk?????.dat layout that -loadblock and -reindex read */
+class CBlockFileWriter
+{
+public:
+    explicit CBlockFileWriter(const fs::path& dir) : dir(dir) {}
+
+    bool Write(const CBlock& block)
+    {
+        const unsigned int nSize = GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+        if (file && nFileSize + nSize + 8 > MAX_BLOCKFILE_SIZE) {
+            file.reset();
+            nFile++;
+        }
+        if (!file) {
+            fs::path path = dir / strprintf("blk%05u.dat", nFile);
+            file.reset(new CAutoFile(fsbridge::fopen(path, "wb"), SER_DISK, CLIENT_VERSION));
+            if (file->IsNull())
+                return false;
+            vPaths.push_back(path);
+            nFileSize = 0;
+        }
+        *file << FLATDATA(Params().MessageStart()) << nSize << block;
+        nFileSize += nSize + 8;
+        return true;
+    }
+
+    const std::vector<fs::path>& GetPaths() const { return vPaths; }
+
+private:
+    const fs::path dir;
+    std::unique_ptr<CAutoFile> file;
+    int nFile = 0;
+    uint64_t nFileSize = 0;
+    std::vector<fs::path> vPaths;
+};
+
+static int CommandLineChainGen()
+{
+    ECCVerifyHandle globalVerifyHandle;
+    ECC_Start();
+
+    const int64_t nBlocks = gArgs.GetArg("-blocks", DEFAULT_CHAINGEN_BLOCKS);
+    const int64_t nTxs = gArgs.GetArg("-txs", DEFAULT_CHAINGEN_TXS);
+    const WorkloadProfile& profile = *FindWorkloadProfile(gArgs.GetArg("-profile", DEFAULT_CHAINGEN_PROFILE));
+    const fs::path dir = fs::absolute(gArgs.GetArg("-out", "."));
+    fs::create_directories(dir);
+
+    CChainGenerator generator(gArgs.GetArg("-seed", DEFAULT_CHAINGEN_SEED), profile,
+                              gArgs.GetArg("-depth", DEFAULT_CHAINGEN_DEPTH), gArgs.GetArg("-spacing", DEFAULT_CHAINGEN_SPACING));
+    CBlockFileWriter writer(dir);
+
+    uint64_t nTxCount = 0;
+    bool fWritten = writer.Write(Params().GenesisBlock());
+    for (int64_t nHeight = 1; fWritten && nHeight <= nBlocks; nHeight++) {
+        CBlock block = generator.NextBlock(nTxs);
+        nTxCount += block.vtx.size();
+        fWritten = writer.Write(block);
+        if (nHeight % 1000 == 0)
+            fprintf(stderr, "%u blocks, %u transactions, %u accounts\n", (unsigned int)nHeight, (unsigned int)nTxCount, (unsigned int)generator.GetAccountCount());
+    }
+    if (!fWritten) {
+        fprintf(stderr, "Error: unable to write the block files to %s\n", dir.string().c_str());
+        ECC_Stop();
+        return EXIT_FAILURE;
+    }
+
+    std::string strLoad;
+    for (const fs::path& path : writer.GetPaths())
+        strLoad += " -loadblock=" + path.string();
+    fprintf(stdout, "Generated %u blocks with %u transactions and %u accounts (profile %s)\n",
+        (unsigned int)nBlocks, (unsigned int)nTxCount, (unsigned int)generator.GetAccountCount(), profile.name);
+    fprintf(stdout, "Genesis block: %s\n", Params().GenesisBlock().GetHash().ToString().c_str());
+    fprintf(stdout, "Manager private key: %s\n", CBitcoinSecret(generator.GetManagerKey()).ToString().c_str());
+    fprintf(stdout, "Load with:\n  bitcoind -regtest -managerpubkey=%s%s\n", HexStr(generator.GetManagerPubKey()).c_str(), strLoad.c_str());
+
+    ECC_Stop();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    SetupEnvironment();
+
+    try {
+        int ret = AppInitChainGen(argc, argv);
+        if (ret != CONTINUE_EXECUTION)
+            return ret;
+    }
+    catch (const std::exception& e) {
+        PrintExceptionContinue(&e, "AppInitChainGen()");
+        return EXIT_FAILURE;
+    } catch (...) {
+        PrintExceptionContinue(nullptr, "AppInitChainGen()");
+        return EXIT_FAILURE;
+    }
+
+    int ret = EXIT_FAILURE;
+    try {
+        ret = CommandLineChainGen();
+    }
+    catch (const std::exception& e) {
+        PrintExceptionContinue(&e, "CommandLineChainGen()");
+    } catch (...) {
+        PrintExceptionContinue(nullptr, "CommandLineChainGen()");
+    }
+    return ret;
+}
@@ -0,0 +1,406 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
+#include <base58.h>
+#include <chainparams.h>
+#include <clientversion.h>
+#include <core_io.h>
+#include <fs.h>
+#include <rpc/protocol.h>
+#include <util.h>
+#include <utilstrencodings.h>
+#include <utiltime.h>
+#include <workload.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <stdio.h>
+#include <thread>
+
+#include <event2/buffer.h>
+#include <event2/keyvalq_struct.h>
+#include <support/events.h>
+
+#include <univalue.h>
+
+static const char DEFAULT_RPCCONNECT[] = "127.0.0.1";
+static const int DEFAULT_HTTP_CLIENT_TIMEOUT = 900;
+static const int64_t DEFAULT_LOADGEN_SEED = 0;
+static const int64_t DEFAULT_LOADGEN_TXS = 1000;
+static const int64_t DEFAULT_LOADGEN_RATE = 100;
+static const int64_t DEFAULT_LOADGEN_BLOCKTXS = 100;
+static const int64_t DEFAULT_LOADGEN_DEPTH = 8;
+static const char* DEFAULT_LOADGEN_PROFILE = "mixed";
+static const int CONTINUE_EXECUTION=-1;
+
+//
+// This function returns either one of EXIT_ codes when it's expected to stop the process or
+// CONTINUE_EXECUTION when it's expected to continue further.
+//
+static int AppInitLoadGen(int argc, char* argv[])
+{
+    gArgs.ParseParameters(argc, argv);
+
+    if (gArgs.IsArgSet("-?") || gArgs.IsArgSet("-h") || gArgs.IsArgSet("-help")) {
+        std::string strUsage = strprintf(_("%s bitcoin-loadgen utility version"), _(PACKAGE_NAME)) + " " + FormatFullVersion() + "\n\n" +
+            _("Usage:") + "\n" +
+              "  bitcoin-loadgen [options]  " + _("Send a managed workload to a regtest node over RPC and report how it was admitted") + "\n" +
+              "\n";
+        strUsage += HelpMessageGroup(_("Options:"));
+        strUsage += HelpMessageOpt("-?", _("This help message"));
+        strUsage += HelpMessageOpt("-blocktxs=<n>", strprintf(_("Mine a block with generatetoaddress after every <n> transactions, 0 to never mine (default: %u)"), DEFAULT_LOADGEN_BLOCKTXS));
+        strUsage += HelpMessageOpt("-conf=<file>", strprintf(_("Specify configuration file (default: %s)"), BITCOIN_CONF_FILENAME));
+        strUsage += HelpMessageOpt("-datadir=<dir>", _("Specify data directory"));
+        strUsage += HelpMessageOpt("-depth=<n>", strprintf(_("Maximum depth of the account hierarchy (default: %u)"), DEFAULT_LOADGEN_DEPTH));
+        strUsage += HelpMessageOpt("-printmanagerkey", _("Print the manager public key of the seed, to start the node with as -managerpubkey, and exit without connecting to it"));
+        strUsage += HelpMessageOpt("-profile=<name>", strprintf(_("Workload profile, one of %s (default: %s)"), WorkloadProfileNames(), DEFAULT_LOADGEN_PROFILE));
+        strUsage += HelpMessageOpt("-rate=<n>", strprintf(_("Target number of transactions sent per second, 0 to send as fast as the node accepts them (default: %u)"), DEFAULT_LOADGEN_RATE));
+        strUsage += HelpMessageOpt("-rpcclienttimeout=<n>", strprintf(_("Timeout in seconds during HTTP requests, or 0 for no timeout. (default: %d)"), DEFAULT_HTTP_CLIENT_TIMEOUT));
+        strUsage += HelpMessageOpt("-rpcconnect=<ip>", strprintf(_("Send transactions to node running on <ip> (default: %s)"), DEFAULT_RPCCONNECT));
+        strUsage += HelpMessageOpt("-rpcpassword=<pw>", _("Password for JSON-RPC connections"));
+        strUsage += HelpMessageOpt("-rpcport=<port>", strprintf(_("Connect to JSON-RPC on <port> (default: %u)"), CreateBaseChainParams(CBaseChainParams::REGTEST)->RPCPort()));
+        strUsage += HelpMessageOpt("-rpcuser=<user>", _("Username for JSON-RPC connections"));
+        strUsage += HelpMessageOpt("-seed=<n>", strprintf(_("Seed for the keys and the workload, the node has to be started with the manager key printed for it (default: %u)"), DEFAULT_LOADGEN_SEED));
+        strUsage += HelpMessageOpt("-txs=<n>", strprintf(_("Number of transactions to send (default: %u)"), DEFAULT_LOADGEN_TXS));
+        fprintf(stdout, "%s", strUsage.c_str());
+        return EXIT_SUCCESS;
+    }
+
+    if (gArgs.GetArg("-txs", DEFAULT_LOADGEN_TXS) < 0 || gArgs.GetArg("-rate", DEFAULT_LOADGEN_RATE) < 0 ||
+        gArgs.GetArg("-blocktxs", DEFAULT_LOADGEN_BLOCKTXS) < 0 || gArgs.GetArg("-depth", DEFAULT_LOADGEN_DEPTH) < 1) {
+        fprintf(stderr, "Error: -txs, -rate and -blocktxs must not be negative, -depth must be positive\n");
+        return EXIT_FAILURE;
+    }
+    if (!FindWorkloadProfile(gArgs.GetArg("-profile", DEFAULT_LOADGEN_PROFILE))) {
+        fprintf(stderr, "Error: unknown workload profile %s\n", gArgs.GetArg("-profile", DEFAULT_LOADGEN_PROFILE).c_str());
+        return EXIT_FAILURE;
+    }
+    if (!fs::is_directory(GetDataDir(false))) {
+        fprintf(stderr, "Error: Specified data directory \"%s\" does not exist.\n", gArgs.GetArg("-datadir", "").c_str());
+        return EXIT_FAILURE;
+    }
+    try {
+        gArgs.ReadConfigFile(gArgs.GetArg("-conf", BITCOIN_CONF_FILENAME));
+    } catch (const std::exception& e) {
+        fprintf(stderr,"Error reading configuration file: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    // The workload only exists on a regtest chain whose genesis block grants
+    // the manager's roles to the generator
+    SelectParams(CBaseChainParams::REGTEST);
+    return CONTINUE_EXECUTION;
+}
+
+/** Reply structure for request_done to fill in */
+struct HTTPReply
+{
+    HTTPReply(): status(0), error(-1) {}
+
+    int status;
+    int error;
+    std::string body;
+};
+
+static void http_request_done(struct evhttp_request *req, void *ctx)
+{
+    std::pair<HTTPReply*, struct event_base*>* pctx = static_cast<std::pair<HTTPReply*, struct event_base*>*>(ctx);
+    HTTPReply *reply = pctx->first;
+
+    // The connection is kept alive and would keep the loop running
+    event_base_loopbreak(pctx->second);
+    if (req == nullptr) {
+        reply->status = 0;
+        return;
+    }
+
+    reply->status = evhttp_request_get_response_code(req);
+
+    struct evbuffer *buf = evhttp_request_get_input_buffer(req);
+    if (buf)
+    {
+        size_t size = evbuffer_get_length(buf);
+        const char *data = (const char*)evbuffer_pullup(buf, size);
+        if (data)
+            reply->body = std::string(data, size);
+        evbuffer_drain(buf, size);
+    }
+}
+
+#if LIBEVENT_VERSION_NUMBER >= 0x02010300
+static void http_error_cb(enum evhttp_request_error err, void *ctx)
+{
+    std::pair<HTTPReply*, struct event_base*>* pctx = static_cast<std::pair<HTTPReply*, struct event_base*>*>(ctx);
+    pctx->first->error = err;
+}
+#endif
+
+/**
+ * JSON-RPC client that reuses one HTTP connection for all its calls, so that
+ * the measured latency is the one of the call and not of the connection.
+ */
+class CRPCConnection
+{
+public:
+    CRPCConnection()
+    {
+        int port = BaseParams().RPCPort();
+        SplitHostPort(gArgs.GetArg("-rpcconnect", DEFAULT_RPCCONNECT), port, host);
+        port = gArgs.GetArg("-rpcport", port);
+
+        base = obtain_event_base();
+        evcon = obtain_evhttp_connection_base(base.get(), host, port);
+        evhttp_connection_set_timeout(evcon.get(), gArgs.GetArg("-rpcclienttimeout", DEFAULT_HTTP_CLIENT_TIMEOUT));
+
+        if (gArgs.GetArg("-rpcpassword", "") == "") {
+            if (!GetAuthCookie(&strRPCUserColonPass)) {
+                throw std::runtime_error("Could not locate RPC credentials. No authentication cookie could be found, and RPC password is not set.");
+            }
+        } else {
+            strRPCUserColonPass = gArgs.GetArg("-rpcuser", "") + ":" + gArgs.GetArg("-rpcpassword", "");
+        }
+    }
+
+    /** Call method and return the reply object, with its result and error */
+    UniValue Call(const std::string& strMethod, const UniValue& params)
+    {
+        HTTPReply response;
+        std::pair<HTTPReply*, struct event_base*> ctx(&response, base.get());
+        raii_evhttp_request req = obtain_evhttp_request(http_request_done, (void*)&ctx);
+        if (req == nullptr)
+            throw std::runtime_error("create http request failed");
+#if LIBEVENT_VERSION_NUMBER >= 0x02010300
+        evhttp_request_set_error_cb(req.get(), http_error_cb);
+#endif
+
+        struct evkeyvalq* output_headers = evhttp_request_get_output_headers(req.get());
+        assert(output_headers);
+        evhttp_add_header(output_headers, "Host", host.c_str());
+        evhttp_add_header(output_headers, "Authorization", (std::string("Basic ") + EncodeBase64(strRPCUserColonPass)).c_str());
+
+        std::string strRequest = JSONRPCRequestObj(strMethod, params, ++nId).write() + "\n";
+        struct evbuffer* output_buffer = evhttp_request_get_output_buffer(req.get());
+        assert(output_buffer);
+        evbuffer_add(output_buffer, strRequest.data(), strRequest.size());
+
+        int r = evhttp_make_request(evcon.get(), req.get(), EVHTTP_REQ_POST, "/");
+        req.release(); // ownership moved to evcon in above call
+        if (r != 0)
+            throw std::runtime_error("send http request failed");
+
+        event_base_dispatch(base.get());
+
+        if (response.status == 0)
+            throw std::runtime_error(strprintf("couldn't connect to server (code %d)\n(make sure server is running and you are connecting to the correct RPC port)", response.error));
+        else if (response.status == HTTP_UNAUTHORIZED)
+            throw std::runtime_error("incorrect rpcuser or rpcpassword (authorization failed)");
+        else if (response.status >= 400 && response.status != HTTP_BAD_REQUEST && response.status != HTTP_NOT_FOUND && response.status != HTTP_INTERNAL_SERVER_ERROR)
+            throw std::runtime_error(strprintf("server returned HTTP error %d", response.status));
+        else if (response.body.empty())
+            throw std::runtime_error("no response from server");
+
+        UniValue valReply(UniValue::VSTR);
+        if (!valReply.read(response.body) || !valReply.isObject())
+            throw std::runtime_error("couldn't parse reply from server");
+        return valReply;
+    }
+
+    /** Call method and return its result, throwing its error if there is one */
+    UniValue CallResult(const std::string& strMethod, const UniValue& params)
+    {
+        const UniValue reply = Call(strMethod, params);
+        const UniValue& error = find_value(reply, "error");
+        if (!error.isNull())
+            throw std::runtime_error(strprintf("%s failed: %s", strMethod, find_value(error, "message").getValStr()));
+        return find_value(reply, "result");
+    }
+
+private:
+    std::string host;
+    std::string strRPCUserColonPass;
+    raii_event_base base;
+    raii_evhttp_connection evcon;
+    int nId = 0;
+};
+
+static std::string VersionName(int32_t nVersion)
+{
+    switch (nVersion) {
+        case CTransaction::VERSION_COIN_TRANSFER: return "coin transfer";
+        case CTransaction::VERSION_COIN_FORFEITURE: return "coin forfeiture";
+        case CTransaction::VERSION_COIN_CREATION: return "coin creation";
+        case CTransaction::VERSION_ROLE_CREATION: return "role creation";
+        case CTransaction::VERSION_ROLE_CHANGE: return "role change";
+        case CTransaction::VERSION_POLICY_CHANGE: return "policy change";
+        default: return strprintf("version %d", nVersion);
+    }
+}
+
+/** The sample below which the given fraction of the sorted samples lie */
+static int64_t Percentile(const std::vector<int64_t>& vSorted, double dFraction)
+{
+    if (vSorted.empty())
+        return 0;
+    return vSorted[std::min<size_t>(vSorted.size() - 1, dFraction * vSorted.size())];
+}
+
+static int CommandLineLoadGen()
+{
+    ECCVerifyHandle globalVerifyHandle;
+    ECC_Start();
+
+    const int64_t nTxs = gArgs.GetArg("-txs", DEFAULT_LOADGEN_TXS);
+    const int64_t nRate = gArgs.GetArg("-rate", DEFAULT_LOADGEN_RATE);
+    const int64_t nBlockTxs = gArgs.GetArg("-blocktxs", DEFAULT_LOADGEN_BLOCKTXS);
+    const WorkloadProfile& profile = *FindWorkloadProfile(gArgs.GetArg("-profile", DEFAULT_LOADGEN_PROFILE));
+    CChainGenerator generator(gArgs.GetArg("-seed", DEFAULT_LOADGEN_SEED), profile, gArgs.GetArg("-depth", DEFAULT_LOADGEN_DEPTH), 1);
+
+    if (gArgs.GetBoolArg("-printmanagerkey", false)) {
+        fprintf(stdout, "%s\n", HexStr(generator.GetManagerPubKey()).c_str());
+        ECC_Stop();
+        return EXIT_SUCCESS;
+    }
+
+    CRPCConnection rpc;
+    UniValue params(UniValue::VARR);
+    params.push_back(0);
+    if (rpc.CallResult("getblockhash", params).get_str() != Params().GenesisBlock().GetHash().GetHex()) {
+        fprintf(stderr, "Error: the node does not run the chain of this seed, start it on a new regtest data directory with\n"
+            "  bitcoind -regtest -managerpubkey=%s -minrelaytxfee=0 -incrementalrelayfee=0 -limitancestorcount=1000000 -limitancestorsize=5000 -limitdescendantcount=1000000 -limitdescendantsize=5000\n"
+            "The key can be printed beforehand with -printmanagerkey.\n",
+            HexStr(generator.GetManagerPubKey()).c_str());
+        ECC_Stop();
+        return EXIT_FAILURE;
+    }
+    if (rpc.CallResult("getblockcount", NullUniValue).get_int() != 0) {
+        fprintf(stderr, "Error: the workload has to start from the genesis block, restart the node on a new data directory\n");
+        ECC_Stop();
+        return EXIT_FAILURE;
+    }
+
+    // Build and sign everything upfront, so that the sending rate does not
+    // depend on how fast the transactions are signed. The coin creation
+    // limit applies to each block, which ends every nBlockTxs transactions.
+    std::vector<CTransactionRef> vTxs;
+    CAmount nCreatedInBlock = 0;
+    for (int64_t i = 0; i < nTxs; i++) {
+        if (nBlockTxs > 0 && i % nBlockTxs == 0)
+            nCreatedInBlock = 0;
+        CTransactionRef tx = generator.NextTransaction(nCreatedInBlock);
+        if (tx)
+            vTxs.push_back(tx);
+    }
+    fprintf(stderr, "Generated %u transactions for %u accounts, sending\n", (unsigned int)vTxs.size(), (unsigned int)generator.GetAccountCount());
+
+    UniValue mineParams(UniValue::VARR);
+    mineParams.push_back(1);
+    mineParams.push_back(EncodeDestination(generator.GetManagerPubKey().GetID()));
+
+    std::vector<int64_t> vLatencies;
+    std::map<std::string, int> mapRejectReasons;
+    std::map<int32_t, std::pair<int, int>> mapVersions;
+    int nAccepted = 0, nRejected = 0, nBlocks = 0;
+
+    // Sending pauses while a block is mined, which does not count against the rate
+    const int64_t nStart = GetTimeMicros();
+    int64_t nMiningTime = 0;
+    for (size_t i = 0; i < vTxs.size(); i++) {
+        if (nBlockTxs > 0 && i > 0 && i % nBlockTxs == 0) {
+            const int64_t nMineStart = GetTimeMicros();
+            rpc.CallResult("generatetoaddress", mineParams);
+            nMiningTime += GetTimeMicros() - nMineStart;
+            nBlocks++;
+        }
+        if (nRate > 0) {
+            const int64_t nWait = nStart + nMiningTime + (int64_t)i * 1000000 / nRate - GetTimeMicros();
+            if (nWait > 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(nWait));
+        }
+
+        UniValue txParams(UniValue::VARR);
+        txParams.push_back(EncodeHexTx(*vTxs[i]));
+        const int64_t nSent = GetTimeMicros();
+        const UniValue reply = rpc.Call("sendrawtransaction", txParams);
+        const int64_t nLatency = GetTimeMicros() - nSent;
+
+        const UniValue& error = find_value(reply, "error");
+        if (error.isNull()) {
+            nAccepted++;
+            mapVersions[vTxs[i]->nVersion].first++;
+            vLatencies.push_back(nLatency);
+        } else {
+            nRejected++;
+            mapVersions[vTxs[i]->nVersion].second++;
+            mapRejectReasons[find_value(error, "message").getValStr()]++;
+        }
+    }
+    const int64_t nElapsed = std::max<int64_t>(1, GetTimeMicros() - nStart - nMiningTime);
+
+    if (nBlockTxs > 0 && !vTxs.empty()) {
+        const int64_t nMineStart = GetTimeMicros();
+        rpc.CallResult("generatetoaddress", mineParams);
+        nMiningTime += GetTimeMicros() - nMineStart;
+        nBlocks++;
+    }
+    const UniValue mempoolInfo = rpc.CallResult("getmempoolinfo", NullUniValue);
+
+    std::sort(vLatencies.begin(), vLatencies.end());
+    int64_t nLatencySum = 0;
+    for (int64_t nLatency : vLatencies)
+        nLatencySum += nLatency;
+
+    fprintf(stdout, "Sent %u transactions in %.3fs (%.1f tx/s, target %s), mined %u blocks in %.3fs (profile %s)\n",
+        (unsigned int)vTxs.size(), nElapsed / 1e6, vTxs.size() * 1e6 / nElapsed,
+        nRate > 0 ? strprintf("%d tx/s", nRate).c_str() : "unlimited", nBlocks, nMiningTime / 1e6, profile.name);
+    fprintf(stdout, "Accepted: %d (%.1f%%), rejected: %d, left in the mempool: %d\n",
+        nAccepted, vTxs.empty() ? 0.0 : 100.0 * nAccepted / vTxs.size(), nRejected, find_value(mempoolInfo, "size").get_int());
+    for (const auto& version : mapVersions)
+        fprintf(stdout, "  %-16s %6d accepted %6d rejected\n", VersionName(version.first).c_str(), version.second.first, version.second.second);
+    for (const auto& reason : mapRejectReasons)
+        fprintf(stdout, "  rejected %d times: %s\n", reason.second, reason.first.c_str());
+    fprintf(stdout, "%s", strprintf("Admission latency: mean=%.0fus p50=%dus p90=%dus p99=%dus max=%dus\n",
+        vLatencies.empty() ? 0.0 : (double)nLatencySum / vLatencies.size(), Percentile(vLatencies, 0.5),
+        Percentile(vLatencies, 0.9), Percentile(vLatencies, 0.99), Percentile(vLatencies, 1.0)).c_str());
+
+    ECC_Stop();
+    return nRejected == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[])
+{
+    SetupEnvironment();
+    if (!SetupNetworking()) {
+        fprintf(stderr, "Error: Initializing networking failed\n");
+        return EXIT_FAILURE;
+    }
+
+    try {
+        int ret = AppInitLoadGen(argc, argv);
+        if (ret != CONTINUE_EXECUTION)
+            return ret;
+    }
+    catch (const std::exception& e) {
+        PrintExceptionContinue(&e, "AppInitLoadGen()");
+        return EXIT_FAILURE;
+    } catch (...) {
+        PrintExceptionContinue(nullptr, "AppInitLoadGen()");
+        return EXIT_FAILURE;
+    }
+
+    int ret = EXIT_FAILURE;
+    try {
+        ret = CommandLineLoadGen();
+    }
+    catch (const std::exception& e) {
+        PrintExceptionContinue(&e, "CommandLineLoadGen()");
+    } catch (...) {
+        PrintExceptionContinue(nullptr, "CommandLineLoadGen()");
+    }
+    return ret;
+}
@@ -21,10 +21,14 @@ CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, bool f
     FillShortTxIDSelector();
     //TODO: Use our mempool prior to block acceptance to predictively fill more than just the coinbase
     prefilledtxn[0] = {0, block.vtx[0]};
+    std::vector<uint256> txhashes(shorttxids.size());
+    std::vector<const uint256*> batch(shorttxids.size());
     for (size_t i = 1; i < block.vtx.size(); i++) {
         const CTransaction& tx = *block.vtx[i];
-        shorttxids[i - 1] = GetShortID(fUseWTXID ? tx.GetWitnessHash() : tx.GetHash());
+        txhashes[i - 1] = fUseWTXID ? tx.GetWitnessHash() : tx.GetHash();
+        batch[i - 1] = &txhashes[i - 1];
     }
+    GetShortIDs(batch.data(), shorttxids.data(), batch.size());
 }
 
 void CBlockHeaderAndShortTxIDs::FillShortTxIDSelector() const {
@@ -43,7 +47,14 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const uint256& txhash) const {
     return SipHashUint256(shorttxidk0, shorttxidk1, txhash) & 0xffffffffffffL;
 }
 
+void CBlockHeaderAndShortTxIDs::GetShortIDs(const uint256* const* txhashes, uint64_t* shortids, size_t n) const {
+    SipHashUint256Batch(shorttxidk0, shorttxidk1, txhashes, shortids, n);
+    for (size_t i = 0; i < n; i++) {
+        shortids[i] &= 0xffffffffffffL;
+    }
+}
 
+static const size_t SHORTID_BATCH_SIZE = 64;
 
 ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& extra_txn) {
     if (cmpctblock.header.IsNull() || (cmpctblock.shorttxids.empty() && cmpctblock.prefilledtxn.empty()))
@@ -102,11 +113,22 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
         return READ_STATUS_FAILED; // Short ID collision
 
     std::vector<bool> have_txn(txn_available.size());
+    // The short IDs of the mempool and extra transactions are computed a batch
+    // at a time, ahead of the lookups
+    const uint256* batch[SHORTID_BATCH_SIZE];
+    uint64_t shortids[SHORTID_BATCH_SIZE];
     {
     LOCK(pool->cs);
     const std::vector<std::pair<uint256, CTxMemPool::txiter> >& vTxHashes = pool->vTxHashes;
     for (size_t i = 0; i < vTxHashes.size(); i++) {
-        uint64_t shortid = cmpctblock.GetShortID(vTxHashes[i].first);
+        if (i % SHORTID_BATCH_SIZE == 0) {
+            size_t n = std::min(SHORTID_BATCH_SIZE, vTxHashes.size() - i);
+            for (size_t j = 0; j < n; j++) {
+                batch[j] = &vTxHashes[i + j].first;
+            }
+            cmpctblock.GetShortIDs(batch, shortids, n);
+        }
+        uint64_t shortid = shortids[i % SHORTID_BATCH_SIZE];
         std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
         if (idit != shorttxids.end()) {
             if (!have_txn[idit->second]) {
@@ -132,7 +154,14 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     }
 
     for (size_t i = 0; i < extra_txn.size(); i++) {
-        uint64_t shortid = cmpctblock.GetShortID(extra_txn[i].first);
+        if (i % SHORTID_BATCH_SIZE == 0) {
+            size_t n = std::min(SHORTID_BATCH_SIZE, extra_txn.size() - i);
+            for (size_t j = 0; j < n; j++) {
+                batch[j] = &extra_txn[i + j].first;
+            }
+            cmpctblock.GetShortIDs(batch, shortids, n);
+        }
+        uint64_t shortid = shortids[i % SHORTID_BATCH_SIZE];
         std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
         if (idit != shorttxids.end()) {
             if (!have_txn[idit->second]) {
@@ -5,6 +5,7 @@
 #include <bloom.h>
 
 #include <primitives/transaction.h>
+#include <crypto/common.h>
 #include <hash.h>
 #include <script/script.h>
 #include <script/standard.h>
@@ -13,11 +14,25 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 #define LN2SQUARED 0.4804530139182014246671025263266649717305529515945455
 #define LN2 0.6931471805599453094172321214581765680755001343602552
 
+/** The number of hash functions computed together by MurmurHash3Batch */
+static const unsigned int BLOOM_HASH_BATCH = 8;
+
+/** The size of the serialization of an outpoint */
+static const size_t OUTPOINT_SIZE = 36;
+
+/** Serialize an outpoint as CDataStream would, without allocating */
+static void SerializeOutPoint(const COutPoint& outpoint, unsigned char out[OUTPOINT_SIZE])
+{
+    memcpy(out, outpoint.hash.begin(), 32);
+    WriteLE32(out + 32, outpoint.n);
+}
+
 CBloomFilter::CBloomFilter(const unsigned int nElements, const double nFPRate, const unsigned int nTweakIn, unsigned char nFlagsIn) :
     /**
      * The ideal size for a bloom filter with a given number of elements and false positive rate is:
@@ -49,67 +64,88 @@ CBloomFilter::CBloomFilter(const unsigned int nElements, const double nFPRate, c
 {
 }
 
-inline unsigned int CBloomFilter::Hash(unsigned int nHashNum, const std::vector<unsigned char>& vDataToHash) const
+void CBloomFilter::Hashes(unsigned int nHashNum, unsigned int n, const unsigned char* data, size_t len, uint32_t* nIndexes) const
 {
-    // 0xFBA4C795 chosen as it guarantees a reasonable bit difference between nHashNum values.
-    return MurmurHash3(nHashNum * 0xFBA4C795 + nTweak, vDataToHash) % (vData.size() * 8);
+    uint32_t nSeeds[BLOOM_HASH_BATCH];
+    for (unsigned int i = 0; i < n; i++) {
+        // 0xFBA4C795 chosen as it guarantees a reasonable bit difference between nHashNum values.
+        nSeeds[i] = (nHashNum + i) * 0xFBA4C795 + nTweak;
+    }
+    MurmurHash3Batch(nSeeds, data, len, nIndexes, n);
+    for (unsigned int i = 0; i < n; i++) {
+        nIndexes[i] %= vData.size() * 8;
+    }
 }
 
-void CBloomFilter::insert(const std::vector<unsigned char>& vKey)
+void CBloomFilter::insert(const unsigned char* data, size_t len)
 {
     if (isFull)
         return;
-    for (unsigned int i = 0; i < nHashFuncs; i++)
+    uint32_t nIndexes[BLOOM_HASH_BATCH];
+    for (unsigned int i = 0; i < nHashFuncs; i += BLOOM_HASH_BATCH)
     {
-        unsigned int nIndex = Hash(i, vKey);
-        // Sets bit nIndex of vData
-        vData[nIndex >> 3] |= (1 << (7 & nIndex));
+        const unsigned int n = std::min(nHashFuncs - i, BLOOM_HASH_BATCH);
+        Hashes(i, n, data, len, nIndexes);
+        for (unsigned int j = 0; j < n; j++) {
+            // Sets bit nIndex of vData
+            vData[nIndexes[j] >> 3] |= (1 << (7 & nIndexes[j]));
+        }
     }
     isEmpty = false;
 }
 
+void CBloomFilter::insert(const std::vector<unsigned char>& vKey)
+{
+    insert(vKey.data(), vKey.size());
+}
+
 void CBloomFilter::insert(const COutPoint& outpoint)
 {
-    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
-    stream << outpoint;
-    std::vector<unsigned char> data(stream.begin(), stream.end());
-    insert(data);
+    unsigned char data[OUTPOINT_SIZE];
+    SerializeOutPoint(outpoint, data);
+    insert(data, sizeof(data));
 }
 
 void CBloomFilter::insert(const uint256& hash)
 {
-    std::vector<unsigned char> data(hash.begin(), hash.end());
-    insert(data);
+    insert(hash.begin(), hash.size());
 }
 
-bool CBloomFilter::contains(const std::vector<unsigned char>& vKey) const
+bool CBloomFilter::contains(const unsigned char* data, size_t len) const
 {
     if (isFull)
         return true;
     if (isEmpty)
         return false;
-    for (unsigned int i = 0; i < nHashFuncs; i++)
+    uint32_t nIndexes[BLOOM_HASH_BATCH];
+    for (unsigned int i = 0; i < nHashFuncs; i += BLOOM_HASH_BATCH)
     {
-        unsigned int nIndex = Hash(i, vKey);
-        // Checks bit nIndex of vData
-        if (!(vData[nIndex >> 3] & (1 << (7 & nIndex))))
-            return false;
+        const unsigned int n = std::min(nHashFuncs - i, BLOOM_HASH_BATCH);
+        Hashes(i, n, data, len, nIndexes);
+        for (unsigned int j = 0; j < n; j++) {
+            // Checks bit nIndex of vData
+            if (!(vData[nIndexes[j] >> 3] & (1 << (7 & nIndexes[j]))))
+                return false;
+        }
     }
     return true;
 }
 
+bool CBloomFilter::contains(const std::vector<unsigned char>& vKey) const
+{
+    return contains(vKey.data(), vKey.size());
+}
+
 bool CBloomFilter::contains(const COutPoint& outpoint) const
 {
-    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
-    stream << outpoint;
-    std::vector<unsigned char> data(stream.begin(), stream.end());
-    return contains(data);
+    unsigned char data[OUTPOINT_SIZE];
+    SerializeOutPoint(outpoint, data);
+    return contains(data, sizeof(data));
 }
 
 bool CBloomFilter::contains(const uint256& hash) const
 {
-    std::vector<unsigned char> data(hash.begin(), hash.end());
-    return contains(data);
+    return contains(hash.begin(), hash.size());
 }
 
 void CBloomFilter::clear()
@@ -240,12 +276,16 @@ CRollingBloomFilter::CRollingBloomFilter(const unsigned int nElements, const dou
     reset();
 }
 
-/* Similar to CBloomFilter::Hash */
-static inline uint32_t RollingBloomHash(unsigned int nHashNum, uint32_t nTweak, const std::vector<unsigned char>& vDataToHash) {
-    return MurmurHash3(nHashNum * 0xFBA4C795 + nTweak, vDataToHash);
+/* Hash functions nHashNum to nHashNum + n - 1 of vKey, with the same seeds as CBloomFilter::Hashes */
+static inline void RollingBloomHashes(unsigned int nHashNum, unsigned int n, uint32_t nTweak, const unsigned char* vKey, size_t len, uint32_t* h) {
+    uint32_t nSeeds[BLOOM_HASH_BATCH];
+    for (unsigned int i = 0; i < n; i++) {
+        nSeeds[i] = (nHashNum + i) * 0xFBA4C795 + nTweak;
+    }
+    MurmurHash3Batch(nSeeds, vKey, len, h, n);
 }
 
-void CRollingBloomFilter::insert(const std::vector<unsigned char>& vKey)
+void CRollingBloomFilter::insert(const unsigned char* vKey, size_t len)
 {
     if (nEntriesThisGeneration == nEntriesPerGeneration) {
         nEntriesThisGeneration = 0;
@@ -265,40 +305,61 @@ void CRollingBloomFilter::insert(const std::vector<unsigned char>& vKey)
     }
     nEntriesThisGeneration++;
 
-    for (int n = 0; n < nHashFuncs; n++) {
-        uint32_t h = RollingBloomHash(n, nTweak, vKey);
-        int bit = h & 0x3F;
-        uint32_t pos = (h >> 6) % data.size();
-        /* The lowest bit of pos is ignored, and set to zero for the first bit, and to one for the second. */
-        data[pos & ~1] = (data[pos & ~1] & ~(((uint64_t)1) << bit)) | ((uint64_t)(nGeneration & 1)) << bit;
-        data[pos | 1] = (data[pos | 1] & ~(((uint64_t)1) << bit)) | ((uint64_t)(nGeneration >> 1)) << bit;
+    uint32_t hashes[BLOOM_HASH_BATCH];
+    for (unsigned int i = 0; i < (unsigned int)nHashFuncs; i += BLOOM_HASH_BATCH) {
+        const unsigned int n = std::min(nHashFuncs - i, BLOOM_HASH_BATCH);
+        RollingBloomHashes(i, n, nTweak, vKey, len, hashes);
+        for (unsigned int j = 0; j < n; j++) {
+            uint32_t h = hashes[j];
+            int bit = h & 0x3F;
+            uint32_t pos = (h >> 6) % data.size();
+            /* The lowest bit of pos is ignored, and set to zero for the first bit, and to one for the second. */
+            data[pos & ~1] = (data[pos & ~1] & ~(((uint64_t)1) << bit)) | ((uint64_t)(nGeneration & 1)) << bit;
+            data[pos | 1] = (data[pos | 1] & ~(((uint64_t)1) << bit)) | ((uint64_t)(nGeneration >> 1)) << bit;
+        }
     }
 }
 
+void CRollingBloomFilter::insert(const std::vector<unsigned char>& vKey)
+{
+    insert(vKey.data(), vKey.size());
+}
+
 void CRollingBloomFilter::insert(const uint256& hash)
 {
-    std::vector<unsigned char> vData(hash.begin(), hash.end());
-    insert(vData);
+    insert(hash.begin(), hash.size());
 }
 
-bool CRollingBloomFilter::contains(const std::vector<unsigned char>& vKey) const
+bool CRollingBloomFilter::contains(const unsigned char* vKey, size_t len) const
 {
-    for (int n = 0; n < nHashFuncs; n++) {
-        uint32_t h = RollingBloomHash(n, nTweak, vKey);
-        int bit = h & 0x3F;
-        uint32_t pos = (h >> 6) % data.size();
-        /* If the relevant bit is not set in either data[pos & ~1] or data[pos | 1], the filter does not contain vKey */
-        if (!(((data[pos & ~1] | data[pos | 1]) >> bit) & 1)) {
-            return false;
+    /* Most lookups are of absent keys, which usually fail on one of the first
+     * positions, so start with a single hash and double the batch from there. */
+    uint32_t hashes[BLOOM_HASH_BATCH];
+    unsigned int nBatch = 1;
+    for (unsigned int i = 0; i < (unsigned int)nHashFuncs; i += nBatch, nBatch = std::min(2 * nBatch, BLOOM_HASH_BATCH)) {
+        const unsigned int n = std::min(nHashFuncs - i, nBatch);
+        RollingBloomHashes(i, n, nTweak, vKey, len, hashes);
+        for (unsigned int j = 0; j < n; j++) {
+            uint32_t h = hashes[j];
+            int bit = h & 0x3F;
+            uint32_t pos = (h >> 6) % data.size();
+            /* If the relevant bit is not set in either data[pos & ~1] or data[pos | 1], the filter does not contain vKey */
+            if (!(((data[pos & ~1] | data[pos | 1]) >> bit) & 1)) {
+                return false;
+            }
         }
     }
     return true;
 }
 
+bool CRollingBloomFilter::contains(const std::vector<unsigned char>& vKey) const
+{
+    return contains(vKey.data(), vKey.size());
+}
+
 bool CRollingBloomFilter::contains(const uint256& hash) const
 {
-    std::vector<unsigned char> vData(hash.begin(), hash.end());
-    return contains(vData);
+    return contains(hash.begin(), hash.size());
 }
 
 void CRollingBloomFilter::reset()
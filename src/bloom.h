@@ -51,7 +51,11 @@ private:
     unsigned int nTweak;
     unsigned char nFlags;
 
-    unsigned int Hash(unsigned int nHashNum, const std::vector<unsigned char>& vDataToHash) const;
+    //! Compute the bit indexes of hash functions nHashNum to nHashNum + n - 1 of data
+    void Hashes(unsigned int nHashNum, unsigned int n, const unsigned char* data, size_t len, uint32_t* nIndexes) const;
+
+    void insert(const unsigned char* data, size_t len);
+    bool contains(const unsigned char* data, size_t len) const;
 
     // Private constructor for CRollingBloomFilter, no restrictions on size
     CBloomFilter(const unsigned int nElements, const double nFPRate, const unsigned int nTweak);
@@ -138,6 +142,9 @@ private:
     std::vector<uint64_t> data;
     unsigned int nTweak;
     int nHashFuncs;
+
+    void insert(const unsigned char* vKey, size_t len);
+    bool contains(const unsigned char* vKey, size_t len) const;
 };
 
 #endif // BITCOIN_BLOOM_H
@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chainparams.h>
+#include <arith_uint256.h>
 #include <consensus/merkle.h>
 
 #include <tinyformat.h>
@@ -73,6 +74,17 @@ void CChainParams::UpdateVersionBitsParameters(Consensus::DeploymentPos d, int64
     consensus.vDeployments[d].nTimeout = nTimeout;
 }
 
+void CChainParams::UpdateGenesisManager(const CScript& managerOutputScript)
+{
+    genesis = CreateGenesisBlock(managerOutputScript, genesis.nTime, genesis.nNonce, genesis.nBits, genesis.nVersion, GetManagementPolicy());
+    // Re-mine the genesis block, the block is checked when read back from disk
+    arith_uint256 bnTarget;
+    bnTarget.SetCompact(genesis.nBits);
+    while (UintToArith256(genesis.GetHash()) > bnTarget)
+        ++genesis.nNonce;
+    consensus.hashGenesisBlock = genesis.GetHash();
+}
+
 /**
  * Main network
  */
@@ -424,3 +436,8 @@ void UpdateVersionBitsParameters(Consensus::DeploymentPos d, int64_t nStartTime,
 {
     globalChainParams->UpdateVersionBitsParameters(d, nStartTime, nTimeout);
 }
+
+void UpdateGenesisManager(const CScript& managerOutputScript)
+{
+    globalChainParams->UpdateGenesisManager(managerOutputScript);
+}
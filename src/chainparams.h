@@ -74,6 +74,7 @@ public:
     const CCheckpointData& Checkpoints() const { return checkpointData; }
     const ChainTxData& TxData() const { return chainTxData; }
     void UpdateVersionBitsParameters(Consensus::DeploymentPos d, int64_t nStartTime, int64_t nTimeout);
+    void UpdateGenesisManager(const CScript& managerOutputScript);
     CManagementPolicy GetManagementPolicy() const { return managementPolicy; }
 protected:
     CChainParams() {}
@@ -120,4 +121,9 @@ void SelectParams(const std::string& chain);
  */
 void UpdateVersionBitsParameters(Consensus::DeploymentPos d, int64_t nStartTime, int64_t nTimeout);
 
+/**
+ * Allows replacing the manager's account of the regtest genesis block.
+ */
+void UpdateGenesisManager(const CScript& managerOutputScript);
+
 #endif // BITCOIN_CHAINPARAMS_H
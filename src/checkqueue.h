@@ -16,6 +16,21 @@
 template <typename T>
 class CCheckQueueControl;
 
+/**
+ * Run a batch of checks, stopping at the first failure. The queue calls this
+ * unqualified for each batch its workers take, so that a check type whose
+ * checks can share work within a batch can provide an overload of its own,
+ * found by argument-dependent lookup.
+ */
+template <typename T>
+bool RunCheckBatch(std::vector<T>& vChecks)
+{
+    for (T& check : vChecks) {
+        if (!check()) return false;
+    }
+    return true;
+}
+
 /** 
  * Queue for verifications that have to be performed.
   * The verifications are represented by a type T, which must provide an
@@ -116,9 +131,8 @@ private:
                 fOk = fAllOk;
             }
             // execute work
-            for (T& check : vChecks)
-                if (fOk)
-                    fOk = check();
+            if (fOk)
+                fOk = RunCheckBatch(vChecks);
             vChecks.clear();
         } while (true);
     }
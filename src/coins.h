@@ -26,7 +26,10 @@
  *
  * Serialized format:
  * - VARINT((coinbase ? 1 : 0) | (height << 1))
- * - the non-spent CTxOut (via CTxOutCompressor)
+ * - the non-spent CTxOut (via CCoinTxOutCompressor)
+ *
+ * Chainstates written before COIN_DB_VERSION 1 used CTxOutCompressor and
+ * are converted by CCoinsViewDB::Upgrade().
  */
 class Coin
 {
@@ -62,7 +65,7 @@ public:
         assert(!IsSpent());
         uint32_t code = nHeight * 2 + fCoinBase;
         ::Serialize(s, VARINT(code));
-        ::Serialize(s, CTxOutCompressor(REF(out)));
+        ::Serialize(s, CCoinTxOutCompressor(REF(out)));
     }
 
     template<typename Stream>
@@ -71,7 +74,7 @@ public:
         ::Unserialize(s, VARINT(code));
         nHeight = code >> 1;
         fCoinBase = code & 1;
-        ::Unserialize(s, REF(CTxOutCompressor(out)));
+        ::Unserialize(s, REF(CCoinTxOutCompressor(out)));
     }
 
     bool IsSpent() const {
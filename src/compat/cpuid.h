@@ -0,0 +1,51 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_COMPAT_CPUID_H
+#define BITCOIN_COMPAT_CPUID_H
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__amd64__)
+#include <cpuid.h>
+#endif
+
+/** Instruction set extensions of the CPU that this process can use */
+struct CPUFeatures
+{
+    bool fSSE41 = false;
+    //! Only set when the OS also saves the AVX registers on context switches
+    bool fAVX = false;
+    bool fAVX2 = false;
+    bool fSHANI = false;
+};
+
+/** Detect the CPU features with cpuid and xgetbv, once per process */
+inline const CPUFeatures& GetCPUFeatures()
+{
+    static const CPUFeatures features = [] {
+        CPUFeatures f;
+#if defined(__x86_64__) || defined(__amd64__)
+        uint32_t eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            f.fSSE41 = (ecx >> 19) & 1;
+            // AVX needs OSXSAVE, then xgetbv tells whether the OS enabled the AVX state
+            if (((ecx >> 27) & 1) && ((ecx >> 28) & 1)) {
+                uint32_t a, d;
+                __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+                f.fAVX = (a & 6) == 6;
+            }
+        }
+        if (__get_cpuid_max(0, nullptr) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            f.fAVX2 = f.fAVX && ((ebx >> 5) & 1);
+            f.fSHANI = (ebx >> 29) & 1;
+        }
+#endif
+        return f;
+    }();
+    return features;
+}
+
+#endif // BITCOIN_COMPAT_CPUID_H
@@ -124,4 +124,69 @@ public:
     }
 };
 
+/**
+ * Compact serializer for the CTxOut of a chainstate coin.
+ *
+ * The output type and its value are packed into a single VARINT whose two
+ * low bits hold the type:
+ *  * coin transfers store the compressed amount above the type bits
+ *  * role changes store the role bits, which fit in one byte for all roles
+ *    but M
+ *  * policy changes store the raw policy bits
+ * Values that do not fit in the remaining 62 bits are stored with a zero
+ * type, followed by the type and the raw value.
+ *
+ * Undo data keeps using CTxOutCompressor.
+ */
+class CCoinTxOutCompressor
+{
+private:
+    static const uint64_t MAX_PACKED_VALUE = (uint64_t)-1 >> 2;
+
+    CTxOut &txout;
+
+public:
+    explicit CCoinTxOutCompressor(CTxOut &txoutIn) : txout(txoutIn) { }
+
+    template<typename Stream>
+    void Serialize(Stream &s) const {
+        uint64_t nVal = txout.nTxType == CTxOut::COIN_TRANSFER ? CTxOutCompressor::CompressAmount(txout.nValue) : (uint64_t)txout.nValue;
+        if (txout.nTxType != CTxOut::UNINITIALIZED && nVal <= MAX_PACKED_VALUE) {
+            uint64_t nCode = (nVal << 2) | txout.nTxType;
+            s << VARINT(nCode);
+        } else {
+            uint64_t nCode = 0;
+            uint8_t nTyp = txout.nTxType;
+            uint64_t nRaw = txout.nValue;
+            s << VARINT(nCode);
+            s << nTyp;
+            s << VARINT(nRaw);
+        }
+        s << CScriptCompressor(REF(txout.scriptPubKey));
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream &s) {
+        uint64_t nCode = 0;
+        s >> VARINT(nCode);
+        if (nCode == 0) {
+            uint8_t nTyp = CTxOut::UNINITIALIZED;
+            uint64_t nRaw = 0;
+            s >> nTyp;
+            s >> VARINT(nRaw);
+            if (nTyp > CTxOut::POLICY_CHANGE)
+                throw std::ios_base::failure("CCoinTxOutCompressor: unknown output type");
+            txout.nValue = nRaw;
+            txout.nTxType = (enum CTxOut::TxType)nTyp;
+        } else {
+            uint64_t nVal = nCode >> 2;
+            txout.nTxType = (enum CTxOut::TxType)(nCode & 3);
+            txout.nValue = txout.nTxType == CTxOut::COIN_TRANSFER ? CTxOutCompressor::DecompressAmount(nVal) : nVal;
+        }
+        txout.Check(__func__, __LINE__); // FIXME
+        CScriptCompressor cscript(REF(txout.scriptPubKey));
+        s >> cscript;
+    }
+};
+
 #endif // BITCOIN_COMPRESSOR_H
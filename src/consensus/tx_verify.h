@@ -14,6 +14,7 @@ class CBlockIndex;
 class CCoinsViewCache;
 class CTransaction;
 class CValidationState;
+struct CRoleChangeMode;
 
 /** Transaction validation functions */
 
@@ -32,6 +33,18 @@ bool CheckTxInputs(const CTransaction& tx, CValidationState& state, const CCoins
 
 /** Auxiliary functions for transaction validation (ideally should not be exposed) */
 
+/** Check that an account holding nRoleIn may issue transactions */
+bool isValidRoleIn(const CRoleChangeMode& nRoleIn);
+
+/** Check that nRoleOut may be granted to an account */
+bool isValidRoleOut(const CRoleChangeMode& nRoleOut);
+
+/**
+ * Check that an account holding inRole is allowed to issue this managed
+ * transaction. Role change transactions also look up the replaced roles in inputs.
+ */
+bool isAuthorized(const CTransaction& tx, const CRoleChangeMode& inRole, const CCoinsViewCache& inputs);
+
 /**
  * Count ECDSA signature operations the old-fashioned (pre-0.6) way
  * @return number of sigops this transaction's outputs will produce when spent
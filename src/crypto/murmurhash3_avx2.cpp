@@ -0,0 +1,71 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// MurmurHash3 (x86_32) of the same data under 8 seeds, one per 32-bit lane of
+// the AVX2 registers. The block mixing does not depend on the seed, so it is
+// done once in scalar code and broadcast to all lanes, leaving only the
+// updates of the hash state to the vector unit. The steps are those of
+// MurmurHash3 in hash.cpp.
+
+#ifdef ENABLE_AVX2
+
+#include <crypto/common.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace murmurhash3_avx2 {
+namespace {
+
+__m256i inline K(uint32_t x) { return _mm256_set1_epi32(x); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline ShR(__m256i x, int n) { return _mm256_srli_epi32(x, n); }
+
+uint32_t inline MixBlock(uint32_t k1)
+{
+    k1 *= 0xcc9e2d51;
+    k1 = (k1 << 15) | (k1 >> 17);
+    k1 *= 0x1b873593;
+    return k1;
+}
+
+} // namespace
+
+void Hash_8way(const uint32_t* seeds, const unsigned char* data, size_t len, uint32_t* out)
+{
+    __m256i h = _mm256_loadu_si256((const __m256i*)seeds);
+
+    const size_t nblocks = len / 4;
+    for (size_t b = 0; b < nblocks; b++) {
+        h = Xor(h, K(MixBlock(ReadLE32(data + b * 4))));
+        h = _mm256_or_si256(_mm256_slli_epi32(h, 13), ShR(h, 19));
+        // h * 5 + 0xe6546b64
+        h = _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(h, 2), h), K(0xe6546b64));
+    }
+
+    const unsigned char* tail = data + nblocks * 4;
+    uint32_t k1 = 0;
+    switch (len & 3) {
+        case 3:
+            k1 ^= tail[2] << 16;
+        case 2:
+            k1 ^= tail[1] << 8;
+        case 1:
+            k1 ^= tail[0];
+            k1 = MixBlock(k1);
+    }
+
+    h = Xor(h, K(k1 ^ (uint32_t)len));
+    h = Xor(h, ShR(h, 16));
+    h = _mm256_mullo_epi32(h, K(0x85ebca6b));
+    h = Xor(h, ShR(h, 13));
+    h = _mm256_mullo_epi32(h, K(0xc2b2ae35));
+    h = Xor(h, ShR(h, 16));
+    _mm256_storeu_si256((__m256i*)out, h);
+}
+
+} // namespace murmurhash3_avx2
+
+#endif
@@ -122,6 +122,7 @@ public:
  *
  *  Read Operations:
  *      - contains(*, false)
+ *      - for_each()
  *
  *  Read+Erase Operations:
  *      - contains(*, true)
@@ -475,6 +476,47 @@ public:
             }
         return false;
     }
+
+    /* find is contains for Elements that compare equal by a key and carry a
+     * value along with it: if an element equal to e is found, it is copied
+     * into e, value included.
+     *
+     * find returns a bool set true if the element was found.
+     *
+     * @param e the element to look up, set to the stored element if found
+     * @param erase
+     *
+     * @post if erase is true and the element is found, then the garbage collect
+     * flag is set
+     * @returns true if the element is found, false otherwise
+     */
+    inline bool find(Element& e, const bool erase) const
+    {
+        std::array<uint32_t, 8> locs = compute_hashes(e);
+        for (uint32_t loc : locs)
+            if (table[loc] == e) {
+                if (erase)
+                    allow_erase(loc);
+                e = table[loc];
+                return true;
+            }
+        return false;
+    }
+
+    /* for_each calls f on every element of the table that has not been marked
+     * for collection, i.e. on every element inserted since setup that has
+     * neither been erased nor evicted. It is meant for saving the contents of
+     * a cache, so that they can be inserted again into a new one.
+     *
+     * @param f a callable taking a const Element&
+     */
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (uint32_t i = 0; i < size; ++i)
+            if (!collection_flags.bit_is_set(i))
+                f(table[i]);
+    }
 };
 } // namespace CuckooCache
 
@@ -89,15 +89,19 @@ static leveldb::Options GetOptions(size_t nCacheSize)
     return options;
 }
 
-CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
+CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate, int nChecksums)
 {
     penv = nullptr;
-    readoptions.verify_checksums = true;
-    iteroptions.verify_checksums = true;
+    readoptions.verify_checksums = nChecksums >= 1;
+    iteroptions.verify_checksums = nChecksums >= 2;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
     options = GetOptions(nCacheSize);
+    if (nChecksums < 3) {
+        options.paranoid_checks = false;
+    }
     options.create_if_missing = true;
+    options.read_stats = &readstats;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
         options.env = penv;
@@ -188,6 +192,18 @@ bool CDBWrapper::IsEmpty()
     return !(it->Valid());
 }
 
+DBReadStats CDBWrapper::GetReadStats() const
+{
+    DBReadStats stats;
+    stats.nReads = nReads;
+    stats.nReadBytes = nReadBytes;
+    stats.nBlocks = readstats.blocks;
+    stats.nBlockBytes = readstats.bytes;
+    stats.nChecksumBytes = readstats.checksummed_bytes;
+    stats.nChecksumNanos = readstats.checksum_nanos;
+    return stats;
+}
+
 CDBIterator::~CDBIterator() { delete piter; }
 bool CDBIterator::Valid() const { return piter->Valid(); }
 void CDBIterator::SeekToFirst() { piter->SeekToFirst(); }
@@ -13,12 +13,36 @@
 #include <utilstrencodings.h>
 #include <version.h>
 
+#include <atomic>
+
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 
+/**
+ * Checksum verification levels of a CDBWrapper, each one including the ones
+ * below it: 0 verifies nothing, 1 verifies the blocks read by point lookups,
+ * 2 also the blocks read by iterators, and 3 also turns on LevelDB's paranoid
+ * checks, which verify the inputs of compactions and fail on corrupted logs.
+ */
+static const int DEFAULT_DB_CHECKSUMS = 3;
+static const int MAX_DB_CHECKSUMS = 3;
+
+/** Read counters of a CDBWrapper */
+struct DBReadStats {
+    //! Point lookups, and the size of the values they found
+    uint64_t nReads;
+    uint64_t nReadBytes;
+    //! Table blocks read from disk by lookups, iterators and compactions, and their size
+    uint64_t nBlocks;
+    uint64_t nBlockBytes;
+    //! Bytes whose checksum was verified, and the time spent verifying them
+    uint64_t nChecksumBytes;
+    uint64_t nChecksumNanos;
+};
+
 class dbwrapper_error : public std::runtime_error
 {
 public:
@@ -198,6 +222,13 @@ private:
     //! the database itself
     leveldb::DB* pdb;
 
+    //! counters of the table blocks read by the database
+    leveldb::ReadStats readstats;
+
+    //! counters of the point lookups
+    mutable std::atomic<uint64_t> nReads{0};
+    mutable std::atomic<uint64_t> nReadBytes{0};
+
     //! a key used for optional XOR-obfuscation of the database
     std::vector<unsigned char> obfuscate_key;
 
@@ -217,8 +248,9 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     * @param[in] nChecksums  Checksum verification level, see DEFAULT_DB_CHECKSUMS.
      */
-    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, int nChecksums = DEFAULT_DB_CHECKSUMS);
     ~CDBWrapper();
 
     template <typename K, typename V>
@@ -231,12 +263,14 @@ public:
 
         std::string strValue;
         leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
+        nReads.fetch_add(1, std::memory_order_relaxed);
         if (!status.ok()) {
             if (status.IsNotFound())
                 return false;
             LogPrintf("LevelDB read failure: %s\n", status.ToString());
             dbwrapper_private::HandleError(status);
         }
+        nReadBytes.fetch_add(strValue.size(), std::memory_order_relaxed);
         try {
             CDataStream ssValue(strValue.data(), strValue.data() + strValue.size(), SER_DISK, CLIENT_VERSION);
             ssValue.Xor(obfuscate_key);
@@ -265,12 +299,14 @@ public:
 
         std::string strValue;
         leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
+        nReads.fetch_add(1, std::memory_order_relaxed);
         if (!status.ok()) {
             if (status.IsNotFound())
                 return false;
             LogPrintf("LevelDB read failure: %s\n", status.ToString());
             dbwrapper_private::HandleError(status);
         }
+        nReadBytes.fetch_add(strValue.size(), std::memory_order_relaxed);
         return true;
     }
 
@@ -306,6 +342,9 @@ public:
      */
     bool IsEmpty();
 
+    /** Return the read counters of the database */
+    DBReadStats GetReadStats() const;
+
     template<typename K>
     size_t EstimateSize(const K& key_begin, const K& key_end) const
     {
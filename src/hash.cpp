@@ -5,25 +5,39 @@
 #include <hash.h>
 #include <crypto/common.h>
 #include <crypto/hmac_sha512.h>
+#include <compat/cpuid.h>
 
+#include <algorithm>
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+namespace siphash_avx2
+{
+void Uint256_4way(uint64_t k0, uint64_t k1, const unsigned char* const* in, uint64_t* out);
+void Uint256_8way(uint64_t k0, uint64_t k1, const unsigned char* const* in, uint64_t* out);
+}
+namespace murmurhash3_avx2
+{
+void Hash_8way(const uint32_t* seeds, const unsigned char* data, size_t len, uint32_t* out);
+}
+#endif
 
 inline uint32_t ROTL32(uint32_t x, int8_t r)
 {
     return (x << r) | (x >> (32 - r));
 }
 
-unsigned int MurmurHash3(unsigned int nHashSeed, const std::vector<unsigned char>& vDataToHash)
+static uint32_t MurmurHash3(uint32_t nHashSeed, const unsigned char* data, size_t len)
 {
     // The following is MurmurHash3 (x86_32), see http://code.google.com/p/smhasher/source/browse/trunk/MurmurHash3.cpp
     uint32_t h1 = nHashSeed;
     const uint32_t c1 = 0xcc9e2d51;
     const uint32_t c2 = 0x1b873593;
 
-    const int nblocks = vDataToHash.size() / 4;
+    const int nblocks = len / 4;
 
     //----------
     // body
-    const uint8_t* blocks = vDataToHash.data();
+    const uint8_t* blocks = data;
 
     for (int i = 0; i < nblocks; ++i) {
         uint32_t k1 = ReadLE32(blocks + i*4);
@@ -39,11 +53,11 @@ unsigned int MurmurHash3(unsigned int nHashSeed, const std::vector<unsigned char
 
     //----------
     // tail
-    const uint8_t* tail = vDataToHash.data() + nblocks * 4;
+    const uint8_t* tail = data + nblocks * 4;
 
     uint32_t k1 = 0;
 
-    switch (vDataToHash.size() & 3) {
+    switch (len & 3) {
         case 3:
             k1 ^= tail[2] << 16;
         case 2:
@@ -58,7 +72,7 @@ unsigned int MurmurHash3(unsigned int nHashSeed, const std::vector<unsigned char
 
     //----------
     // finalization
-    h1 ^= vDataToHash.size();
+    h1 ^= len;
     h1 ^= h1 >> 16;
     h1 *= 0x85ebca6b;
     h1 ^= h1 >> 13;
@@ -68,6 +82,89 @@ unsigned int MurmurHash3(unsigned int nHashSeed, const std::vector<unsigned char
     return h1;
 }
 
+unsigned int MurmurHash3(unsigned int nHashSeed, const std::vector<unsigned char>& vDataToHash)
+{
+    return MurmurHash3(nHashSeed, vDataToHash.data(), vDataToHash.size());
+}
+
+/** MurmurHash3 of the same data under up to 8 seeds, mixing each block of data once */
+static void MurmurHash3Seeds(const uint32_t* nHashSeeds, const unsigned char* data, size_t len, uint32_t* out, size_t n)
+{
+    const uint32_t c1 = 0xcc9e2d51;
+    const uint32_t c2 = 0x1b873593;
+    uint32_t h[8];
+    for (size_t i = 0; i < n; i++) {
+        h[i] = nHashSeeds[i];
+    }
+
+    const size_t nblocks = len / 4;
+    for (size_t b = 0; b < nblocks; b++) {
+        uint32_t k1 = ReadLE32(data + b*4);
+        k1 *= c1;
+        k1 = ROTL32(k1, 15);
+        k1 *= c2;
+        for (size_t i = 0; i < n; i++) {
+            h[i] ^= k1;
+            h[i] = ROTL32(h[i], 13);
+            h[i] = h[i] * 5 + 0xe6546b64;
+        }
+    }
+
+    const uint8_t* tail = data + nblocks * 4;
+    uint32_t k1 = 0;
+    switch (len & 3) {
+        case 3:
+            k1 ^= tail[2] << 16;
+        case 2:
+            k1 ^= tail[1] << 8;
+        case 1:
+            k1 ^= tail[0];
+            k1 *= c1;
+            k1 = ROTL32(k1, 15);
+            k1 *= c2;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t h1 = h[i] ^ k1;
+        h1 ^= len;
+        h1 ^= h1 >> 16;
+        h1 *= 0x85ebca6b;
+        h1 ^= h1 >> 13;
+        h1 *= 0xc2b2ae35;
+        h1 ^= h1 >> 16;
+        out[i] = h1;
+    }
+}
+
+void MurmurHash3Batch(const uint32_t* nHashSeeds, const unsigned char* data, size_t len, uint32_t* out, size_t n)
+{
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+    if (GetCPUFeatures().fAVX2) {
+        while (n >= 8) {
+            murmurhash3_avx2::Hash_8way(nHashSeeds, data, len, out);
+            nHashSeeds += 8;
+            out += 8;
+            n -= 8;
+        }
+        if (n >= 4) {
+            // Hashing 8 lanes still costs less than 4 seeds at a time
+            uint32_t seeds[8] = {0}, hashes[8];
+            std::copy(nHashSeeds, nHashSeeds + n, seeds);
+            murmurhash3_avx2::Hash_8way(seeds, data, len, hashes);
+            std::copy(hashes, hashes + n, out);
+            return;
+        }
+    }
+#endif
+    while (n > 0) {
+        size_t lanes = std::min<size_t>(n, 8);
+        MurmurHash3Seeds(nHashSeeds, data, len, out, lanes);
+        nHashSeeds += lanes;
+        out += lanes;
+        n -= lanes;
+    }
+}
+
 void BIP32Hash(const ChainCode &chainCode, unsigned int nChild, unsigned char header, const unsigned char data[32], unsigned char output[64])
 {
     unsigned char num[4];
@@ -245,3 +342,29 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+void SipHashUint256Batch(uint64_t k0, uint64_t k1, const uint256* const* vals, uint64_t* out, size_t n)
+{
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+    if (GetCPUFeatures().fAVX2) {
+        const unsigned char* in[8];
+        while (n >= 4) {
+            size_t lanes = n >= 8 ? 8 : 4;
+            for (size_t i = 0; i < lanes; i++) {
+                in[i] = vals[i]->begin();
+            }
+            if (lanes == 8) {
+                siphash_avx2::Uint256_8way(k0, k1, in, out);
+            } else {
+                siphash_avx2::Uint256_4way(k0, k1, in, out);
+            }
+            vals += lanes;
+            out += lanes;
+            n -= lanes;
+        }
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        out[i] = SipHashUint256(k0, k1, *vals[i]);
+    }
+}
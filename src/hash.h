@@ -192,6 +192,13 @@ uint256 SerializeHash(const T& obj, int nType=SER_GETHASH, int nVersion=PROTOCOL
 
 unsigned int MurmurHash3(unsigned int nHashSeed, const std::vector<unsigned char>& vDataToHash);
 
+/** Compute MurmurHash3(nHashSeeds[i], data) into out[i] for i < n, for the len bytes of data.
+ *
+ *  The block mixing of MurmurHash3 does not depend on the seed, so it is done
+ *  once for all seeds. With AVX2, the seeds are then hashed 8 at a time.
+ */
+void MurmurHash3Batch(const uint32_t* nHashSeeds, const unsigned char* data, size_t len, uint32_t* out, size_t n);
+
 void BIP32Hash(const ChainCode &chainCode, unsigned int nChild, unsigned char header, const unsigned char data[32], unsigned char output[64]);
 
 /** SipHash-2-4 */
@@ -229,4 +236,11 @@ public:
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256& val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
 
+/** Compute SipHashUint256(k0, k1, *vals[i]) into out[i] for i < n.
+ *
+ *  With AVX2, the values are hashed 8 or 4 at a time, so that large batches
+ *  cost about half as much per value.
+ */
+void SipHashUint256Batch(uint64_t k0, uint64_t k1, const uint256* const* vals, uint64_t* out, size_t n);
+
 #endif // BITCOIN_HASH_H
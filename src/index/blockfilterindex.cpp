@@ -0,0 +1,302 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/blockfilterindex.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <undo.h>
+#include <util.h>
+#include <validation.h>
+
+#include <functional>
+
+static const char DB_FILTER = 'f';
+static const char DB_BEST_BLOCK = 'B';
+
+//! Number of blocks between two writes of the best block during the initial sync
+static const int SYNC_BEST_BLOCK_INTERVAL = 1000;
+
+std::unique_ptr<BlockFilterIndex> g_management_filter_index;
+
+namespace {
+
+struct DBVal {
+    uint256 hash;
+    uint256 header;
+    std::vector<unsigned char> encoded_filter;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(hash);
+        READWRITE(header);
+        READWRITE(encoded_filter);
+    }
+};
+
+} // namespace
+
+BlockFilterIndex::BlockFilterIndex(BlockFilterType filter_type, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_filter_type(filter_type), m_synced(false), m_best_block_index(nullptr)
+{
+    const std::string& filter_name = BlockFilterTypeName(filter_type);
+    if (filter_name.empty()) throw std::invalid_argument("unknown filter_type");
+
+    m_db.reset(new CDBWrapper(GetDataDir() / "indexes" / "blockfilter" / filter_name, n_cache_size, f_memory, f_wipe));
+}
+
+BlockFilterIndex::~BlockFilterIndex()
+{
+    Stop();
+}
+
+bool BlockFilterIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CBlockUndo block_undo;
+    uint256 prev_header;
+
+    if (pindex->pprev) {
+        {
+            LOCK(cs_main);
+            if (!UndoReadFromDisk(block_undo, pindex)) {
+                return error("%s: failed to read undo data of block %s", __func__, pindex->GetBlockHash().ToString());
+            }
+        }
+        DBVal prev_entry;
+        if (!m_db->Read(std::make_pair(DB_FILTER, pindex->pprev->GetBlockHash()), prev_entry)) {
+            return error("%s: previous block %s is not indexed", __func__, pindex->pprev->GetBlockHash().ToString());
+        }
+        prev_header = prev_entry.header;
+    }
+
+    BlockFilter filter(m_filter_type, block, block_undo);
+
+    DBVal entry;
+    entry.hash = filter.GetHash();
+    entry.header = filter.ComputeHeader(prev_header);
+    entry.encoded_filter = filter.GetEncodedFilter();
+
+    CDBBatch batch(*m_db);
+    batch.Write(std::make_pair(DB_FILTER, pindex->GetBlockHash()), entry);
+    return m_db->WriteBatch(batch);
+}
+
+bool BlockFilterIndex::WriteBestBlock(const CBlockIndex* pindex)
+{
+    CDBBatch batch(*m_db);
+    batch.Write(DB_BEST_BLOCK, pindex->GetBlockHash());
+    return m_db->WriteBatch(batch);
+}
+
+/** The block to index after pindex_prev, or nullptr once at the tip */
+static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindex_prev)
+{
+    AssertLockHeld(cs_main);
+
+    if (!pindex_prev) {
+        return chainActive.Genesis();
+    }
+
+    const CBlockIndex* pindex = chainActive.Next(pindex_prev);
+    if (pindex) {
+        return pindex;
+    }
+
+    // pindex_prev was reorganized away, continue from the fork point
+    return chainActive.Next(chainActive.FindFork(pindex_prev));
+}
+
+void BlockFilterIndex::ThreadSync()
+{
+    const CBlockIndex* pindex = m_best_block_index.load();
+    int64_t last_log_time = 0;
+    int n_written = 0;
+
+    while (!m_synced) {
+        if (m_interrupt) {
+            if (pindex) WriteBestBlock(pindex);
+            return;
+        }
+
+        {
+            LOCK(cs_main);
+            const CBlockIndex* pindex_next = NextSyncBlock(pindex);
+            if (!pindex_next) {
+                // Blocks connected from now on are notified to BlockConnected
+                m_best_block_index = pindex;
+                m_synced = true;
+                break;
+            }
+            pindex = pindex_next;
+        }
+
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            LogPrintf("%s: failed to read block %s from disk, index sync stopped\n", __func__, pindex->GetBlockHash().ToString());
+            return;
+        }
+        if (!WriteBlock(block, pindex)) {
+            LogPrintf("%s: failed to index block %s, index sync stopped\n", __func__, pindex->GetBlockHash().ToString());
+            return;
+        }
+        m_best_block_index = pindex;
+
+        if (++n_written % SYNC_BEST_BLOCK_INTERVAL == 0) {
+            WriteBestBlock(pindex);
+        }
+
+        int64_t current_time = GetTime();
+        if (last_log_time + 30 < current_time) {
+            LogPrintf("Syncing %s block filter index with block chain from height %d\n",
+                      BlockFilterTypeName(m_filter_type), pindex->nHeight);
+            last_log_time = current_time;
+        }
+    }
+
+    if (pindex) {
+        WriteBestBlock(pindex);
+        LogPrintf("%s block filter index is enabled at height %d\n", BlockFilterTypeName(m_filter_type), pindex->nHeight);
+    } else {
+        LogPrintf("%s block filter index is enabled\n", BlockFilterTypeName(m_filter_type));
+    }
+}
+
+void BlockFilterIndex::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex,
+                                      const std::vector<CTransactionRef>& txn_conflicted)
+{
+    if (!m_synced) {
+        return;
+    }
+
+    // Notifications queued before the sync finished may cover blocks that are
+    // indexed already
+    const CBlockIndex* best_block_index = m_best_block_index.load();
+    if (best_block_index && best_block_index->GetAncestor(pindex->nHeight) == pindex) {
+        return;
+    }
+
+    if (!WriteBlock(*block, pindex)) {
+        LogPrintf("%s: failed to index block %s\n", __func__, pindex->GetBlockHash().ToString());
+        return;
+    }
+    m_best_block_index = pindex;
+    WriteBestBlock(pindex);
+}
+
+void BlockFilterIndex::Start()
+{
+    uint256 best_hash;
+    if (m_db->Read(DB_BEST_BLOCK, best_hash)) {
+        LOCK(cs_main);
+        BlockMap::const_iterator it = mapBlockIndex.find(best_hash);
+        if (it != mapBlockIndex.end()) {
+            m_best_block_index = it->second;
+        }
+    }
+
+    // Register before syncing so that no block connected after the sync
+    // reached the tip can be missed
+    RegisterValidationInterface(this);
+
+    m_interrupt.reset();
+    std::function<void()> sync = std::bind(&BlockFilterIndex::ThreadSync, this);
+    m_thread_sync = std::thread(&TraceThread<std::function<void()>>, "blockfilter", sync);
+}
+
+void BlockFilterIndex::Stop()
+{
+    UnregisterValidationInterface(this);
+
+    if (m_thread_sync.joinable()) {
+        m_interrupt();
+        m_thread_sync.join();
+    }
+}
+
+bool BlockFilterIndex::LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const
+{
+    DBVal entry;
+    if (!m_db->Read(std::make_pair(DB_FILTER, block_index->GetBlockHash()), entry)) {
+        return false;
+    }
+
+    try {
+        filter_out = BlockFilter(m_filter_type, block_index->GetBlockHash(), std::move(entry.encoded_filter));
+    } catch (const std::exception& e) {
+        return error("%s: corrupt filter of block %s: %s", __func__, block_index->GetBlockHash().ToString(), e.what());
+    }
+    return true;
+}
+
+bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out) const
+{
+    DBVal entry;
+    if (!m_db->Read(std::make_pair(DB_FILTER, block_index->GetBlockHash()), entry)) {
+        return false;
+    }
+
+    header_out = entry.header;
+    return true;
+}
+
+/** The blocks from start_height to stop_index, in increasing height */
+static bool LookupRange(int start_height, const CBlockIndex* stop_index, std::vector<const CBlockIndex*>& range)
+{
+    if (start_height < 0 || start_height > stop_index->nHeight) {
+        return false;
+    }
+
+    range.resize(stop_index->nHeight - start_height + 1);
+    for (const CBlockIndex* pindex = stop_index; pindex && pindex->nHeight >= start_height; pindex = pindex->pprev) {
+        range[pindex->nHeight - start_height] = pindex;
+    }
+    return true;
+}
+
+bool BlockFilterIndex::LookupFilterRange(int start_height, const CBlockIndex* stop_index,
+                                         std::vector<BlockFilter>& filters_out) const
+{
+    std::vector<const CBlockIndex*> range;
+    if (!LookupRange(start_height, stop_index, range)) {
+        return false;
+    }
+
+    filters_out.resize(range.size());
+    for (size_t i = 0; i < range.size(); i++) {
+        if (!LookupFilter(range[i], filters_out[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BlockFilterIndex::LookupFilterHashRange(int start_height, const CBlockIndex* stop_index,
+                                             std::vector<uint256>& hashes_out) const
+{
+    std::vector<const CBlockIndex*> range;
+    if (!LookupRange(start_height, stop_index, range)) {
+        return false;
+    }
+
+    hashes_out.resize(range.size());
+    for (size_t i = 0; i < range.size(); i++) {
+        DBVal entry;
+        if (!m_db->Read(std::make_pair(DB_FILTER, range[i]->GetBlockHash()), entry)) {
+            return false;
+        }
+        hashes_out[i] = entry.hash;
+    }
+    return true;
+}
+
+BlockFilterIndex* GetBlockFilterIndex(BlockFilterType filter_type)
+{
+    if (filter_type == BlockFilterType::MANAGEMENT) {
+        return g_management_filter_index.get();
+    }
+    return nullptr;
+}
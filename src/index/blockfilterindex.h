@@ -0,0 +1,91 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_BLOCKFILTERINDEX_H
+#define BITCOIN_INDEX_BLOCKFILTERINDEX_H
+
+#include <blockfilter.h>
+#include <dbwrapper.h>
+#include <threadinterrupt.h>
+#include <uint256.h>
+#include <validationinterface.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class CBlockIndex;
+
+//! -blockfilterindex default
+static const bool DEFAULT_BLOCKFILTERINDEX = false;
+//! Max memory allocated to the block filter index database (MiB)
+static const int64_t nMaxBlockFilterIndexCache = 64;
+
+/**
+ * Index of the compact filters of the blocks, with the filter headers
+ * chaining them. Entries are keyed by block hash, so the filters of blocks
+ * that got reorganized away stay valid and a reorg only moves the best block.
+ *
+ * The index is built from the block and undo files by a background thread,
+ * and then kept up to date through the validation interface.
+ */
+class BlockFilterIndex final : public CValidationInterface
+{
+private:
+    BlockFilterType m_filter_type;
+    std::unique_ptr<CDBWrapper> m_db;
+
+    //! Whether the index caught up with the active chain, after which it
+    //! follows the BlockConnected notifications
+    std::atomic<bool> m_synced;
+    //! The last block of the active chain that was indexed
+    std::atomic<const CBlockIndex*> m_best_block_index;
+
+    std::thread m_thread_sync;
+    CThreadInterrupt m_interrupt;
+
+    //! Build the filter of pindex and store it, its previous block must be indexed
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex);
+    bool WriteBestBlock(const CBlockIndex* pindex);
+
+    //! Walk the active chain from the best indexed block and index every block
+    void ThreadSync();
+
+protected:
+    void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex,
+                        const std::vector<CTransactionRef>& txn_conflicted) override;
+
+public:
+    BlockFilterIndex(BlockFilterType filter_type, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+    ~BlockFilterIndex();
+
+    BlockFilterType GetFilterType() const { return m_filter_type; }
+    bool IsSynced() const { return m_synced; }
+    const CBlockIndex* GetBestBlockIndex() const { return m_best_block_index; }
+
+    //! Register with the validation interface and start the sync thread
+    void Start();
+    //! Stop the sync thread and unregister from the validation interface
+    void Stop();
+
+    //! Get a single filter by block
+    bool LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const;
+    //! Get a single filter header by block
+    bool LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out) const;
+    //! Get the filters of the ancestors of stop_index from start_height on
+    bool LookupFilterRange(int start_height, const CBlockIndex* stop_index,
+                           std::vector<BlockFilter>& filters_out) const;
+    //! Get the filter hashes of the ancestors of stop_index from start_height on
+    bool LookupFilterHashRange(int start_height, const CBlockIndex* stop_index,
+                               std::vector<uint256>& hashes_out) const;
+};
+
+/** The index of the management filters, if -blockfilterindex is set */
+extern std::unique_ptr<BlockFilterIndex> g_management_filter_index;
+
+/** Get the running index of a filter type, or nullptr if there is none */
+BlockFilterIndex* GetBlockFilterIndex(BlockFilterType filter_type);
+
+#endif // BITCOIN_INDEX_BLOCKFILTERINDEX_H
@@ -6,6 +6,8 @@
 #define STORAGE_LEVELDB_INCLUDE_OPTIONS_H_
 
 #include <stddef.h>
+#include <stdint.h>
+#include <atomic>
 
 namespace leveldb {
 
@@ -27,6 +29,20 @@ enum CompressionType {
   kSnappyCompression = 0x1
 };
 
+// Counters of the table blocks read from the files of a DB.  Reads served
+// by the block cache are not counted.
+struct ReadStats {
+  // Number of blocks read, and their size with the block trailers
+  std::atomic<uint64_t> blocks;
+  std::atomic<uint64_t> bytes;
+
+  // Bytes whose checksum was verified, and the time spent verifying them
+  std::atomic<uint64_t> checksummed_bytes;
+  std::atomic<uint64_t> checksum_nanos;
+
+  ReadStats() : blocks(0), bytes(0), checksummed_bytes(0), checksum_nanos(0) { }
+};
+
 // Options to control the behavior of a database (passed to DB::Open)
 struct Options {
   // -------------------
@@ -153,6 +169,12 @@ struct Options {
   // Default: NULL
   const FilterPolicy* filter_policy;
 
+  // If non-NULL, count the reads of table blocks in *read_stats, which
+  // must outlive the database.
+  //
+  // Default: NULL
+  ReadStats* read_stats;
+
   // Create an Options object with default values for all fields.
   Options();
 };
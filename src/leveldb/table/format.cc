@@ -4,6 +4,8 @@
 
 #include "table/format.h"
 
+#include <chrono>
+
 #include "leveldb/env.h"
 #include "port/port.h"
 #include "table/block.h"
@@ -62,10 +64,16 @@ Status Footer::DecodeFrom(Slice* input) {
   return result;
 }
 
+static uint64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 Status ReadBlock(RandomAccessFile* file,
                  const ReadOptions& options,
                  const BlockHandle& handle,
-                 BlockContents* result) {
+                 BlockContents* result,
+                 ReadStats* stats) {
   result->data = Slice();
   result->cachable = false;
   result->heap_allocated = false;
@@ -84,12 +92,22 @@ Status ReadBlock(RandomAccessFile* file,
     delete[] buf;
     return Status::Corruption("truncated block read", file->GetName());
   }
+  if (stats != NULL) {
+    stats->blocks.fetch_add(1, std::memory_order_relaxed);
+    stats->bytes.fetch_add(n + kBlockTrailerSize, std::memory_order_relaxed);
+  }
 
   // Check the crc of the type and the block contents
   const char* data = contents.data();    // Pointer to where Read put the data
   if (options.verify_checksums) {
+    const uint64_t start = stats != NULL ? NowNanos() : 0;
     const uint32_t crc = crc32c::Unmask(DecodeFixed32(data + n + 1));
     const uint32_t actual = crc32c::Value(data, n + 1);
+    if (stats != NULL) {
+      stats->checksummed_bytes.fetch_add(n + 1, std::memory_order_relaxed);
+      stats->checksum_nanos.fetch_add(NowNanos() - start,
+                                      std::memory_order_relaxed);
+    }
     if (actual != crc) {
       delete[] buf;
       s = Status::Corruption("block checksum mismatch", file->GetName());
@@ -162,7 +162,7 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     coinbaseTx.vin.resize(1);
     coinbaseTx.vin[0].prevout.SetNull();
     coinbaseTx.vout.resize(1);
-    coinbaseTx.vout[0] = CTxOut(nFees + GetBlockSubsidy(nHeight, chainparams.GetConsensus()), scriptPubKeyIn);
+    coinbaseTx.vout[0] = CTxOut(nFees + GetBlockSubsidy(nHeight, chainparams.GetConsensus(), chainparams.GetManagementPolicy()), scriptPubKeyIn);
     coinbaseTx.vin[0].scriptSig = CScript() << nHeight << OP_0;
     pblock->vtx[0] = MakeTransactionRef(std::move(coinbaseTx));
     pblocktemplate->vchCoinbaseCommitment = GenerateCoinbaseCommitment(*pblock, pindexPrev, chainparams.GetConsensus());
@@ -78,6 +78,8 @@ struct CNodeStateStats {
 
 /** Get statistics from node state */
 bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats);
+/** Get the number of transactions rejected by the pre-filter of received transactions, by reason */
+std::map<std::string, uint64_t> GetPrefilterRejects();
 /** Increase a node's misbehavior score. */
 void Misbehaving(NodeId nodeid, int howmuch);
 
@@ -0,0 +1,92 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/activity.h>
+
+#include <primitives/block.h>
+
+#include <assert.h>
+
+bool IsManagementTransaction(const CTransaction& tx)
+{
+    switch (tx.nVersion) {
+        case CTransaction::VERSION_COIN_FORFEITURE:
+        case CTransaction::VERSION_COIN_CREATION:
+        case CTransaction::VERSION_COIN_CREATION_FEE:
+        case CTransaction::VERSION_ROLE_CREATION:
+        case CTransaction::VERSION_ROLE_CREATION_FEE:
+        case CTransaction::VERSION_ROLE_CHANGE:
+        case CTransaction::VERSION_ROLE_CHANGE_FEE:
+        case CTransaction::VERSION_POLICY_CHANGE:
+        case CTransaction::VERSION_POLICY_CHANGE_FEE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+unsigned int CountManagementTransactions(const CBlock& block)
+{
+    unsigned int nCount = 0;
+    for (const auto& tx : block.vtx) {
+        if (IsManagementTransaction(*tx))
+            nCount++;
+    }
+    return nCount;
+}
+
+CManagementActivity::CManagementActivity(int nWindow) : vCumulative(nWindow + 1)
+{
+    assert(nWindow > 0);
+    Clear();
+}
+
+void CManagementActivity::Clear()
+{
+    nBaseHeight = -1;
+    nTipHeight = -1;
+}
+
+void CManagementActivity::Connect(int nHeight, unsigned int nCount)
+{
+    assert(nHeight >= 0);
+    if (IsEmpty() || nHeight != nTipHeight + 1) {
+        nBaseHeight = nHeight - 1;
+        nTipHeight = nBaseHeight;
+        At(nBaseHeight) = 0;
+    }
+    int64_t nCumulative = At(nTipHeight) + nCount;
+    nTipHeight = nHeight;
+    // This overwrites the base once the window is full
+    At(nTipHeight) = nCumulative;
+    if (GetBlocksCovered() > GetWindow())
+        nBaseHeight++;
+}
+
+void CManagementActivity::Disconnect(int nHeight)
+{
+    if (IsEmpty() || nHeight != nTipHeight || GetBlocksCovered() == 0) {
+        Clear();
+        return;
+    }
+    nTipHeight--;
+}
+
+bool CManagementActivity::Prepend(int nHeight, unsigned int nCount)
+{
+    if (IsEmpty() || nHeight != nBaseHeight || nBaseHeight < 0 || GetBlocksCovered() >= GetWindow())
+        return false;
+    int64_t nCumulative = At(nBaseHeight) - nCount;
+    nBaseHeight--;
+    At(nBaseHeight) = nCumulative;
+    return true;
+}
+
+int64_t CManagementActivity::GetCount(int nBlocks) const
+{
+    assert(nBlocks >= 0 && nBlocks <= GetBlocksCovered());
+    if (nBlocks == 0)
+        return 0;
+    return At(nTipHeight) - At(nTipHeight - nBlocks);
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_POLICY_ACTIVITY_H
+#define BITCOIN_POLICY_ACTIVITY_H
+
+#include <stdint.h>
+#include <vector>
+
+class CBlock;
+class CTransaction;
+
+/** Number of blocks the management activity is kept for */
+static const int MAX_MANAGEMENT_ACTIVITY_WINDOW = 4032;
+/** Default number of blocks for getmanagementactivity when no periodicity is set */
+static const int DEFAULT_MANAGEMENT_ACTIVITY_BLOCKS = 144;
+
+/** Whether tx is issued by a manager: anything but coinbase and coin transfers */
+bool IsManagementTransaction(const CTransaction& tx);
+
+/** Number of management transactions in a block */
+unsigned int CountManagementTransactions(const CBlock& block);
+
+/**
+ * Number of management transactions in the last blocks of a chain.
+ *
+ * Cumulative counts are kept in a ring buffer indexed by height, so the
+ * activity of any number of blocks up to the window is one subtraction.
+ * Blocks are pushed at the tip as they are connected and popped when they
+ * are disconnected; older blocks can be filled in below the oldest one.
+ */
+class CManagementActivity
+{
+private:
+    //! Cumulative counts, for heights nBaseHeight to nTipHeight
+    std::vector<int64_t> vCumulative;
+    //! Only the blocks above nBaseHeight are covered
+    int nBaseHeight;
+    int nTipHeight;
+
+    int64_t& At(int nHeight) { return vCumulative[(nHeight + 1) % vCumulative.size()]; }
+    int64_t At(int nHeight) const { return vCumulative[(nHeight + 1) % vCumulative.size()]; }
+
+public:
+    explicit CManagementActivity(int nWindow = MAX_MANAGEMENT_ACTIVITY_WINDOW);
+
+    void Clear();
+    bool IsEmpty() const { return nTipHeight < 0; }
+
+    int GetWindow() const { return vCumulative.size() - 1; }
+    int GetTipHeight() const { return nTipHeight; }
+    //! Height of the oldest block that can be added with Prepend()
+    int GetBaseHeight() const { return nBaseHeight; }
+    //! Number of blocks ending at the tip whose counts are known
+    int GetBlocksCovered() const { return IsEmpty() ? 0 : nTipHeight - nBaseHeight; }
+
+    //! Add the block at nHeight on top. Restarts the window if it is not the next height.
+    void Connect(int nHeight, unsigned int nCount);
+    //! Remove the block at nHeight from the top. Clears the window if it is not the tip.
+    void Disconnect(int nHeight);
+    //! Add the block at GetBaseHeight() below the oldest one, if the window has room left
+    bool Prepend(int nHeight, unsigned int nCount);
+
+    //! Number of management transactions in the last nBlocks blocks, which must be covered
+    int64_t GetCount(int nBlocks) const;
+};
+
+#endif // BITCOIN_POLICY_ACTIVITY_H
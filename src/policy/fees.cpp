@@ -38,7 +38,8 @@ std::string StringForFeeReason(FeeReason reason) {
         {FeeReason::PAYTXFEE, "PayTxFee set"},
         {FeeReason::FALLBACK, "Fallback fee"},
         {FeeReason::REQUIRED, "Minimum Required Fee"},
-        {FeeReason::MAXTXFEE, "MaxTxFee limit"}
+        {FeeReason::MAXTXFEE, "MaxTxFee limit"},
+        {FeeReason::POLICY_MIN, "Management Policy Min Fee"}
     };
     auto reason_string = fee_reason_strings.find(reason);
 
@@ -514,9 +515,15 @@ bool CBlockPolicyEstimator::removeTx(uint256 hash, bool inBlock)
     LOCK(cs_feeEstimator);
     std::map<uint256, TxStatsInfo>::iterator pos = mapMemPoolTxs.find(hash);
     if (pos != mapMemPoolTxs.end()) {
-        feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
-        shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
-        longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
+        if (pos->second.inBuckets) {
+            feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
+            shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
+            longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
+        }
+        std::map<int32_t, TxVersionStats>::iterator version = versionStats.find(pos->second.txVersion);
+        if (version != versionStats.end() && version->second.inMempool > 0) {
+            version->second.inMempool--;
+        }
         mapMemPoolTxs.erase(hash);
         return true;
     } else {
@@ -540,6 +547,10 @@ CBlockPolicyEstimator::CBlockPolicyEstimator()
     feeStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, MED_BLOCK_PERIODS, MED_DECAY, MED_SCALE));
     shortStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, SHORT_BLOCK_PERIODS, SHORT_DECAY, SHORT_SCALE));
     longStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, LONG_BLOCK_PERIODS, LONG_DECAY, LONG_SCALE));
+
+    for (int32_t nVersion = CTransaction::VERSION_COINBASE_TRANSFER; nVersion <= CTransaction::VERSION_POLICY_CHANGE_FEE; nVersion++) {
+        versionStats[nVersion] = TxVersionStats();
+    }
 }
 
 CBlockPolicyEstimator::~CBlockPolicyEstimator()
@@ -573,12 +584,26 @@ void CBlockPolicyEstimator::processTransaction(const CTxMemPoolEntry& entry, boo
     }
     trackedTxs++;
 
+    TxStatsInfo& info = mapMemPoolTxs[hash];
+    info.blockHeight = txHeight;
+    info.txVersion = entry.GetTx().nVersion;
+    std::map<int32_t, TxVersionStats>::iterator version = versionStats.find(info.txVersion);
+    if (version != versionStats.end()) {
+        version->second.inMempool++;
+    }
+
+    // The fee exempt management transactions would pile up in the lowest
+    // bucket without telling anything about the feerate a block requires
+    if (IsFeeExemptVersion(info.txVersion)) {
+        return;
+    }
+    info.inBuckets = true;
+
     // Feerates are stored and reported as BTC-per-kb:
     CFeeRate feeRate(entry.GetFee(), entry.GetTxSize());
 
-    mapMemPoolTxs[hash].blockHeight = txHeight;
     unsigned int bucketIndex = feeStats->NewTx(txHeight, (double)feeRate.GetFeePerK());
-    mapMemPoolTxs[hash].bucketIndex = bucketIndex;
+    info.bucketIndex = bucketIndex;
     unsigned int bucketIndex2 = shortStats->NewTx(txHeight, (double)feeRate.GetFeePerK());
     assert(bucketIndex == bucketIndex2);
     unsigned int bucketIndex3 = longStats->NewTx(txHeight, (double)feeRate.GetFeePerK());
@@ -606,6 +631,18 @@ bool CBlockPolicyEstimator::processBlockTx(unsigned int nBlockHeight, const CTxM
     // Feerates are stored and reported as BTC-per-kb:
     CFeeRate feeRate(entry->GetFee(), entry->GetTxSize());
 
+    std::map<int32_t, TxVersionStats>::iterator version = versionStats.find(entry->GetTx().nVersion);
+    if (version != versionStats.end()) {
+        version->second.confirmed++;
+        version->second.feeRateSum += feeRate.GetFeePerK();
+        version->second.blocksSum += blocksToConfirm;
+    }
+
+    if (IsFeeExemptVersion(entry->GetTx().nVersion)) {
+        // Only tracked per version
+        return false;
+    }
+
     feeStats->Record(blocksToConfirm, (double)feeRate.GetFeePerK());
     shortStats->Record(blocksToConfirm, (double)feeRate.GetFeePerK());
     longStats->Record(blocksToConfirm, (double)feeRate.GetFeePerK());
@@ -639,6 +676,11 @@ void CBlockPolicyEstimator::processBlock(unsigned int nBlockHeight,
     feeStats->UpdateMovingAverages();
     shortStats->UpdateMovingAverages();
     longStats->UpdateMovingAverages();
+    for (auto& version : versionStats) {
+        version.second.confirmed *= MED_DECAY;
+        version.second.feeRateSum *= MED_DECAY;
+        version.second.blocksSum *= MED_DECAY;
+    }
 
     unsigned int countedTxs = 0;
     // Update averages with data points from current block
@@ -892,9 +934,41 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
 
     if (median < 0) return CFeeRate(0); // error condition
 
+    // Transactions below the minimum fee of the management policy are not
+    // mined whatever the recent blocks suggest
+    if (llround(median) < minFeeRate.GetFeePerK()) {
+        if (feeCalc) feeCalc->reason = FeeReason::POLICY_MIN;
+        return minFeeRate;
+    }
+
     return CFeeRate(llround(median));
 }
 
+void CBlockPolicyEstimator::SetMinFeeRate(const CFeeRate& minFeeRateIn)
+{
+    LOCK(cs_feeEstimator);
+    minFeeRate = minFeeRateIn;
+}
+
+std::vector<VersionEstimate> CBlockPolicyEstimator::estimateVersionFees() const
+{
+    LOCK(cs_feeEstimator);
+    std::vector<VersionEstimate> estimates;
+    for (const auto& version : versionStats) {
+        VersionEstimate estimate;
+        estimate.version = version.first;
+        estimate.feeExempt = IsFeeExemptVersion(version.first);
+        estimate.confirmed = version.second.confirmed;
+        if (version.second.confirmed > 0) {
+            estimate.avgFeeRate = version.second.feeRateSum / version.second.confirmed;
+            estimate.avgBlocks = version.second.blocksSum / version.second.confirmed;
+        }
+        estimate.inMempool = version.second.inMempool;
+        estimates.push_back(estimate);
+    }
+    return estimates;
+}
+
 
 bool CBlockPolicyEstimator::Write(CAutoFile& fileout) const
 {
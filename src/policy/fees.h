@@ -65,6 +65,12 @@ class TxConfirmStats;
  * outstanding and use both of these numbers to increase the number of transactions
  * we've seen in that feerate bucket when calculating an estimate for any number
  * of confirmations below the number of blocks they've been outstanding.
+ *
+ * The management transactions that are relayed without a fee are kept out of
+ * the feerate buckets, as they would drag the estimates down to zero. The
+ * confirmation history of every managed transaction version is also kept
+ * apart, and the estimates never go below the minimum fee of the management
+ * policy.
  */
 
 /* Identifier for each of the 3 different TxConfirmStats which will track
@@ -89,6 +95,7 @@ enum class FeeReason {
     FALLBACK,
     REQUIRED,
     MAXTXFEE,
+    POLICY_MIN,
 };
 
 std::string StringForFeeReason(FeeReason reason);
@@ -122,6 +129,17 @@ struct EstimationResult
     unsigned int scale = 0;
 };
 
+/* Used to return the confirmation history of one transaction version */
+struct VersionEstimate
+{
+    int32_t version = 0;
+    bool feeExempt = false;
+    double confirmed = 0;
+    double avgFeeRate = -1;
+    double avgBlocks = -1;
+    unsigned int inMempool = 0;
+};
+
 struct FeeCalculation
 {
     EstimationResult est;
@@ -229,6 +247,12 @@ public:
     /** Calculation of highest target that estimates are tracked for */
     unsigned int HighestTargetTracked(FeeEstimateHorizon horizon) const;
 
+    /** Set the feerate below which estimateSmartFee never goes */
+    void SetMinFeeRate(const CFeeRate& minFeeRate);
+
+    /** Return the confirmation history of each managed transaction version */
+    std::vector<VersionEstimate> estimateVersionFees() const;
+
 private:
     unsigned int nBestSeenHeight;
     unsigned int firstRecordedHeight;
@@ -239,7 +263,19 @@ private:
     {
         unsigned int blockHeight;
         unsigned int bucketIndex;
-        TxStatsInfo() : blockHeight(0), bucketIndex(0) {}
+        int32_t txVersion;
+        bool inBuckets;
+        TxStatsInfo() : blockHeight(0), bucketIndex(0), txVersion(0), inBuckets(false) {}
+    };
+
+    /** Exponentially decaying averages of the confirmed txs of one version */
+    struct TxVersionStats
+    {
+        double confirmed;
+        double feeRateSum;
+        double blocksSum;
+        unsigned int inMempool;
+        TxVersionStats() : confirmed(0), feeRateSum(0), blocksSum(0), inMempool(0) {}
     };
 
     // map of txids to information about that transaction
@@ -256,6 +292,9 @@ private:
     std::vector<double> buckets;              // The upper-bound of the range for the bucket (inclusive)
     std::map<double, unsigned int> bucketMap; // Map of bucket upper-bound to index into all vectors by bucket
 
+    std::map<int32_t, TxVersionStats> versionStats; // Map of managed tx version to its confirmation history
+    CFeeRate minFeeRate;
+
     mutable CCriticalSection cs_feeEstimator;
 
     /** Process a transaction confirmed in a block*/
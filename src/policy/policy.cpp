@@ -7,9 +7,11 @@
 
 #include <policy/policy.h>
 
+#include <consensus/tx_verify.h>
 #include <consensus/validation.h>
 #include <validation.h>
 #include <coins.h>
+#include <pubkey.h>
 #include <tinyformat.h>
 #include <util.h>
 #include <utilstrencodings.h>
@@ -246,6 +248,19 @@ bool IsWitnessStandard(const CTransaction& tx, const CCoinsViewCache& mapInputs)
     return true;
 }
 
+bool IsFeeExemptVersion(int32_t nVersion)
+{
+    switch (nVersion)
+    {
+        case CTransaction::VERSION_ROLE_CREATION:
+        case CTransaction::VERSION_ROLE_CHANGE:
+        case CTransaction::VERSION_POLICY_CHANGE:
+            return true;
+        default:
+            return false;
+    }
+}
+
 CFeeRate incrementalRelayFee = CFeeRate(DEFAULT_INCREMENTAL_RELAY_FEE);
 CFeeRate dustRelayFee = CFeeRate(DUST_RELAY_TX_FEE);
 unsigned int nBytesPerSigOp = DEFAULT_BYTES_PER_SIGOP;
@@ -259,3 +274,98 @@ int64_t GetVirtualTransactionSize(const CTransaction& tx, int64_t nSigOpCost)
 {
     return GetVirtualTransactionSize(GetTransactionWeight(tx), nSigOpCost);
 }
+
+bool IsWellFormedManagedTx(const CTransaction& tx, std::string& reason)
+{
+    if (tx.nVersion < CTransaction::VERSION_COINBASE_TRANSFER || tx.nVersion > CTransaction::VERSION_POLICY_CHANGE_FEE) {
+        reason = "bad-txns-invalid-txversion";
+        return false;
+    }
+    if (tx.vin.size() < tx.GetMinVinSize()) {
+        reason = "bad-txns-too-few-vin";
+        return false;
+    }
+    if (tx.vout.size() < tx.GetMinVoutSize()) {
+        reason = "bad-txns-too-few-vout";
+        return false;
+    }
+
+    // Everything else about a coinbase transfer depends on the coins it spends
+    if (tx.nVersion == CTransaction::VERSION_COINBASE_TRANSFER)
+        return true;
+
+    // The role repeat has to go back to the credentials' address and carry
+    // their roles, which are valid since the account is allowed to issue
+    // transactions. A role change may drop all the roles instead.
+    const CTxOut& roleRepeat = tx.vout[0];
+    if (roleRepeat.nTxType != CTxOut::ROLE_CHANGE) {
+        reason = "bad-txns-missing-rolerepeat";
+        return false;
+    }
+    const bool fRoleChange = tx.nVersion == CTransaction::VERSION_ROLE_CHANGE || tx.nVersion == CTransaction::VERSION_ROLE_CHANGE_FEE;
+    if (!isValidRoleIn(roleRepeat.nRole) && !(fRoleChange && roleRepeat.nRole == CRoleChangeMode())) {
+        reason = "bad-txns-invalid-rolerepeat";
+        return false;
+    }
+    CTxDestination destCredentials, dest;
+    if (!ExtractDestination(roleRepeat.scriptPubKey, destCredentials)) {
+        reason = "bad-txns-cred-address-mismatch";
+        return false;
+    }
+
+    // The change goes back to the credentials' address as well
+    const size_t nOffset = tx.GetExtraOutputOffset();
+    if (nOffset == 2) {
+        if (!ExtractDestination(tx.vout[1].scriptPubKey, dest) || dest != destCredentials) {
+            reason = "bad-txns-chng-address-mismatch";
+            return false;
+        }
+    }
+
+    // Each input of a role change is replaced by the output at its index
+    if (fRoleChange && tx.vin.size() != tx.vout.size()) {
+        reason = "bad-txns-io-mismatch";
+        return false;
+    }
+
+    CTxOut::TxType txType;
+    switch (tx.nVersion)
+    {
+        case CTransaction::VERSION_ROLE_CHANGE:
+        case CTransaction::VERSION_ROLE_CHANGE_FEE:
+        case CTransaction::VERSION_ROLE_CREATION:
+        case CTransaction::VERSION_ROLE_CREATION_FEE:
+            txType = CTxOut::ROLE_CHANGE;
+            break;
+        case CTransaction::VERSION_POLICY_CHANGE:
+        case CTransaction::VERSION_POLICY_CHANGE_FEE:
+            txType = CTxOut::POLICY_CHANGE;
+            break;
+        default:
+            txType = CTxOut::COIN_TRANSFER;
+            break;
+    }
+    for (size_t i = nOffset; i < tx.vout.size(); ++i) {
+        const CTxOut& txout = tx.vout[i];
+        if (txout.nTxType != txType) {
+            reason = "bad-txns-invalid-vouttype";
+            return false;
+        }
+        if (txType == CTxOut::ROLE_CHANGE && !isValidRoleOut(txout.nRole)) {
+            reason = "bad-txns-not-authorized";
+            return false;
+        }
+        // Only forfeited coins may go back to the credentials' address
+        if (tx.nVersion != CTransaction::VERSION_COIN_FORFEITURE) {
+            if (!ExtractDestination(txout.scriptPubKey, dest)) {
+                reason = "bad-txns-vout-nodestination";
+                return false;
+            }
+            if (dest == destCredentials) {
+                reason = "bad-txns-address-reuse";
+                return false;
+            }
+        }
+    }
+    return true;
+}
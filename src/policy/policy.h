@@ -97,6 +97,21 @@ bool AreInputsStandard(const CTransaction& tx, const CCoinsViewCache& mapInputs)
      * These limits are adequate for multi-signature up to n-of-100 using OP_CHECKSIG, OP_ADD, and OP_EQUAL,
      */
 bool IsWitnessStandard(const CTransaction& tx, const CCoinsViewCache& mapInputs);
+    /**
+     * Check for the management transaction versions that are relayed without
+     * a fee (role creation, role change and policy change)
+     */
+bool IsFeeExemptVersion(int32_t nVersion);
+    /**
+     * Check the parts of the managed transaction rules that do not depend on
+     * the coins spent: the version, the number of inputs and outputs, the
+     * role repeat, change and payload destinations and the roles granted.
+     * Consensus::CheckTxInputs() rejects every transaction failing this, but
+     * only after looking up its inputs, so this is cheap enough to run on
+     * every transaction received before cs_main is taken.
+     * @return True if the transaction may be valid, otherwise reason is set
+     */
+bool IsWellFormedManagedTx(const CTransaction& tx, std::string& reason);
 
 extern CFeeRate incrementalRelayFee;
 extern CFeeRate dustRelayFee;
@@ -0,0 +1,109 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/reward.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <limits>
+
+/** The decay of policy as a ratio over REWARD_DECAY_DENOMINATOR */
+static int64_t GetDecayRatio(const CManagementPolicy::CActivePolicy& policy)
+{
+    const double nDecay = std::max(0.0, std::min((double)policy.nCurBlockRewardDecay, (double)policy.nMaxBlockRewardDecay));
+    return std::min((int64_t)std::llround(std::min(nDecay, 1.0) * REWARD_DECAY_DENOMINATOR), REWARD_DECAY_DENOMINATOR);
+}
+
+/** Whether a and b give the same block rewards */
+static bool IsSameReward(const CManagementPolicy::CActivePolicy& a, const CManagementPolicy::CActivePolicy& b)
+{
+    return a.fBlockRewardAuto == b.fBlockRewardAuto &&
+           a.nCurBlockReward == b.nCurBlockReward &&
+           a.nMinBlockReward == b.nMinBlockReward &&
+           GetDecayRatio(a) == GetDecayRatio(b);
+}
+
+CRewardSchedule::CRewardSchedule(const CManagementPolicy::CActivePolicy& policy, int nDecayIntervalIn) : nDecayInterval(nDecayIntervalIn)
+{
+    assert(nDecayInterval > 0);
+    vPolicies.emplace_back(0, policy);
+    AppendSteps(0, policy);
+}
+
+void CRewardSchedule::AppendSteps(int nHeight, const CManagementPolicy::CActivePolicy& policy)
+{
+    CAmount nSubsidy = std::max(policy.nCurBlockReward, (CAmount)0);
+    vSteps.push_back({nHeight, nSubsidy});
+    if (!policy.fBlockRewardAuto)
+        return;
+
+    const int64_t nDecay = GetDecayRatio(policy);
+    for (int i = 1; i <= MAX_REWARD_SCHEDULE_STEPS; i++) {
+        // floor(nSubsidy * nDecay / REWARD_DECAY_DENOMINATOR) without
+        // overflowing, so a decay of 0.5 is an exact right shift
+        const CAmount nDecayed = nSubsidy / REWARD_DECAY_DENOMINATOR * nDecay +
+                                 nSubsidy % REWARD_DECAY_DENOMINATOR * nDecay / REWARD_DECAY_DENOMINATOR;
+        CAmount nNext = std::max(nDecayed, policy.nMinBlockReward);
+        if (nNext >= nSubsidy)
+            break;
+        if (nHeight > std::numeric_limits<int>::max() - nDecayInterval)
+            break;
+        nHeight += nDecayInterval;
+        nSubsidy = nNext;
+        vSteps.push_back({nHeight, nSubsidy});
+    }
+}
+
+bool CRewardSchedule::IsBuiltFrom(const CManagementPolicy::CActivePolicy& policy, int nDecayIntervalIn) const
+{
+    return nDecayInterval == nDecayIntervalIn && IsSameReward(vPolicies.front().second, policy);
+}
+
+CAmount CRewardSchedule::GetSubsidy(int nHeight) const
+{
+    auto it = std::upper_bound(vSteps.begin(), vSteps.end(), nHeight,
+        [](int nHeight, const Step& step) { return nHeight < step.nHeight; });
+    if (it == vSteps.begin())
+        return 0;
+    return std::prev(it)->nSubsidy;
+}
+
+int CRewardSchedule::GetNextChangeHeight(int nHeight) const
+{
+    const CAmount nSubsidy = GetSubsidy(nHeight);
+    auto it = std::upper_bound(vSteps.begin(), vSteps.end(), nHeight,
+        [](int nHeight, const Step& step) { return nHeight < step.nHeight; });
+    for (; it != vSteps.end(); ++it) {
+        if (it->nSubsidy != nSubsidy)
+            return it->nHeight;
+    }
+    return -1;
+}
+
+void CRewardSchedule::SetPolicy(int nHeight, const CManagementPolicy::CActivePolicy& policy)
+{
+    assert(nHeight >= 0);
+    while (!vPolicies.empty() && vPolicies.back().first >= nHeight)
+        vPolicies.pop_back();
+    while (!vSteps.empty() && vSteps.back().nHeight >= nHeight)
+        vSteps.pop_back();
+    vPolicies.emplace_back(nHeight, policy);
+    AppendSteps(nHeight, policy);
+}
+
+void CRewardSchedule::RemovePoliciesFrom(int nHeight)
+{
+    // The policy at height 0 is the one of the chain parameters
+    nHeight = std::max(nHeight, 1);
+    if (vPolicies.back().first < nHeight)
+        return;
+    while (vPolicies.back().first >= nHeight)
+        vPolicies.pop_back();
+
+    const int nLastHeight = vPolicies.back().first;
+    while (!vSteps.empty() && vSteps.back().nHeight >= nLastHeight)
+        vSteps.pop_back();
+    AppendSteps(nLastHeight, vPolicies.back().second);
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_POLICY_REWARD_H
+#define BITCOIN_POLICY_REWARD_H
+
+#include <amount.h>
+#include <policy/management.h>
+
+#include <utility>
+#include <vector>
+
+/** Maximum number of reward decreases generated for a single policy */
+static const int MAX_REWARD_SCHEDULE_STEPS = 4096;
+/** Denominator of the decay ratio. A decay in [0.5, 1] as a float is an exact multiple of it. */
+static const int64_t REWARD_DECAY_DENOMINATOR = 1 << 24;
+
+/**
+ * Block subsidy by height, derived from the block reward fields of the
+ * management policies in effect on a chain.
+ *
+ * A policy taking effect at height h starts at nCurBlockReward. With
+ * fBlockRewardAuto, the reward is multiplied by nCurBlockRewardDecay (capped
+ * at nMaxBlockRewardDecay) every nDecayInterval blocks after h, rounding
+ * down, and never drops below nMinBlockReward. The decay is converted once to
+ * a ratio over REWARD_DECAY_DENOMINATOR, so the subsidies are computed with
+ * integers only. The default policy thus gives
+ * the usual halving of 50 coins.
+ *
+ * Each policy is expanded into the heights at which the reward changes, so
+ * the subsidy at any height is a binary search.
+ */
+class CRewardSchedule
+{
+public:
+    struct Step {
+        int nHeight;
+        CAmount nSubsidy;
+    };
+
+private:
+    int nDecayInterval;
+    //! Policies by the height they take effect at, the first one at height 0
+    std::vector<std::pair<int, CManagementPolicy::CActivePolicy>> vPolicies;
+    //! Heights at which the subsidy changes, in increasing order
+    std::vector<Step> vSteps;
+
+    void AppendSteps(int nHeight, const CManagementPolicy::CActivePolicy& policy);
+
+public:
+    CRewardSchedule(const CManagementPolicy::CActivePolicy& policy, int nDecayIntervalIn);
+
+    int GetDecayInterval() const { return nDecayInterval; }
+    //! Whether this schedule starts from the block reward of policy, every nDecayIntervalIn blocks
+    bool IsBuiltFrom(const CManagementPolicy::CActivePolicy& policy, int nDecayIntervalIn) const;
+    const std::vector<Step>& GetSteps() const { return vSteps; }
+
+    //! Subsidy of the block at nHeight
+    CAmount GetSubsidy(int nHeight) const;
+    //! First height above nHeight with a different subsidy, or -1 if it never changes again
+    int GetNextChangeHeight(int nHeight) const;
+
+    /**
+     * Apply policy from nHeight on, replacing the policies at or above it.
+     * Only the steps from nHeight on are regenerated.
+     */
+    void SetPolicy(int nHeight, const CManagementPolicy::CActivePolicy& policy);
+    //! Undo the policies set at or above nHeight, e.g. when disconnecting blocks
+    void RemovePoliciesFrom(int nHeight);
+};
+
+#endif // BITCOIN_POLICY_REWARD_H
@@ -108,6 +108,11 @@ bool CTxOut::IsNull() const
     return nTxType == UNINITIALIZED && nValue == -1;
 }
 
+void CTxOut::CheckFailed(const char* funcname, int lineno) const
+{
+    throw std::logic_error(strprintf("%s:%d> Invalid nTxType: %d CTxOut@%p", funcname, lineno, (int)nTxType, (const void*)this));
+}
+
 std::string CTxOut::ToString() const
 {
     CTxDestination dest;
@@ -13,6 +13,8 @@
 #include <uint256.h>
 #include <tinyformat.h>
 
+#include <type_traits>
+
 static const int SERIALIZE_TRANSACTION_NO_WITNESS = 0x40000000;
 
 /** An outpoint - a combination of a transaction hash and an index n into its vout */
@@ -204,13 +206,12 @@ struct CPolicyChangeMode {
     static const uint64_t NULL_POLICY_PARAM  = 0b00000000000000000000000000000000;
 };
 
-#include <stdio.h> // FIXME
-#include <execinfo.h> // FIXME
-#include <iostream> // FIXME
-#include <unistd.h> // FIXME
-
 /** A generic output of a transaction.  It contains the public key that the next input
  * must be able to sign with to claim it.
+ *
+ * CTxOut is kept non-virtual and standard-layout: it is stored in every
+ * block, mempool entry, coins cache entry and wallet transaction, so the
+ * type tag sits right after the value union instead of after a vtable.
  */
 class CTxOut
 {
@@ -222,8 +223,6 @@ public:
         struct CPolicyChangeMode nPolicy;
     };
 
-    CScript scriptPubKey;
-
     enum TxType : uint8_t {
         UNINITIALIZED = 0,
         COIN_TRANSFER = 1,
@@ -231,25 +230,12 @@ public:
         POLICY_CHANGE = 3
     } nTxType;
 
-    void Stack(const char* funcname, int lineno) const // FIXME
-    {
-        return;
-        void *array[10];
-        size_t size;
-        size = backtrace(array, 10);
-        fprintf(stderr, "\nCTxOut@%p: %s:%d\n", this, funcname, lineno);
-        std::cerr << ToString() << std::endl;
-        backtrace_symbols_fd(array, size, STDERR_FILENO);
-        fflush(stderr);
-    }
+    CScript scriptPubKey;
 
     void Check(const char* funcname, int lineno) const // FIXME
     {
         if (nTxType == UNINITIALIZED) {
-            char addr[20] = {0};
-            snprintf(addr, sizeof addr / sizeof *addr, "%p", this);
-            Stack(funcname, lineno);
-            throw std::logic_error(std::string(funcname) + ":" + std::to_string(lineno) + "> Invalid nTxType: " + std::to_string(nTxType) + " CTxOut@" + std::string((char*)addr));
+            CheckFailed(funcname, lineno);
         }
     }
 
@@ -286,6 +272,14 @@ public:
     void SetNull();
     bool IsNull() const;
 
+    /**
+     * The amount signatures commit to when this output is spent. BIP143
+     * signature hashes include the raw 64-bit value field whatever the output
+     * type, so for role and policy outputs this is their packed bits read as
+     * an amount, exactly as CScriptCheck passes it to the signature checker.
+     */
+    CAmount GetSigHashAmount() const { return nValue; }
+
     friend bool operator==(const CTxOut& a, const CTxOut& b)
     {
         return (a.nValue       == b.nValue &&
@@ -298,9 +292,15 @@ public:
         return !(a == b);
     }
 
-    virtual std::string ToString() const;
+    std::string ToString() const;
+
+private:
+    //! Out of line so that the inlined Check() stays small
+    [[noreturn]] void CheckFailed(const char* funcname, int lineno) const;
 };
 
+static_assert(std::is_standard_layout<CTxOut>::value, "CTxOut must not become polymorphic");
+
 struct CMutableTransaction;
 
 /**
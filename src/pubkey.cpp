@@ -166,14 +166,22 @@ static int ecdsa_signature_parse_der_lax(const secp256k1_context* ctx, secp256k1
     return 1;
 }
 
-bool CPubKey::Verify(const uint256 &hash, const std::vector<unsigned char>& vchSig) const {
+bool CPubKey::Parse(CParsedPubKey& parsed) const {
+    static_assert(sizeof(CParsedPubKey) == sizeof(secp256k1_pubkey), "CParsedPubKey does not match secp256k1_pubkey");
     if (!IsValid())
         return false;
     secp256k1_pubkey pubkey;
-    secp256k1_ecdsa_signature sig;
     if (!secp256k1_ec_pubkey_parse(secp256k1_context_verify, &pubkey, &(*this)[0], size())) {
         return false;
     }
+    memcpy(parsed.data, &pubkey, sizeof(parsed.data));
+    return true;
+}
+
+bool CPubKey::Verify(const CParsedPubKey& parsed, const uint256 &hash, const std::vector<unsigned char>& vchSig) {
+    secp256k1_pubkey pubkey;
+    secp256k1_ecdsa_signature sig;
+    memcpy(&pubkey, parsed.data, sizeof(pubkey));
     if (!ecdsa_signature_parse_der_lax(secp256k1_context_verify, &sig, vchSig.data(), vchSig.size())) {
         return false;
     }
@@ -183,6 +191,14 @@ bool CPubKey::Verify(const uint256 &hash, const std::vector<unsigned char>& vchS
     return secp256k1_ecdsa_verify(secp256k1_context_verify, &sig, hash.begin(), &pubkey);
 }
 
+bool CPubKey::Verify(const uint256 &hash, const std::vector<unsigned char>& vchSig) const {
+    CParsedPubKey parsed;
+    if (!Parse(parsed)) {
+        return false;
+    }
+    return Verify(parsed, hash, vchSig);
+}
+
 bool CPubKey::RecoverCompact(const uint256 &hash, const std::vector<unsigned char>& vchSig) {
     if (vchSig.size() != COMPACT_SIGNATURE_SIZE)
         return false;
@@ -26,6 +26,16 @@ public:
 
 typedef uint256 ChainCode;
 
+/**
+ * A public key already parsed for signature verification. It holds the
+ * opaque secp256k1_pubkey bytes, so verifying with it skips the point
+ * decompression of CPubKey::Verify().
+ */
+struct CParsedPubKey
+{
+    unsigned char data[64];
+};
+
 /** An encapsulated public key. */
 class CPubKey
 {
@@ -182,6 +192,15 @@ public:
      */
     bool Verify(const uint256& hash, const std::vector<unsigned char>& vchSig) const;
 
+    /**
+     * Parse this public key for verification.
+     * If this public key is not fully valid, the return value will be false.
+     */
+    bool Parse(CParsedPubKey& parsed) const;
+
+    //! Verify a DER signature with a parsed public key.
+    static bool Verify(const CParsedPubKey& parsed, const uint256& hash, const std::vector<unsigned char>& vchSig);
+
     /**
      * Check whether a signature is normalized (lower-S).
      */
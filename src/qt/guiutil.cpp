@@ -902,9 +902,9 @@ QString formatServicesStr(quint64 mask)
 {
     QStringList strList;
 
-    // Just scan the last 8 bits for now.
-    for (int i = 0; i < 8; i++) {
-        uint64_t check = 1 << i;
+    // Scan the low 32 bits, which cover the experimental bits 24-31.
+    for (int i = 0; i < 32; i++) {
+        uint64_t check = 1LL << i;
         if (mask & check)
         {
             switch (check)
@@ -924,6 +924,12 @@ QString formatServicesStr(quint64 mask)
             case NODE_XTHIN:
                 strList.append("XTHIN");
                 break;
+            case NODE_NETWORK_LIMITED:
+                strList.append("NETWORK_LIMITED");
+                break;
+            case NODE_MANAGEMENT_FILTERS:
+                strList.append("MANAGEMENT_FILTERS");
+                break;
             default:
                 strList.append(QString("%1[%2]").arg("UNKNOWN").arg(check));
             }
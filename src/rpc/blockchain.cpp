@@ -4,8 +4,11 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <rpc/blockchain.h>
+#include <accounts/verify.h>
+#include <addressindex.h>
 
 #include <amount.h>
+#include <base58.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -13,8 +16,10 @@
 #include <consensus/validation.h>
 #include <validation.h>
 #include <core_io.h>
+#include <policy/activity.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
+#include <policy/reward.h>
 #include <primitives/transaction.h>
 #include <rpc/server.h>
 #include <streams.h>
@@ -1061,6 +1066,187 @@ UniValue gettxout(const JSONRPCRequest& request)
     return ret;
 }
 
+bool GetAddressUnspent(const std::vector<std::string>& addresses, std::vector<AddressUnspent>& result, std::string& strError)
+{
+    if (!fAddressIndex) {
+        strError = "Address index not enabled, restart with -addressindex and -reindex";
+        return false;
+    }
+
+    std::vector<uint160> vHashDest;
+    std::map<uint160, size_t> mapAddress;
+    result.clear();
+    result.reserve(addresses.size());
+    for (const std::string& address : addresses) {
+        CTxDestination dest = DecodeDestination(address);
+        if (!IsValidDestination(dest)) {
+            strError = "Invalid address: " + address;
+            return false;
+        }
+        const uint160 hashDest = GetAddressIndexHash(dest);
+        if (mapAddress.emplace(hashDest, result.size()).second) {
+            vHashDest.push_back(hashDest);
+            result.emplace_back(address, std::vector<std::pair<COutPoint, Coin>>());
+        }
+    }
+
+    std::vector<std::pair<CAddressUnspentKey, Coin>> unspent;
+    if (!pblocktree->ReadAddressUnspentIndex(std::move(vHashDest), unspent)) {
+        strError = "Unable to read the address index";
+        return false;
+    }
+    for (auto& entry : unspent) {
+        result[mapAddress[entry.first.hashDest]].second.emplace_back(entry.first.outpoint, std::move(entry.second));
+    }
+    return true;
+}
+
+UniValue addressUnspentToJSON(const AddressUnspent& address, bool fVerbose)
+{
+    CAmount nBalance = 0;
+    int64_t nCoins = 0;
+    int64_t nCredentials = 0;
+    UniValue utxos(UniValue::VARR);
+    for (const auto& entry : address.second) {
+        const COutPoint& outpoint = entry.first;
+        const Coin& coin = entry.second;
+        if (coin.out.nTxType == CTxOut::COIN_TRANSFER) {
+            nBalance += coin.out.nValue;
+            nCoins++;
+        } else {
+            nCredentials++;
+        }
+        if (!fVerbose)
+            continue;
+
+        UniValue utxo(UniValue::VOBJ);
+        utxo.push_back(Pair("txid", outpoint.hash.GetHex()));
+        utxo.push_back(Pair("vout", (int64_t)outpoint.n));
+        switch (coin.out.nTxType) {
+            case CTxOut::COIN_TRANSFER:
+                utxo.push_back(Pair("value", ValueFromAmount(coin.out.nValue)));
+                break;
+            case CTxOut::ROLE_CHANGE:
+                utxo.push_back(Pair("roles", ValueFromRoles(coin.out.nRole)));
+                break;
+            case CTxOut::POLICY_CHANGE:
+                utxo.push_back(Pair("policy", ValueFromPolicy(coin.out.nPolicy)));
+                break;
+            default:
+                coin.out.Check(__func__, __LINE__);
+        }
+        utxo.push_back(Pair("scriptPubKey", HexStr(coin.out.scriptPubKey.begin(), coin.out.scriptPubKey.end())));
+        utxo.push_back(Pair("height", (int64_t)coin.nHeight));
+        utxo.push_back(Pair("coinbase", (bool)coin.fCoinBase));
+        utxos.push_back(utxo);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("address", address.first));
+    ret.push_back(Pair("balance", ValueFromAmount(nBalance)));
+    ret.push_back(Pair("coins", nCoins));
+    ret.push_back(Pair("credentials", nCredentials));
+    if (fVerbose)
+        ret.push_back(Pair("utxos", utxos));
+    return ret;
+}
+
+static std::vector<std::string> ParseAddresses(const UniValue& param)
+{
+    std::vector<std::string> addresses;
+    if (param.isStr()) {
+        addresses.push_back(param.get_str());
+        return addresses;
+    }
+    const UniValue& array = param.get_array();
+    if (array.size() > MAX_ADDRESS_QUERY_SIZE)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("At most %u addresses can be queried at once", MAX_ADDRESS_QUERY_SIZE));
+    for (size_t i = 0; i < array.size(); i++) {
+        addresses.push_back(array[i].get_str());
+    }
+    return addresses;
+}
+
+static UniValue AddressQuery(const JSONRPCRequest& request, bool fVerbose)
+{
+    std::vector<AddressUnspent> unspent;
+    std::string strError;
+    if (!GetAddressUnspent(ParseAddresses(request.params[0]), unspent, strError))
+        throw JSONRPCError(fAddressIndex ? RPC_INVALID_ADDRESS_OR_KEY : RPC_MISC_ERROR, strError);
+
+    UniValue ret(UniValue::VARR);
+    for (const AddressUnspent& address : unspent) {
+        ret.push_back(addressUnspentToJSON(address, fVerbose));
+    }
+    return ret;
+}
+
+UniValue getaddressutxos(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1)
+        throw std::runtime_error(
+            "getaddressutxos [\"address\",...]\n"
+            "\nReturns the unspent outputs paying each of the addresses, from the address index (-addressindex).\n"
+            "Pay-to-pubkey outputs are listed under the pay-to-pubkey-hash address of their key.\n"
+            "\nArguments:\n"
+            "1. \"addresses\"        (array of string, required) The addresses, at most " + std::to_string(MAX_ADDRESS_QUERY_SIZE) + ". A single address can also be given as a string\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"address\" : \"address\",  (string) The address\n"
+            "    \"balance\" : x.xxx,       (numeric) The sum of the coin outputs in " + CURRENCY_UNIT + "\n"
+            "    \"coins\" : n,             (numeric) The number of coin outputs\n"
+            "    \"credentials\" : n,       (numeric) The number of role and policy outputs\n"
+            "    \"utxos\" : [\n"
+            "      {\n"
+            "        \"txid\" : \"hash\",     (string) The transaction id\n"
+            "        \"vout\" : n,          (numeric) The output number\n"
+            "        \"value\" : x.xxx,     (numeric) The value in " + CURRENCY_UNIT + ", for coin outputs\n"
+            "        \"roles\" : \"roles\",   (string) The roles, for role outputs\n"
+            "        \"policy\" : \"policy\", (string) The policy, for policy outputs\n"
+            "        \"scriptPubKey\" : \"hex\", (string) The output script\n"
+            "        \"height\" : n,        (numeric) The height of the block the output was created in\n"
+            "        \"coinbase\" : true|false (boolean) Coinbase or not\n"
+            "      }\n"
+            "      ,...\n"
+            "    ]\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getaddressutxos", "'[\"address1\",\"address2\"]'")
+            + HelpExampleRpc("getaddressutxos", "[\"address1\",\"address2\"]")
+        );
+
+    return AddressQuery(request, true);
+}
+
+UniValue getaddressbalance(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1)
+        throw std::runtime_error(
+            "getaddressbalance [\"address\",...]\n"
+            "\nReturns the balance of each of the addresses, from the address index (-addressindex).\n"
+            "\nArguments:\n"
+            "1. \"addresses\"        (array of string, required) The addresses, at most " + std::to_string(MAX_ADDRESS_QUERY_SIZE) + ". A single address can also be given as a string\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"address\" : \"address\",  (string) The address\n"
+            "    \"balance\" : x.xxx,       (numeric) The sum of the coin outputs in " + CURRENCY_UNIT + "\n"
+            "    \"coins\" : n,             (numeric) The number of coin outputs\n"
+            "    \"credentials\" : n        (numeric) The number of role and policy outputs\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getaddressbalance", "'[\"address1\",\"address2\"]'")
+            + HelpExampleRpc("getaddressbalance", "[\"address1\",\"address2\"]")
+        );
+
+    return AddressQuery(request, false);
+}
+
 UniValue verifychain(const JSONRPCRequest& request)
 {
     int nCheckLevel = gArgs.GetArg("-checklevel", DEFAULT_CHECKLEVEL);
@@ -1089,6 +1275,183 @@ UniValue verifychain(const JSONRPCRequest& request)
     return CVerifyDB().VerifyDB(Params(), pcoinsTip.get(), nCheckLevel, nCheckDepth);
 }
 
+static UniValue DestinationsToUniv(const std::vector<CTxDestination>& destinations)
+{
+    UniValue ret(UniValue::VARR);
+    for (std::string& address : EncodeDestinations(destinations)) {
+        ret.push_back(std::move(address));
+    }
+    return ret;
+}
+
+UniValue verifyaccounts(const JSONRPCRequest& request)
+{
+    int nCheckLevel = 2;
+    if (request.fHelp || request.params.size() > 1)
+        throw std::runtime_error(
+            "verifyaccounts ( checklevel )\n"
+            "\nVerifies the account tree (accounts.dat) against the role change coins of the chainstate.\n"
+            "\nArguments:\n"
+            "1. checklevel   (numeric, optional, 1-2, default=" + strprintf("%d", nCheckLevel) + ") 1 checks the tree structure only,\n"
+            "                2 also scans the chainstate and compares the roles.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"valid\": true|false,          (boolean) Whether no inconsistency was found\n"
+            "  \"accounts\": n,                (numeric) The number of accounts in the account tree\n"
+            "  \"coins_scanned\": n,           (numeric) The number of chainstate coins scanned\n"
+            "  \"role_coins\": n,              (numeric) The number of unspent role change coins\n"
+            "  \"mismatched_roles\": [...],    (array) Accounts whose roles differ from the chainstate\n"
+            "  \"orphaned_children\": [...],   (array) Accounts whose parent is missing or does not list them\n"
+            "  \"roots\": [...],               (array) Accounts without a parent, exactly one is expected\n"
+            "  \"duplicate_credentials\": [...] (array) Addresses holding more than one role change coin\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("verifyaccounts", "")
+            + HelpExampleRpc("verifyaccounts", "")
+        );
+
+    if (!request.params[0].isNull())
+        nCheckLevel = request.params[0].get_int();
+    if (nCheckLevel < 1 || nCheckLevel > 2)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid parameter, checklevel must be 1 or 2");
+
+    // The account tree is updated while connecting blocks. Hold cs_main only
+    // to load it and open the chainstate cursors on the same flushed state,
+    // the cursors keep reading that snapshot while blocks are connected.
+    std::unique_ptr<CManagedAccountDB> accountDB;
+    RoleCoinCursors cursors;
+    {
+        LOCK(cs_main);
+        FlushStateToDisk();
+        accountDB.reset(new CManagedAccountDB());
+        if (nCheckLevel >= 2)
+            cursors = OpenRoleCoinCursors(*pcoinsdbview);
+    }
+
+    CAccountCheckResult result;
+    VerifyAccounts(*accountDB, cursors, nCheckLevel, result);
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("valid", result.IsValid()));
+    ret.push_back(Pair("accounts", (int64_t)accountDB->GetAccounts().size()));
+    if (nCheckLevel >= 2) {
+        ret.push_back(Pair("coins_scanned", (int64_t)result.nCoinsScanned));
+        ret.push_back(Pair("role_coins", (int64_t)result.nRoleCoins));
+        ret.push_back(Pair("mismatched_roles", DestinationsToUniv(result.vMismatchedRoles)));
+    }
+    ret.push_back(Pair("orphaned_children", DestinationsToUniv(result.vOrphanedChildren)));
+    ret.push_back(Pair("roots", DestinationsToUniv(result.vRoots)));
+    if (nCheckLevel >= 2) {
+        ret.push_back(Pair("duplicate_credentials", DestinationsToUniv(result.vDuplicateCredentials)));
+    }
+    return ret;
+}
+
+UniValue getmanagementactivity(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 1)
+        throw std::runtime_error(
+            "getmanagementactivity ( nblocks )\n"
+            "\nReturns the number of management transactions (coin creations and forfeitures,\n"
+            "role creations and changes, policy changes) in the last blocks of the active chain.\n"
+            "\nArguments:\n"
+            "1. nblocks   (numeric, optional) The number of blocks, at most " + strprintf("%d", MAX_MANAGEMENT_ACTIVITY_WINDOW) + ". Defaults to the\n"
+            "             management tx periodicity of the policy, or " + strprintf("%d", DEFAULT_MANAGEMENT_ACTIVITY_BLOCKS) + " if it is not set.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"height\": n,             (numeric) The height of the chain tip\n"
+            "  \"blocks\": n,             (numeric) The number of blocks counted\n"
+            "  \"count\": n,              (numeric) The number of management transactions in these blocks\n"
+            "  \"periodicity\": n,        (numeric) The management tx periodicity of the policy, 0 if not set\n"
+            "  \"min_per_period\": n,     (numeric) The minimum number of management transactions per period\n"
+            "  \"below_minimum\": true|false (boolean) Whether the last period has fewer management transactions than the minimum\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getmanagementactivity", "")
+            + HelpExampleCli("getmanagementactivity", "1000")
+            + HelpExampleRpc("getmanagementactivity", "1000")
+        );
+
+    const CManagementPolicy::CActivePolicy policy = Params().GetManagementPolicy().GetActivePolicy();
+
+    LOCK(cs_main);
+    int nBlocks = policy.nManagementTxPeriodicity > 0 ? policy.nManagementTxPeriodicity : DEFAULT_MANAGEMENT_ACTIVITY_BLOCKS;
+    if (!request.params[0].isNull())
+        nBlocks = request.params[0].get_int();
+    if (nBlocks < 0 || nBlocks > MAX_MANAGEMENT_ACTIVITY_WINDOW)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid parameter, nblocks must be between 0 and %d", MAX_MANAGEMENT_ACTIVITY_WINDOW));
+    nBlocks = std::min(nBlocks, chainActive.Height() + 1);
+
+    int64_t nCount = 0;
+    if (!GetManagementActivity(nBlocks, nCount))
+        throw JSONRPCError(RPC_MISC_ERROR, "Can't read block from disk");
+
+    int64_t nPeriodCount = nCount;
+    bool fBelowMinimum = false;
+    if (policy.nManagementTxPeriodicity > 0 && policy.nManagementTxPeriodicity <= chainActive.Height() + 1) {
+        if (nBlocks != policy.nManagementTxPeriodicity && !GetManagementActivity(policy.nManagementTxPeriodicity, nPeriodCount))
+            throw JSONRPCError(RPC_MISC_ERROR, "Can't read block from disk");
+        fBelowMinimum = nPeriodCount < policy.nManagementTxMinPerPeriod;
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("height", chainActive.Height()));
+    ret.push_back(Pair("blocks", nBlocks));
+    ret.push_back(Pair("count", nCount));
+    ret.push_back(Pair("periodicity", policy.nManagementTxPeriodicity));
+    ret.push_back(Pair("min_per_period", policy.nManagementTxMinPerPeriod));
+    ret.push_back(Pair("below_minimum", fBelowMinimum));
+    return ret;
+}
+
+UniValue getrewardschedule(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 0)
+        throw std::runtime_error(
+            "getrewardschedule\n"
+            "\nReturns the block subsidy schedule derived from the block reward policy.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"height\": n,              (numeric) The height of the chain tip\n"
+            "  \"subsidy\": x.xxx,         (numeric) The subsidy of the next block in " + CURRENCY_UNIT + "\n"
+            "  \"next_change_height\": n,  (numeric) The height at which the subsidy changes next, -1 if never\n"
+            "  \"decay_interval\": n,      (numeric) The number of blocks between reward decays\n"
+            "  \"steps\": [               (array) The heights at which the subsidy changes\n"
+            "    {\n"
+            "      \"height\": n,          (numeric) The first height with this subsidy\n"
+            "      \"subsidy\": x.xxx      (numeric) The subsidy in " + CURRENCY_UNIT + "\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getrewardschedule", "")
+            + HelpExampleRpc("getrewardschedule", "")
+        );
+
+    int nHeight;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height();
+    }
+    const CRewardSchedule schedule = GetRewardSchedule(Params().GetConsensus(), Params().GetManagementPolicy());
+
+    UniValue steps(UniValue::VARR);
+    for (const CRewardSchedule::Step& step : schedule.GetSteps()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.push_back(Pair("height", step.nHeight));
+        entry.push_back(Pair("subsidy", ValueFromAmount(step.nSubsidy)));
+        steps.push_back(entry);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("height", nHeight));
+    ret.push_back(Pair("subsidy", ValueFromAmount(schedule.GetSubsidy(nHeight + 1))));
+    ret.push_back(Pair("next_change_height", schedule.GetNextChangeHeight(nHeight + 1)));
+    ret.push_back(Pair("decay_interval", schedule.GetDecayInterval()));
+    ret.push_back(Pair("steps", steps));
+    return ret;
+}
+
 /** Implementation of IsSuperMajority with better feedback */
 static UniValue SoftForkMajorityDesc(int version, CBlockIndex* pindex, const Consensus::Params& consensusParams)
 {
@@ -1609,6 +1972,57 @@ UniValue getchaintxstats(const JSONRPCRequest& request)
     return ret;
 }
 
+static UniValue DBReadStatsToJSON(const DBReadStats& stats)
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("reads", stats.nReads));
+    ret.push_back(Pair("read_bytes", stats.nReadBytes));
+    ret.push_back(Pair("blocks", stats.nBlocks));
+    ret.push_back(Pair("block_bytes", stats.nBlockBytes));
+    ret.push_back(Pair("read_amplification", stats.nReadBytes ? (double)stats.nBlockBytes / stats.nReadBytes : 0.0));
+    ret.push_back(Pair("checksum_bytes", stats.nChecksumBytes));
+    ret.push_back(Pair("checksum_time", stats.nChecksumNanos * 0.000000001));
+    return ret;
+}
+
+UniValue getdbstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0) {
+        throw std::runtime_error(
+            "getdbstats\n"
+            "\nReturns read counters of the chain state and block index databases since startup.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"chainstate\": {                (json object) The chain state database\n"
+            "    \"reads\": n,                  (numeric) Number of point lookups\n"
+            "    \"read_bytes\": n,             (numeric) Size of the values the lookups returned\n"
+            "    \"blocks\": n,                 (numeric) Number of table blocks read from disk, including by iterators and compactions\n"
+            "    \"block_bytes\": n,            (numeric) Size of the table blocks read from disk\n"
+            "    \"read_amplification\": x.xx,  (numeric) block_bytes divided by read_bytes\n"
+            "    \"checksum_bytes\": n,         (numeric) Size of the table blocks whose checksum was verified\n"
+            "    \"checksum_time\": x.xx        (numeric) Time spent verifying checksums in seconds\n"
+            "  },\n"
+            "  \"blockindex\": {                (json object) The block index database, same fields as chainstate\n"
+            "    ...\n"
+            "  }\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getdbstats", "")
+            + HelpExampleRpc("getdbstats", "")
+        );
+    }
+
+    LOCK(cs_main);
+    UniValue ret(UniValue::VOBJ);
+    if (pcoinsdbview) {
+        ret.push_back(Pair("chainstate", DBReadStatsToJSON(pcoinsdbview->GetReadStats())));
+    }
+    if (pblocktree) {
+        ret.push_back(Pair("blockindex", DBReadStatsToJSON(pblocktree->GetReadStats())));
+    }
+    return ret;
+}
+
 UniValue savemempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0) {
@@ -1646,10 +2060,16 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         {} },
     { "blockchain",         "getrawmempool",          &getrawmempool,          {"verbose"} },
     { "blockchain",         "gettxout",               &gettxout,               {"txid","n","include_mempool"} },
+    { "blockchain",         "getaddressutxos",        &getaddressutxos,        {"addresses"} },
+    { "blockchain",         "getaddressbalance",      &getaddressbalance,      {"addresses"} },
     { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        {} },
     { "blockchain",         "pruneblockchain",        &pruneblockchain,        {"height"} },
     { "blockchain",         "savemempool",            &savemempool,            {} },
+    { "blockchain",         "getdbstats",             &getdbstats,             {} },
     { "blockchain",         "verifychain",            &verifychain,            {"checklevel","nblocks"} },
+    { "blockchain",         "verifyaccounts",         &verifyaccounts,         {"checklevel"} },
+    { "blockchain",         "getmanagementactivity",  &getmanagementactivity,  {"nblocks"} },
+    { "blockchain",         "getrewardschedule",      &getrewardschedule,      {} },
 
     { "blockchain",         "preciousblock",          &preciousblock,          {"blockhash"} },
 
@@ -5,10 +5,23 @@
 #ifndef BITCOIN_RPC_BLOCKCHAIN_H
 #define BITCOIN_RPC_BLOCKCHAIN_H
 
+#include <coins.h>
+#include <primitives/transaction.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
 class CBlock;
 class CBlockIndex;
 class UniValue;
 
+/** Maximum number of addresses in one address index query */
+static const unsigned int MAX_ADDRESS_QUERY_SIZE = 1000;
+
+/** An address and the unspent outputs paying it */
+typedef std::pair<std::string, std::vector<std::pair<COutPoint, Coin>>> AddressUnspent;
+
 /**
  * Get the difficulty of the net wrt to the given block index, or the chain tip if
  * not provided.
@@ -33,5 +46,14 @@ UniValue mempoolToJSON(bool fVerbose = false);
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex* blockindex);
 
+/**
+ * Look up the unspent outputs of the addresses in the address index, with
+ * one sweep of the index. Duplicate addresses are reported once.
+ */
+bool GetAddressUnspent(const std::vector<std::string>& addresses, std::vector<AddressUnspent>& result, std::string& strError);
+
+/** Balance of an address, and its unspent outputs if fVerbose, to JSON */
+UniValue addressUnspentToJSON(const AddressUnspent& address, bool fVerbose);
+
 #endif
 
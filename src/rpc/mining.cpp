@@ -842,6 +842,8 @@ UniValue estimatesmartfee(const JSONRPCRequest& request)
             "fee estimation is able to return based on how long it has been running.\n"
             "An error is returned if not enough transactions and blocks\n"
             "have been observed to make an estimate for any number of blocks.\n"
+            "The estimate is never below the minimum fee of the management policy, and the\n"
+            "management transactions relayed without a fee are not taken into account.\n"
             "\nExample:\n"
             + HelpExampleCli("estimatesmartfee", "6")
             );
@@ -974,6 +976,47 @@ UniValue estimaterawfee(const JSONRPCRequest& request)
     return result;
 }
 
+UniValue estimateversionfees(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "estimateversionfees\n"
+            "\nReturns the confirmation history of each managed transaction version, as seen\n"
+            "by the fee estimator. The role creation, role change and policy change transactions\n"
+            "are relayed without a fee and are left out of the estimatesmartfee feerates.\n"
+            "Counts are exponentially decaying averages with a half-life of 144 blocks.\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"version\" : n,        (numeric) The transaction version\n"
+            "    \"feeexempt\" : true|false, (boolean) Whether the version is relayed without a fee\n"
+            "    \"confirmed\" : x.x,    (numeric) The number of confirmed transactions of this version\n"
+            "    \"feerate\" : x.x,      (numeric, optional) The average fee rate in " + CURRENCY_UNIT + "/kB they paid\n"
+            "    \"blocks\" : x.x,       (numeric, optional) The average number of blocks they took to confirm\n"
+            "    \"inmempool\" : n       (numeric) The number of tracked transactions of this version in the mempool\n"
+            "  }, ...\n"
+            "]\n"
+            "\nExample:\n"
+            + HelpExampleCli("estimateversionfees", "")
+            + HelpExampleRpc("estimateversionfees", "")
+            );
+
+    UniValue result(UniValue::VARR);
+    for (const VersionEstimate& estimate : ::feeEstimator.estimateVersionFees()) {
+        UniValue version(UniValue::VOBJ);
+        version.push_back(Pair("version", estimate.version));
+        version.push_back(Pair("feeexempt", estimate.feeExempt));
+        version.push_back(Pair("confirmed", round(estimate.confirmed * 100.0) / 100.0));
+        if (estimate.avgFeeRate >= 0) {
+            version.push_back(Pair("feerate", ValueFromAmount(llround(estimate.avgFeeRate))));
+            version.push_back(Pair("blocks", round(estimate.avgBlocks * 100.0) / 100.0));
+        }
+        version.push_back(Pair("inmempool", (int)estimate.inMempool));
+        result.push_back(version);
+    }
+    return result;
+}
+
 static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
@@ -988,6 +1031,7 @@ static const CRPCCommand commands[] =
 
     { "util",               "estimatefee",            &estimatefee,            {"nblocks"} },
     { "util",               "estimatesmartfee",       &estimatesmartfee,       {"conf_target", "estimate_mode"} },
+    { "util",               "estimateversionfees",    &estimateversionfees,    {} },
 
     { "hidden",             "estimaterawfee",         &estimaterawfee,         {"conf_target", "threshold"} },
 };
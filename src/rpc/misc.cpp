@@ -17,6 +17,7 @@
 #include <rpc/blockchain.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
+#include <script/sigcache.h>
 #include <timedata.h>
 #include <util.h>
 #include <utilstrencodings.h>
@@ -459,6 +460,16 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCPubKeyCacheInfo()
+{
+    PubKeyCacheStats stats = GetPubKeyCacheStats();
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("capacity", uint64_t(stats.nCapacity)));
+    obj.push_back(Pair("hits", stats.nHits));
+    obj.push_back(Pair("misses", stats.nMisses));
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -500,6 +511,11 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"pubkeycache\": {          (json object) Information about the cache of parsed public keys\n"
+            "    \"capacity\": xxxxx,      (numeric) Number of keys the cache can hold\n"
+            "    \"hits\": xxxxx,          (numeric) Number of signature checks that found their key in the cache\n"
+            "    \"misses\": xxxxx,        (numeric) Number of signature checks that parsed their key\n"
             "  }\n"
             "}\n"
             "\nResult (mode \"mallocinfo\"):\n"
@@ -513,6 +529,7 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.push_back(Pair("locked", RPCLockedMemoryInfo()));
+        obj.push_back(Pair("pubkeycache", RPCPubKeyCacheInfo()));
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -449,6 +449,10 @@ UniValue getnetworkinfo(const JSONRPCRequest& request)
             "  }\n"
             "  ,...\n"
             "  ]\n"
+            "  \"prefilterrejects\": {                 (json object) received transactions rejected before input lookup\n"
+            "    \"reason\": n,                         (numeric) number of transactions rejected for this reason\n"
+            "    ...\n"
+            "  },\n"
             "  \"warnings\": \"...\"                    (string) any network and blockchain warnings\n"
             "}\n"
             "\nExamples:\n"
@@ -485,6 +489,11 @@ UniValue getnetworkinfo(const JSONRPCRequest& request)
         }
     }
     obj.push_back(Pair("localaddresses", localAddresses));
+    UniValue prefilterRejects(UniValue::VOBJ);
+    for (const auto& reject : GetPrefilterRejects()) {
+        prefilterRejects.push_back(Pair(reject.first, reject.second));
+    }
+    obj.push_back(Pair("prefilterrejects", prefilterRejects));
     obj.push_back(Pair("warnings",       GetWarnings("statusbar")));
     return obj;
 }
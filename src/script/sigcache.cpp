@@ -12,6 +12,9 @@
 #include <util.h>
 
 #include <cuckoocache.h>
+
+#include <atomic>
+
 #include <boost/thread.hpp>
 
 namespace {
@@ -57,6 +60,106 @@ public:
     {
         return setValid.setup_bytes(n);
     }
+
+    void GetEntries(uint256& nonceOut, std::vector<uint256>& entries)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_sigcache);
+        nonceOut = nonce;
+        setValid.for_each([&entries](const uint256& entry) { entries.push_back(entry); });
+    }
+
+    void SetEntries(const uint256& nonceIn, const std::vector<uint256>& entries)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
+        nonce = nonceIn;
+        for (const uint256& entry : entries) {
+            setValid.insert(entry);
+        }
+    }
+};
+
+/** An entry of the public key cache: the salted hash of a public key, and the key as parsed */
+struct PubKeyCacheEntry
+{
+    uint256 id;
+    CParsedPubKey parsed;
+
+    bool operator==(const PubKeyCacheEntry& other) const { return id == other.id; }
+};
+
+/** The hashes of a public key cache entry, taken from its salted id as SignatureCacheHasher does */
+class PubKeyCacheHasher
+{
+public:
+    template <uint8_t hash_select>
+    uint32_t operator()(const PubKeyCacheEntry& entry) const
+    {
+        static_assert(hash_select <8, "PubKeyCacheHasher only has 8 hashes available.");
+        uint32_t u;
+        std::memcpy(&u, entry.id.begin()+4*hash_select, 4);
+        return u;
+    }
+};
+
+/**
+ * Parsed public key cache. In a managed chain, a few manager and creator keys
+ * sign a large fraction of the transactions, so most signature checks can
+ * skip the parsing and decompression of their key.
+ */
+class CPubKeyCache
+{
+private:
+    //! Entries are identified by SHA256(nonce || public key)
+    uint256 nonce;
+    typedef CuckooCache::cache<PubKeyCacheEntry, PubKeyCacheHasher> map_type;
+    map_type setKeys;
+    boost::shared_mutex cs_pubkeycache;
+    size_t nCapacity = 0;
+    std::atomic<uint64_t> nHits{0};
+    std::atomic<uint64_t> nMisses{0};
+
+public:
+    CPubKeyCache()
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    void ComputeEntry(PubKeyCacheEntry& entry, const CPubKey& pubkey)
+    {
+        CSHA256().Write(nonce.begin(), 32).Write(pubkey.begin(), pubkey.size()).Finalize(entry.id.begin());
+    }
+
+    bool Get(PubKeyCacheEntry& entry)
+    {
+        bool fFound;
+        {
+            boost::shared_lock<boost::shared_mutex> lock(cs_pubkeycache);
+            fFound = setKeys.find(entry, false);
+        }
+        ++(fFound ? nHits : nMisses);
+        return fFound;
+    }
+
+    void Set(const PubKeyCacheEntry& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_pubkeycache);
+        setKeys.insert(entry);
+    }
+
+    uint32_t setup_bytes(size_t n)
+    {
+        nCapacity = setKeys.setup_bytes(n);
+        return nCapacity;
+    }
+
+    PubKeyCacheStats GetStats() const
+    {
+        PubKeyCacheStats stats;
+        stats.nCapacity = nCapacity;
+        stats.nHits = nHits;
+        stats.nMisses = nMisses;
+        return stats;
+    }
 };
 
 /* In previous versions of this code, signatureCache was a local static variable
@@ -66,6 +169,7 @@ public:
  * signatureCache could be made local to VerifySignature.
 */
 static CSignatureCache signatureCache;
+static CPubKeyCache pubkeyCache;
 } // namespace
 
 // To be called once in AppInitMain/BasicTestingSetup to initialize the
@@ -78,6 +182,24 @@ void InitSignatureCache()
     size_t nElems = signatureCache.setup_bytes(nMaxCacheSize);
     LogPrintf("Using %zu MiB out of %zu/2 requested for signature cache, able to store %zu elements\n",
             (nElems*sizeof(uint256)) >>20, (nMaxCacheSize*2)>>20, nElems);
+    size_t nKeys = pubkeyCache.setup_bytes(PUBKEY_CACHE_SIZE);
+    LogPrintf("Using %zu KiB for public key cache, able to store %zu keys\n",
+            (nKeys*sizeof(PubKeyCacheEntry)) >>10, nKeys);
+}
+
+void GetSignatureCacheEntries(uint256& nonce, std::vector<uint256>& entries)
+{
+    signatureCache.GetEntries(nonce, entries);
+}
+
+void SetSignatureCacheEntries(const uint256& nonce, const std::vector<uint256>& entries)
+{
+    signatureCache.SetEntries(nonce, entries);
+}
+
+PubKeyCacheStats GetPubKeyCacheStats()
+{
+    return pubkeyCache.GetStats();
 }
 
 bool CachingTransactionSignatureChecker::VerifySignature(const std::vector<unsigned char>& vchSig, const CPubKey& pubkey, const uint256& sighash) const
@@ -86,7 +208,14 @@ bool CachingTransactionSignatureChecker::VerifySignature(const std::vector<unsig
     signatureCache.ComputeEntry(entry, sighash, vchSig, pubkey);
     if (signatureCache.Get(entry, !store))
         return true;
-    if (!TransactionSignatureChecker::VerifySignature(vchSig, pubkey, sighash))
+    PubKeyCacheEntry key;
+    pubkeyCache.ComputeEntry(key, pubkey);
+    if (!pubkeyCache.Get(key)) {
+        if (!pubkey.Parse(key.parsed))
+            return false;
+        pubkeyCache.Set(key);
+    }
+    if (!CPubKey::Verify(key.parsed, sighash, vchSig))
         return false;
     if (store)
         signatureCache.Set(entry);
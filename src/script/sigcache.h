@@ -16,8 +16,12 @@
 static const unsigned int DEFAULT_MAX_SIG_CACHE_SIZE = 32;
 // Maximum sig cache size allowed
 static const int64_t MAX_MAX_SIG_CACHE_SIZE = 16384;
+// Size of the cache of parsed public keys, in bytes. About 10000 keys, far
+// more than the manager and creator keys that sign most managed transactions.
+static const size_t PUBKEY_CACHE_SIZE = 1 << 20;
 
 class CPubKey;
+class uint256;
 
 /**
  * We're hashing a nonce into the entries themselves, so we don't need extra
@@ -53,4 +57,25 @@ public:
 
 void InitSignatureCache();
 
+/** Get the salt of the signature cache and the entries it holds, to save them across restarts */
+void GetSignatureCacheEntries(uint256& nonce, std::vector<uint256>& entries);
+
+/**
+ * Restore a salt and entries saved by GetSignatureCacheEntries. Entries made
+ * with the previous salt can no longer be found, so this has to be called
+ * before the cache is used.
+ */
+void SetSignatureCacheEntries(const uint256& nonce, const std::vector<uint256>& entries);
+
+/** Counters of the cache of parsed public keys used by CachingTransactionSignatureChecker */
+struct PubKeyCacheStats {
+    //! The number of keys the cache can hold
+    size_t nCapacity;
+    //! Lookups served from the cache, and lookups that had to parse the key
+    uint64_t nHits;
+    uint64_t nMisses;
+};
+
+PubKeyCacheStats GetPubKeyCacheStats();
+
 #endif // BITCOIN_SCRIPT_SIGCACHE_H
@@ -44,6 +44,19 @@
 /** The number of entries a table with precomputed multiples needs to have. */
 #define ECMULT_TABLE_SIZE(w) (1 << ((w)-2))
 
+#if defined(USE_ECMULT_STATIC_PRECOMPUTATION) && !defined(EXHAUSTIVE_TEST_ORDER)
+/* The generator tables are generated at build time, and shared read-only by
+ * all the contexts instead of being computed by each of them. */
+#define USE_ECMULT_STATIC_PRE_G 1
+#include "ecmult_static_pre_g.h"
+#if WINDOW_G > ECMULT_STATIC_WINDOW_G
+#error "The static generator table is too small for WINDOW_G"
+#endif
+#if defined(USE_ENDOMORPHISM) && WINDOW_G > ECMULT_STATIC_WINDOW_G_128
+#error "The static 2^128*generator table is too small for WINDOW_G"
+#endif
+#endif
+
 /** Fill a table 'prej' with precomputed odd multiples of a. Prej will contain
  *  the values [1*a,3*a,...,(2*n-1)*a], so it space for n values. zr[0] will
  *  contain prej[0].z / a.z. The other zr[i] values = prej[i].z / prej[i-1].z.
@@ -162,7 +175,15 @@ static void secp256k1_ecmult_context_init(secp256k1_ecmult_context *ctx) {
 }
 
 static void secp256k1_ecmult_context_build(secp256k1_ecmult_context *ctx, const secp256k1_callback *cb) {
+#ifdef USE_ECMULT_STATIC_PRE_G
+    (void)cb;
+    ctx->pre_g = &secp256k1_ecmult_static_pre_g;
+#ifdef USE_ENDOMORPHISM
+    ctx->pre_g_128 = &secp256k1_ecmult_static_pre_g_128;
+#endif
+#else
     secp256k1_gej gj;
+    secp256k1_ge_storage (*pre_g)[];
 
     if (ctx->pre_g != NULL) {
         return;
@@ -171,46 +192,57 @@ static void secp256k1_ecmult_context_build(secp256k1_ecmult_context *ctx, const
     /* get the generator */
     secp256k1_gej_set_ge(&gj, &secp256k1_ge_const_g);
 
-    ctx->pre_g = (secp256k1_ge_storage (*)[])checked_malloc(cb, sizeof((*ctx->pre_g)[0]) * ECMULT_TABLE_SIZE(WINDOW_G));
+    pre_g = (secp256k1_ge_storage (*)[])checked_malloc(cb, sizeof((*pre_g)[0]) * ECMULT_TABLE_SIZE(WINDOW_G));
 
     /* precompute the tables with odd multiples */
-    secp256k1_ecmult_odd_multiples_table_storage_var(ECMULT_TABLE_SIZE(WINDOW_G), *ctx->pre_g, &gj, cb);
+    secp256k1_ecmult_odd_multiples_table_storage_var(ECMULT_TABLE_SIZE(WINDOW_G), *pre_g, &gj, cb);
+    ctx->pre_g = (const secp256k1_ge_storage (*)[])pre_g;
 
 #ifdef USE_ENDOMORPHISM
     {
         secp256k1_gej g_128j;
+        secp256k1_ge_storage (*pre_g_128)[];
         int i;
 
-        ctx->pre_g_128 = (secp256k1_ge_storage (*)[])checked_malloc(cb, sizeof((*ctx->pre_g_128)[0]) * ECMULT_TABLE_SIZE(WINDOW_G));
+        pre_g_128 = (secp256k1_ge_storage (*)[])checked_malloc(cb, sizeof((*pre_g_128)[0]) * ECMULT_TABLE_SIZE(WINDOW_G));
 
         /* calculate 2^128*generator */
         g_128j = gj;
         for (i = 0; i < 128; i++) {
             secp256k1_gej_double_var(&g_128j, &g_128j, NULL);
         }
-        secp256k1_ecmult_odd_multiples_table_storage_var(ECMULT_TABLE_SIZE(WINDOW_G), *ctx->pre_g_128, &g_128j, cb);
+        secp256k1_ecmult_odd_multiples_table_storage_var(ECMULT_TABLE_SIZE(WINDOW_G), *pre_g_128, &g_128j, cb);
+        ctx->pre_g_128 = (const secp256k1_ge_storage (*)[])pre_g_128;
     }
 #endif
+#endif
 }
 
 static void secp256k1_ecmult_context_clone(secp256k1_ecmult_context *dst,
                                            const secp256k1_ecmult_context *src, const secp256k1_callback *cb) {
+#ifdef USE_ECMULT_STATIC_PRE_G
+    (void)cb;
+    *dst = *src;
+#else
     if (src->pre_g == NULL) {
         dst->pre_g = NULL;
     } else {
         size_t size = sizeof((*dst->pre_g)[0]) * ECMULT_TABLE_SIZE(WINDOW_G);
-        dst->pre_g = (secp256k1_ge_storage (*)[])checked_malloc(cb, size);
-        memcpy(dst->pre_g, src->pre_g, size);
+        void *pre_g = checked_malloc(cb, size);
+        memcpy(pre_g, src->pre_g, size);
+        dst->pre_g = (const secp256k1_ge_storage (*)[])pre_g;
     }
 #ifdef USE_ENDOMORPHISM
     if (src->pre_g_128 == NULL) {
         dst->pre_g_128 = NULL;
     } else {
         size_t size = sizeof((*dst->pre_g_128)[0]) * ECMULT_TABLE_SIZE(WINDOW_G);
-        dst->pre_g_128 = (secp256k1_ge_storage (*)[])checked_malloc(cb, size);
-        memcpy(dst->pre_g_128, src->pre_g_128, size);
+        void *pre_g_128 = checked_malloc(cb, size);
+        memcpy(pre_g_128, src->pre_g_128, size);
+        dst->pre_g_128 = (const secp256k1_ge_storage (*)[])pre_g_128;
     }
 #endif
+#endif
 }
 
 static int secp256k1_ecmult_context_is_built(const secp256k1_ecmult_context *ctx) {
@@ -218,9 +250,12 @@ static int secp256k1_ecmult_context_is_built(const secp256k1_ecmult_context *ctx
 }
 
 static void secp256k1_ecmult_context_clear(secp256k1_ecmult_context *ctx) {
-    free(ctx->pre_g);
+#ifndef USE_ECMULT_STATIC_PRE_G
+    /* The tables were allocated by this context, only its view of them is const. */
+    free((void *)ctx->pre_g);
 #ifdef USE_ENDOMORPHISM
-    free(ctx->pre_g_128);
+    free((void *)ctx->pre_g_128);
+#endif
 #endif
     secp256k1_ecmult_context_init(ctx);
 }
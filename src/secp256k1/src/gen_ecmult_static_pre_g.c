@@ -0,0 +1,93 @@
+/**********************************************************************
+ * Copyright (c) 2018-2019 National Institute of Standards and        *
+ * Technology                                                         *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#define USE_BASIC_CONFIG 1
+
+#include "basic-config.h"
+#include "include/secp256k1.h"
+#include "field_impl.h"
+#include "scalar_impl.h"
+#include "group_impl.h"
+#include "ecmult_impl.h"
+
+/* The largest window the verification tables are generated for. It matches
+ * WINDOW_G without the endomorphism; with it, only a prefix of the table is
+ * used. */
+#define STATIC_WINDOW_G 16
+/* The window of the 2^128*generator table, only used with the endomorphism. */
+#define STATIC_WINDOW_G_128 15
+
+static void default_error_callback_fn(const char* str, void* data) {
+    (void)data;
+    fprintf(stderr, "[libsecp256k1] internal consistency check failed: %s\n", str);
+    abort();
+}
+
+static const secp256k1_callback default_error_callback = {
+    default_error_callback_fn,
+    NULL
+};
+
+static void print_table(FILE *fp, const char *name, int window, const secp256k1_gej *gj) {
+    int n = ECMULT_TABLE_SIZE(window);
+    int i;
+    secp256k1_ge_storage* table = (secp256k1_ge_storage*)checked_malloc(&default_error_callback, sizeof(secp256k1_ge_storage) * n);
+
+    secp256k1_ecmult_odd_multiples_table_storage_var(n, table, gj, &default_error_callback);
+
+    fprintf(fp, "static const secp256k1_ge_storage %s[%d] = {\n", name, n);
+    for(i = 0; i != n; i++) {
+        fprintf(fp,"    SC(%uu, %uu, %uu, %uu, %uu, %uu, %uu, %uu, %uu, %uu, %uu, %uu, %uu, %uu, %uu, %uu)", SECP256K1_GE_STORAGE_CONST_GET(table[i]));
+        if (i != n - 1) {
+            fprintf(fp,",\n");
+        } else {
+            fprintf(fp,"\n");
+        }
+    }
+    fprintf(fp,"};\n");
+    free(table);
+}
+
+int main(int argc, char **argv) {
+    secp256k1_gej gj;
+    int i;
+    FILE* fp;
+
+    (void)argc;
+    (void)argv;
+
+    fp = fopen("src/ecmult_static_pre_g.h","w");
+    if (fp == NULL) {
+        fprintf(stderr, "Could not open src/ecmult_static_pre_g.h for writing!\n");
+        return -1;
+    }
+
+    fprintf(fp, "#ifndef _SECP256K1_ECMULT_STATIC_PRE_G_\n");
+    fprintf(fp, "#define _SECP256K1_ECMULT_STATIC_PRE_G_\n");
+    fprintf(fp, "#include \"group.h\"\n");
+    fprintf(fp, "#define SC SECP256K1_GE_STORAGE_CONST\n");
+    fprintf(fp, "#define ECMULT_STATIC_WINDOW_G %d\n", STATIC_WINDOW_G);
+
+    /* Odd multiples of the generator */
+    secp256k1_gej_set_ge(&gj, &secp256k1_ge_const_g);
+    print_table(fp, "secp256k1_ecmult_static_pre_g", STATIC_WINDOW_G, &gj);
+
+    /* Odd multiples of 2^128*generator */
+    fprintf(fp, "#ifdef USE_ENDOMORPHISM\n");
+    fprintf(fp, "#define ECMULT_STATIC_WINDOW_G_128 %d\n", STATIC_WINDOW_G_128);
+    for (i = 0; i < 128; i++) {
+        secp256k1_gej_double_var(&gj, &gj, NULL);
+    }
+    print_table(fp, "secp256k1_ecmult_static_pre_g_128", STATIC_WINDOW_G_128, &gj);
+    fprintf(fp, "#endif\n");
+
+    fprintf(fp, "#undef SC\n");
+    fprintf(fp, "#endif\n");
+    fclose(fp);
+
+    return 0;
+}
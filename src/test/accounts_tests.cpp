@@ -3,6 +3,9 @@
 
 #include <accounts/data.h>
 #include <accounts/db.h>
+#include <accounts/verify.h>
+#include <txdb.h>
+#include <validation.h>
 
 BOOST_FIXTURE_TEST_SUITE(accounts_tests, BasicTestingSetup)
 
@@ -333,4 +336,164 @@ BOOST_AUTO_TEST_CASE(account_db_serialize_tests)
     );
 }
 
+BOOST_AUTO_TEST_CASE(account_verify_tests)
+{
+    std::vector<std::string> sampleAddresses = {
+        "1ArmQouzU8cvAt4muQJ9srPy7CXVcgbSmU",
+        "1NWqvweBVX1D5C1E9h5vbdX85L7TsDAsgu",
+        "16tgXnXyw7rk2jvDLhuj2kkCJu5my5pwPs",
+        "16bzmWkCPBVYBDkaKD6LHsckVnE2qkHHzy"
+    };
+    CTxDestination addressRoot = DecodeDestination(sampleAddresses.at(0));
+    CTxDestination address1 = DecodeDestination(sampleAddresses.at(1));
+    CTxDestination address2 = DecodeDestination(sampleAddresses.at(2));
+    CTxDestination address3 = DecodeDestination(sampleAddresses.at(3));
+    CRoleChangeMode rolesRoot;
+    CRoleChangeMode rolesUser;
+    ParseRoles("M..R..", rolesRoot);
+    ParseRoles("...R..", rolesUser);
+
+    CManagedAccountDB accountDB("/tmp/accounts.dat");
+    accountDB.ResetDB();
+    accountDB.UpdateAccount(addressRoot, CManagedAccountData(rolesRoot));
+    accountDB.UpdateAccount(address1, CManagedAccountData(rolesUser, addressRoot));
+    accountDB.UpdateAccount(address2, CManagedAccountData(rolesUser, addressRoot));
+
+    // A consistent tree with matching role coins
+    RoleCoinMap roleCoins;
+    roleCoins[addressRoot].push_back(rolesRoot);
+    roleCoins[address1].push_back(rolesUser);
+    roleCoins[address2].push_back(rolesUser);
+
+    CAccountCheckResult result;
+    CheckAccountTree(accountDB, result);
+    CheckAccountRoles(accountDB, roleCoins, result);
+    BOOST_CHECK(
+        result.IsValid()
+    );
+    BOOST_CHECK(
+        result.vRoots.size() == 1 && result.vRoots.at(0) == addressRoot
+    );
+    BOOST_CHECK(
+        result.nRoleCoins == 3
+    );
+
+    // Roles differing from the chainstate, missing and duplicate role coins
+    roleCoins[address1].at(0) = rolesRoot;
+    roleCoins[address2].push_back(rolesUser);
+    roleCoins[address3].push_back(rolesUser);
+
+    result = CAccountCheckResult();
+    CheckAccountRoles(accountDB, roleCoins, result);
+    BOOST_CHECK(
+        !result.IsValid()
+    );
+    BOOST_CHECK(
+        result.vMismatchedRoles.size() == 2
+    );
+    BOOST_CHECK(
+        result.vDuplicateCredentials.size() == 1 && result.vDuplicateCredentials.at(0) == address2
+    );
+
+    // A second root, and a child whose parent does not list it
+    accountDB.AddAccount(address3, CManagedAccountData(rolesUser));
+    CManagedAccountData accountData;
+    accountDB.GetAccountByAddress(address1, accountData);
+    accountData.SetParent(address3);
+    accountDB.DeleteAccount(address1);
+    accountDB.AddAccount(address1, accountData);
+
+    result = CAccountCheckResult();
+    CheckAccountTree(accountDB, result);
+    BOOST_CHECK(
+        result.vRoots.size() == 2
+    );
+    BOOST_CHECK(
+        result.vOrphanedChildren.size() == 1 && result.vOrphanedChildren.at(0) == address1
+    );
+}
+
+BOOST_AUTO_TEST_CASE(account_scan_tests)
+{
+    CCoinsViewDB view(1 << 20, true);
+    CRoleChangeMode rolesUser;
+    ParseRoles("...R..", rolesUser);
+
+    // Role coins to random keys, some holding two, among coin transfers
+    RoleCoinMap expected;
+    CCoinsMap map;
+    uint64_t nCoins = 0;
+    for (int i = 0; i < 1000; i++) {
+        CTxDestination dest = CKeyID(uint160(insecure_rand_ctx.randbytes(20)));
+        CScript script = GetScriptForDestination(dest);
+        int nRoleCoins = i % 3 == 0 ? 0 : i % 10 == 1 ? 2 : 1;
+        for (int n = 0; n < std::max(nRoleCoins, 1); n++) {
+            CCoinsCacheEntry entry;
+            if (nRoleCoins) {
+                entry.coin = Coin(CTxOut(rolesUser, script), 1, false);
+                expected[dest].push_back(rolesUser);
+            } else {
+                entry.coin = Coin(CTxOut(COIN, script), 1, false);
+            }
+            entry.flags = CCoinsCacheEntry::DIRTY;
+            map.emplace(COutPoint(InsecureRand256(), n), std::move(entry));
+            nCoins++;
+        }
+    }
+    // BatchWrite empties the map
+    const COutPoint spentOutpoint = map.begin()->first;
+    BOOST_CHECK(view.BatchWrite(map, InsecureRand256()));
+
+    // Every partitioning finds each coin exactly once
+    for (int nPartitions : {1, 3, 16, 256, 1000}) {
+        RoleCoinMap roleCoins;
+        uint64_t nCoinsScanned = 0;
+        int nLastProgress = -1;
+        BOOST_CHECK(ScanRoleCoins(view, roleCoins, nCoinsScanned, nPartitions,
+                                  [&nLastProgress](int nProgress) { nLastProgress = nProgress; }));
+        BOOST_CHECK_EQUAL(nCoinsScanned, nCoins);
+        BOOST_CHECK(roleCoins == expected);
+        BOOST_CHECK(nLastProgress <= 100);
+    }
+
+    // Cursors opened before a change keep scanning the state they were opened on
+    RoleCoinCursors cursors = OpenRoleCoinCursors(view, 4);
+    CCoinsMap spent;
+    CCoinsCacheEntry entry;
+    entry.flags = CCoinsCacheEntry::DIRTY;
+    spent.emplace(spentOutpoint, std::move(entry));
+    BOOST_CHECK(view.BatchWrite(spent, InsecureRand256()));
+    RoleCoinMap roleCoins;
+    uint64_t nCoinsScanned = 0;
+    BOOST_CHECK(ScanRoleCoins(cursors, roleCoins, nCoinsScanned));
+    BOOST_CHECK_EQUAL(nCoinsScanned, nCoins);
+    BOOST_CHECK(roleCoins == expected);
+}
+
+BOOST_FIXTURE_TEST_CASE(account_verify_fresh_chain, TestingSetup)
+{
+    // The account tree holds the genesis manager as soon as the genesis block
+    // is loaded, a node started for the first time checks it against a
+    // chainstate that does not have the genesis coins yet
+    CManagedAccountDB accountDB;
+    BOOST_CHECK_EQUAL(accountDB.GetAccounts().size(), 1U);
+    CCoinsViewDB freshView(1 << 20, true);
+    BOOST_CHECK(freshView.GetBestBlock().IsNull());
+
+    CAccountCheckResult result;
+    BOOST_CHECK(VerifyAccounts(accountDB, freshView, 2, result));
+    BOOST_CHECK(result.IsValid());
+    BOOST_CHECK_EQUAL(result.nCoinsScanned, 0U);
+    BOOST_CHECK_EQUAL(result.nRoleCoins, 1U);
+
+    // Once connected, the genesis coins are not counted twice
+    FlushStateToDisk();
+    BOOST_CHECK(!pcoinsdbview->GetBestBlock().IsNull());
+    result = CAccountCheckResult();
+    BOOST_CHECK(VerifyAccounts(accountDB, *pcoinsdbview, 2, result));
+    BOOST_CHECK(result.IsValid());
+    BOOST_CHECK(result.nCoinsScanned > 0);
+    BOOST_CHECK_EQUAL(result.nRoleCoins, 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addressindex.h>
+#include <key.h>
+#include <pubkey.h>
+#include <script/standard.h>
+#include <txdb.h>
+
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(addressindex_tests, BasicTestingSetup)
+
+static CMutableTransaction SpendingTx(const std::vector<COutPoint>& prevouts)
+{
+    CMutableTransaction tx;
+    for (const COutPoint& prevout : prevouts) {
+        tx.vin.emplace_back(prevout);
+    }
+    return tx;
+}
+
+BOOST_AUTO_TEST_CASE(addressindex_hash)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    const CPubKey pubkey = key.GetPubKey();
+
+    // Pay-to-pubkey outputs are indexed under the key hash of their pubkey
+    uint160 hashP2PK, hashP2PKH;
+    BOOST_CHECK(GetAddressIndexHash(GetScriptForRawPubKey(pubkey), hashP2PK));
+    BOOST_CHECK(GetAddressIndexHash(GetScriptForDestination(pubkey.GetID()), hashP2PKH));
+    BOOST_CHECK(hashP2PK == hashP2PKH);
+    BOOST_CHECK(hashP2PKH == GetAddressIndexHash(CTxDestination(pubkey.GetID())));
+
+    // Different destination types of the same hash are distinct
+    uint160 hashP2SH;
+    BOOST_CHECK(GetAddressIndexHash(GetScriptForDestination(CScriptID(uint160(pubkey.GetID()))), hashP2SH));
+    BOOST_CHECK(hashP2SH != hashP2PKH);
+
+    uint160 hashNone;
+    BOOST_CHECK(!GetAddressIndexHash(CScript() << OP_RETURN, hashNone));
+}
+
+BOOST_AUTO_TEST_CASE(addressindex_connect_disconnect)
+{
+    CBlockTreeDB db(1 << 20, true);
+
+    CKey key1, key2;
+    key1.MakeNewKey(true);
+    key2.MakeNewKey(true);
+    const CScript script1 = GetScriptForDestination(key1.GetPubKey().GetID());
+    const CScript script2 = GetScriptForRawPubKey(key2.GetPubKey());
+    const uint160 hash1 = GetAddressIndexHash(CTxDestination(key1.GetPubKey().GetID()));
+    const uint160 hash2 = GetAddressIndexHash(CTxDestination(key2.GetPubKey().GetID()));
+
+    // A coin and a role to the first address, a coin to the second one
+    CMutableTransaction mtx1;
+    mtx1.vin.emplace_back(COutPoint(InsecureRand256(), 0));
+    mtx1.vout.emplace_back(5 * COIN, script1);
+    mtx1.vout.emplace_back(false, false, false, true, false, false, script1);
+    mtx1.vout.emplace_back(3 * COIN, script2);
+    mtx1.vout.emplace_back(0, CScript() << OP_RETURN);
+    const CTransaction tx1(mtx1);
+
+    AddressUnspentUpdates connect1;
+    AddAddressOutputs(tx1, 10, connect1);
+    BOOST_CHECK_EQUAL(connect1.size(), 3);
+    BOOST_CHECK(db.UpdateAddressUnspentIndex(connect1));
+
+    std::vector<std::pair<CAddressUnspentKey, Coin>> unspent;
+    BOOST_CHECK(db.ReadAddressUnspentIndex({hash1, hash2, hash1}, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), 3);
+    for (const auto& entry : unspent) {
+        BOOST_CHECK(entry.first.outpoint.hash == tx1.GetHash());
+        BOOST_CHECK(entry.second.out == tx1.vout[entry.first.outpoint.n]);
+        BOOST_CHECK_EQUAL(entry.second.nHeight, 10);
+        BOOST_CHECK(entry.first.hashDest == (entry.first.outpoint.n == 2 ? hash2 : hash1));
+    }
+
+    // Spend the coin of the first address to the second one
+    CMutableTransaction mtx2 = SpendingTx({COutPoint(tx1.GetHash(), 0)});
+    mtx2.vout.emplace_back(5 * COIN, script2);
+    const CTransaction tx2(mtx2);
+
+    AddressUnspentUpdates connect2;
+    UpdateAddressInput(tx2.vin[0].prevout, Coin(tx1.vout[0], 10, false), false, connect2);
+    AddAddressOutputs(tx2, 11, connect2);
+    BOOST_CHECK(db.UpdateAddressUnspentIndex(connect2));
+
+    unspent.clear();
+    BOOST_CHECK(db.ReadAddressUnspentIndex({hash1}, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), 1);
+    BOOST_CHECK(unspent[0].second.out.nTxType == CTxOut::ROLE_CHANGE);
+
+    unspent.clear();
+    BOOST_CHECK(db.ReadAddressUnspentIndex({hash2}, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), 2);
+
+    // Disconnecting the spend restores the coin
+    AddressUnspentUpdates disconnect2;
+    RemoveAddressOutputs(tx2, disconnect2);
+    UpdateAddressInput(tx2.vin[0].prevout, Coin(tx1.vout[0], 10, false), true, disconnect2);
+    BOOST_CHECK(db.UpdateAddressUnspentIndex(disconnect2));
+
+    unspent.clear();
+    BOOST_CHECK(db.ReadAddressUnspentIndex({hash1, hash2}, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), 3);
+
+    // An unknown address has no outputs
+    unspent.clear();
+    BOOST_CHECK(db.ReadAddressUnspentIndex({uint160(std::vector<unsigned char>(20, 0x42))}, unspent));
+    BOOST_CHECK(unspent.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
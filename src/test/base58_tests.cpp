@@ -73,6 +73,109 @@ BOOST_AUTO_TEST_CASE(base58_DecodeBase58)
     BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
 }
 
+// Encode a byte at a time, as the reference for the limb based conversion
+static std::string ReferenceEncodeBase58(const std::vector<unsigned char>& vch)
+{
+    static const char* digits = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    std::vector<unsigned char>::const_iterator it = vch.begin();
+    std::string zeroes;
+    for (; it != vch.end() && *it == 0; ++it) {
+        zeroes += '1';
+    }
+    std::vector<unsigned char> b58; // least significant digit first
+    for (; it != vch.end(); ++it) {
+        int carry = *it;
+        for (unsigned char& digit : b58) {
+            carry += 256 * digit;
+            digit = carry % 58;
+            carry /= 58;
+        }
+        for (; carry != 0; carry /= 58) {
+            b58.push_back(carry % 58);
+        }
+    }
+    std::string str = zeroes;
+    for (auto digit = b58.rbegin(); digit != b58.rend(); ++digit) {
+        str += digits[*digit];
+    }
+    return str;
+}
+
+// Goal: check the limb based conversion and the batch functions on random data
+BOOST_AUTO_TEST_CASE(base58_random_batch)
+{
+    std::vector<std::vector<unsigned char>> payloads;
+    for (int i = 0; i < 200; i++) {
+        std::vector<unsigned char> vch(InsecureRandRange(50));
+        const size_t nZeroes = InsecureRandRange(4);
+        for (size_t j = nZeroes; j < vch.size(); j++) {
+            vch[j] = InsecureRandBits(8);
+        }
+        std::string str = EncodeBase58(vch);
+        BOOST_CHECK_EQUAL(str, ReferenceEncodeBase58(vch));
+        std::vector<unsigned char> decoded;
+        BOOST_CHECK(DecodeBase58(str, decoded));
+        BOOST_CHECK(decoded == vch);
+        payloads.push_back(vch);
+    }
+
+    const std::vector<std::string> strs = EncodeBase58CheckBatch(payloads);
+    BOOST_CHECK_EQUAL(strs.size(), payloads.size());
+    for (size_t i = 0; i < payloads.size(); i++) {
+        BOOST_CHECK_EQUAL(strs[i], EncodeBase58Check(payloads[i]));
+    }
+
+    // Corrupt one string, and check that only it fails
+    std::vector<std::string> corrupted = strs;
+    corrupted[7].back() = corrupted[7].back() == 'z' ? 'y' : 'z';
+    std::vector<std::vector<unsigned char>> decoded;
+    const std::vector<bool> valid = DecodeBase58CheckBatch(corrupted, decoded);
+    BOOST_CHECK_EQUAL(valid.size(), payloads.size());
+    BOOST_CHECK_EQUAL(decoded.size(), payloads.size());
+    for (size_t i = 0; i < payloads.size(); i++) {
+        BOOST_CHECK_EQUAL(valid[i], i != 7);
+        BOOST_CHECK(decoded[i] == (i != 7 ? payloads[i] : std::vector<unsigned char>()));
+    }
+}
+
+// Goal: check that the batch destination functions match the single ones
+BOOST_AUTO_TEST_CASE(base58_destinations_batch)
+{
+    std::vector<CTxDestination> dests;
+    for (int i = 0; i < 10; i++) {
+        uint256 hash = InsecureRand256();
+        dests.push_back(CKeyID(uint160(std::vector<unsigned char>(hash.begin(), hash.begin() + 20))));
+        dests.push_back(CScriptID(uint160(std::vector<unsigned char>(hash.begin() + 1, hash.begin() + 21))));
+        WitnessV0KeyHash keyhash;
+        std::copy(hash.begin(), hash.begin() + 20, keyhash.begin());
+        dests.push_back(keyhash);
+        dests.push_back(WitnessV0ScriptHash(hash));
+        WitnessUnknown unknown;
+        unknown.version = 1 + i;
+        unknown.length = 2 + i;
+        std::copy(hash.begin(), hash.begin() + unknown.length, unknown.program);
+        dests.push_back(unknown);
+        dests.push_back(CNoDestination());
+    }
+
+    const std::vector<std::string> strs = EncodeDestinations(dests);
+    BOOST_CHECK_EQUAL(strs.size(), dests.size());
+    for (size_t i = 0; i < dests.size(); i++) {
+        BOOST_CHECK_EQUAL(strs[i], EncodeDestination(dests[i]));
+        BOOST_CHECK_EQUAL(strs[i].empty(), !IsValidDestination(dests[i]));
+    }
+
+    std::vector<std::string> inputs = strs;
+    inputs.push_back("invalid");
+    const std::vector<CTxDestination> decoded = DecodeDestinations(inputs);
+    BOOST_CHECK_EQUAL(decoded.size(), inputs.size());
+    for (size_t i = 0; i < dests.size(); i++) {
+        BOOST_CHECK(decoded[i] == dests[i]);
+        BOOST_CHECK(decoded[i] == DecodeDestination(inputs[i]));
+    }
+    BOOST_CHECK(!IsValidDestination(decoded.back()));
+}
+
 // Goal: check that parsed keys match test payload
 BOOST_AUTO_TEST_CASE(base58_keys_valid_parse)
 {
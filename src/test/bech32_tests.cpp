@@ -64,4 +64,32 @@ BOOST_AUTO_TEST_CASE(bip173_testvectors_invalid)
     }
 }
 
+BOOST_AUTO_TEST_CASE(bech32_batch)
+{
+    static const std::string CASES[] = {
+        "a12uel5l",
+        "abcdef1qpzry9x8gf2tvdw0s3jn54khce6mua7lmqqqxw",
+        "x1b4n0q5v",
+        "A12UEL5L",
+        "li1dgmt3",
+        "abcdef1qpzry9x8gf2tvdw0s3jn54khce6mua7lmqqqxw",
+        "split1checkupstagehandshakeupstreamerranterredcaperred2y9e3w",
+    };
+    const std::vector<std::string> strs(std::begin(CASES), std::end(CASES));
+    const auto decoded = bech32::DecodeBatch(strs);
+    BOOST_CHECK_EQUAL(decoded.size(), strs.size());
+    std::vector<std::vector<uint8_t>> values;
+    for (size_t i = 0; i < strs.size(); ++i) {
+        BOOST_CHECK(decoded[i] == bech32::Decode(strs[i]));
+        values.push_back(decoded[i].second);
+    }
+
+    const std::vector<std::string> encoded = bech32::EncodeBatch("abcdef", values);
+    BOOST_CHECK_EQUAL(encoded.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        BOOST_CHECK_EQUAL(encoded[i], bech32::Encode("abcdef", values[i]));
+    }
+    BOOST_CHECK_EQUAL(encoded[1], strs[1]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
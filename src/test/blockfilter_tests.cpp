@@ -0,0 +1,148 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockfilter.h>
+#include <coins.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <streams.h>
+#include <undo.h>
+#include <version.h>
+
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(blockfilter_tests)
+
+BOOST_AUTO_TEST_CASE(gcsfilter_test)
+{
+    GCSFilter::ElementSet included_elements, excluded_elements;
+    for (int i = 0; i < 100; ++i) {
+        GCSFilter::Element element1(32);
+        element1[0] = i;
+        included_elements.insert(std::move(element1));
+
+        GCSFilter::Element element2(32);
+        element2[1] = i;
+        excluded_elements.insert(std::move(element2));
+    }
+
+    GCSFilter filter({0, 0, 10, 1 << 10}, included_elements);
+    for (const auto& element : included_elements) {
+        BOOST_CHECK(filter.Match(element));
+
+        auto insertion = excluded_elements.insert(element);
+        BOOST_CHECK(filter.MatchAny(excluded_elements));
+        excluded_elements.erase(insertion.first);
+    }
+
+    // The encoding reconstructs the same filter
+    GCSFilter decoded(filter.GetParams(), filter.GetEncoded());
+    BOOST_CHECK_EQUAL(decoded.GetN(), filter.GetN());
+    for (const auto& element : included_elements) {
+        BOOST_CHECK(decoded.Match(element));
+    }
+
+    // Trailing data is rejected
+    std::vector<unsigned char> encoded = filter.GetEncoded();
+    encoded.push_back(0);
+    BOOST_CHECK_THROW(GCSFilter(filter.GetParams(), encoded), std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor)
+{
+    GCSFilter filter;
+    BOOST_CHECK_EQUAL(filter.GetN(), 0);
+    BOOST_CHECK_EQUAL(filter.GetEncoded().size(), 1);
+
+    const GCSFilter::Params& params = filter.GetParams();
+    BOOST_CHECK_EQUAL(params.m_siphash_k0, 0);
+    BOOST_CHECK_EQUAL(params.m_siphash_k1, 0);
+    BOOST_CHECK_EQUAL(params.m_P, 0);
+    BOOST_CHECK_EQUAL(params.m_M, 1);
+}
+
+BOOST_AUTO_TEST_CASE(blockfilter_management_test)
+{
+    const CScript role_script = CScript() << std::vector<unsigned char>(33, 1) << OP_CHECKSIG;
+    const CScript policy_script = CScript() << std::vector<unsigned char>(33, 2) << OP_CHECKSIG;
+    const CScript coin_script = CScript() << std::vector<unsigned char>(33, 3) << OP_CHECKSIG;
+    const CScript spent_role_script = CScript() << std::vector<unsigned char>(33, 4) << OP_CHECKSIG;
+    const CScript spent_coin_script = CScript() << std::vector<unsigned char>(33, 5) << OP_CHECKSIG;
+    const CScript null_data_script = CScript() << OP_RETURN << std::vector<unsigned char>(4, 6);
+
+    CMutableTransaction tx;
+    tx.vout.emplace_back(false, false, false, true, false, false, role_script);
+    tx.vout.emplace_back(true, 1, 0, policy_script);
+    tx.vout.emplace_back(100, coin_script);
+    tx.vout.emplace_back(false, false, false, true, false, false, null_data_script);
+    tx.vout.emplace_back(false, false, false, true, false, false, CScript());
+
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(tx));
+
+    CBlockUndo block_undo;
+    block_undo.vtxundo.emplace_back();
+    block_undo.vtxundo.back().vprevout.emplace_back(CTxOut(false, false, true, false, false, false, spent_role_script), 1, false);
+    block_undo.vtxundo.back().vprevout.emplace_back(CTxOut(100, spent_coin_script), 1, false);
+
+    BlockFilter block_filter(BlockFilterType::MANAGEMENT, block, block_undo);
+    const GCSFilter& filter = block_filter.GetFilter();
+
+    BOOST_CHECK_EQUAL(filter.GetN(), 3);
+    BOOST_CHECK(filter.Match(GCSFilter::Element(role_script.begin(), role_script.end())));
+    BOOST_CHECK(filter.Match(GCSFilter::Element(policy_script.begin(), policy_script.end())));
+    BOOST_CHECK(filter.Match(GCSFilter::Element(spent_role_script.begin(), spent_role_script.end())));
+    BOOST_CHECK(!filter.Match(GCSFilter::Element(coin_script.begin(), coin_script.end())));
+    BOOST_CHECK(!filter.Match(GCSFilter::Element(spent_coin_script.begin(), spent_coin_script.end())));
+    BOOST_CHECK(!filter.Match(GCSFilter::Element(null_data_script.begin(), null_data_script.end())));
+
+    // Reconstruct the filter from parts
+    BlockFilter block_filter2(block_filter.GetFilterType(), block_filter.GetBlockHash(),
+                              block_filter.GetEncodedFilter());
+    BOOST_CHECK(block_filter2.GetFilterType() == block_filter.GetFilterType());
+    BOOST_CHECK_EQUAL(block_filter2.GetBlockHash(), block_filter.GetBlockHash());
+    BOOST_CHECK(block_filter2.GetEncodedFilter() == block_filter.GetEncodedFilter());
+    BOOST_CHECK_EQUAL(block_filter2.GetHash(), block_filter.GetHash());
+
+    // The serialization is the payload of the cfilter message
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << block_filter;
+    BOOST_CHECK_EQUAL(stream[0], static_cast<char>(BlockFilterType::MANAGEMENT));
+    BlockFilter block_filter3;
+    stream >> block_filter3;
+    BOOST_CHECK(block_filter3.GetFilterType() == block_filter.GetFilterType());
+    BOOST_CHECK_EQUAL(block_filter3.GetBlockHash(), block_filter.GetBlockHash());
+    BOOST_CHECK(block_filter3.GetEncodedFilter() == block_filter.GetEncodedFilter());
+
+    // The header commits to the previous one
+    uint256 prev_header;
+    const uint256 header = block_filter.ComputeHeader(prev_header);
+    BOOST_CHECK(header != block_filter.ComputeHeader(header));
+    BOOST_CHECK_EQUAL(header, block_filter2.ComputeHeader(prev_header));
+
+    // A block without management outputs has an empty filter
+    CMutableTransaction coin_tx;
+    coin_tx.vout.emplace_back(100, coin_script);
+    CBlock coin_block;
+    coin_block.vtx.push_back(MakeTransactionRef(coin_tx));
+    BlockFilter coin_filter(BlockFilterType::MANAGEMENT, coin_block, CBlockUndo());
+    BOOST_CHECK_EQUAL(coin_filter.GetFilter().GetN(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(blockfilter_type_names)
+{
+    BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::MANAGEMENT), "management");
+    BOOST_CHECK_EQUAL(BlockFilterTypeName(static_cast<BlockFilterType>(0)), "");
+
+    BlockFilterType filter_type;
+    BOOST_CHECK(BlockFilterTypeByName("management", filter_type));
+    BOOST_CHECK(filter_type == BlockFilterType::MANAGEMENT);
+    BOOST_CHECK(!BlockFilterTypeByName("basic", filter_type));
+
+    BOOST_CHECK_THROW(BlockFilter(BlockFilterType::INVALID, uint256(), std::vector<unsigned char>()), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
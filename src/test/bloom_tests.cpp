@@ -536,4 +536,41 @@ BOOST_AUTO_TEST_CASE(rolling_bloom)
     }
 }
 
+BOOST_AUTO_TEST_CASE(rolling_bloom_hash_batches)
+{
+    // last-100-entry, 1% false positive, and last-1000-entry at a rate
+    // low enough to need the maximum of 50 hash functions:
+    CRollingBloomFilter rb1(100, 0.01);
+    CRollingBloomFilter rb2(1000, 0.000000000000001);
+
+    static const int DATASIZE=2999;
+    std::vector<std::vector<unsigned char>> data(DATASIZE);
+    for (int i = 0; i < DATASIZE; i++) {
+        data[i] = RandomData();
+        rb1.insert(data[i]);
+        rb2.insert(data[i]);
+        BOOST_CHECK(rb1.contains(data[i]));
+        BOOST_CHECK(rb2.contains(data[i]));
+    }
+    for (int i = DATASIZE - 100; i < DATASIZE; i++) {
+        BOOST_CHECK(rb1.contains(data[i]));
+    }
+    for (int i = DATASIZE - 1000; i < DATASIZE; i++) {
+        BOOST_CHECK(rb2.contains(data[i]));
+    }
+
+    // The filters are sized for the requested rate when they are as full as
+    // possible, as they are now.
+    unsigned int nHits1 = 0, nHits2 = 0;
+    for (int i = 0; i < 10000; i++) {
+        std::vector<unsigned char> d = RandomData();
+        nHits1 += rb1.contains(d);
+        nHits2 += rb2.contains(d);
+    }
+    BOOST_TEST_MESSAGE("RollingBloomFilter got " << nHits1 << " false positives (~100 expected)");
+    BOOST_CHECK(nHits1 > 25);
+    BOOST_CHECK(nHits1 < 175);
+    BOOST_CHECK(nHits2 < 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
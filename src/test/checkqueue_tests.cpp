@@ -125,6 +125,27 @@ struct FrozenCleanupCheck {
     void swap(FrozenCleanupCheck& x){std::swap(should_freeze, x.should_freeze);};
 };
 
+struct BatchCheck {
+    static std::atomic<size_t> n_checks;
+    static std::atomic<size_t> n_batches;
+    bool operator()()
+    {
+        n_checks.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    void swap(BatchCheck& x){};
+};
+
+// The queue runs the batches of BatchCheck through this overload
+bool RunCheckBatch(std::vector<BatchCheck>& vChecks)
+{
+    BatchCheck::n_batches.fetch_add(1, std::memory_order_relaxed);
+    for (BatchCheck& check : vChecks) {
+        if (!check()) return false;
+    }
+    return true;
+}
+
 // Static Allocations
 std::mutex FrozenCleanupCheck::m{};
 std::atomic<uint64_t> FrozenCleanupCheck::nFrozen{0};
@@ -133,6 +154,8 @@ std::mutex UniqueCheck::m;
 std::unordered_multiset<size_t> UniqueCheck::results;
 std::atomic<size_t> FakeCheckCheckCompletion::n_calls{0};
 std::atomic<size_t> MemoryCheck::fake_allocated_memory{0};
+std::atomic<size_t> BatchCheck::n_checks{0};
+std::atomic<size_t> BatchCheck::n_batches{0};
 
 // Queue Typedefs
 typedef CCheckQueue<FakeCheckCheckCompletion> Correct_Queue;
@@ -141,6 +164,7 @@ typedef CCheckQueue<FailingCheck> Failing_Queue;
 typedef CCheckQueue<UniqueCheck> Unique_Queue;
 typedef CCheckQueue<MemoryCheck> Memory_Queue;
 typedef CCheckQueue<FrozenCleanupCheck> FrozenCleanup_Queue;
+typedef CCheckQueue<BatchCheck> Batch_Queue;
 
 
 /** This test case checks that the CCheckQueue works properly
@@ -441,5 +465,28 @@ BOOST_AUTO_TEST_CASE(test_CheckQueueControl_Locks)
         tg.join_all();
     }
 }
+
+/** Test that the workers run the checks through the batch overload of the check type */
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Batch_Overload)
+{
+    auto queue = std::unique_ptr<Batch_Queue>(new Batch_Queue {QUEUE_BATCH_SIZE});
+    boost::thread_group tg;
+    for (auto x = 0; x < nScriptCheckThreads; ++x) {
+       tg.create_thread([&]{queue->Thread();});
+    }
+    BatchCheck::n_checks = 0;
+    BatchCheck::n_batches = 0;
+    {
+        CCheckQueueControl<BatchCheck> control(queue.get());
+        std::vector<BatchCheck> vChecks(1000);
+        control.Add(vChecks);
+        BOOST_REQUIRE(control.Wait());
+    }
+    BOOST_CHECK_EQUAL(BatchCheck::n_checks, 1000U);
+    BOOST_CHECK(BatchCheck::n_batches >= 1000U / QUEUE_BATCH_SIZE);
+    BOOST_CHECK(BatchCheck::n_batches <= 1000U);
+    tg.interrupt_all();
+    tg.join_all();
+}
 BOOST_AUTO_TEST_SUITE_END()
 
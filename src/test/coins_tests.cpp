@@ -6,6 +6,9 @@
 #include <uint256.h>
 #include <coins.h>
 #include <undo.h>
+#include <compressor.h>
+#include <dbwrapper.h>
+#include <txdb.h>
 #include <utilstrencodings.h>
 #include <test/test_bitcoin.h>
 #include <validation.h>
@@ -13,6 +16,7 @@
 
 #include <vector>
 #include <map>
+#include <set>
 
 #include <boost/test/unit_test.hpp>
 
@@ -477,7 +481,7 @@ BOOST_AUTO_TEST_CASE(updatecoins_simulation_test)
 BOOST_AUTO_TEST_CASE(ccoins_serialization)
 {
     // Good example
-    CDataStream ss1(ParseHex("97f23c835800816115944e077fe7c803cfa57f29b36bf87c1d35"), SER_DISK, CLIENT_VERSION);
+    CDataStream ss1(ParseHex("97f23c916100816115944e077fe7c803cfa57f29b36bf87c1d35"), SER_DISK, CLIENT_VERSION);
     Coin cc1;
     ss1 >> cc1;
     BOOST_CHECK_EQUAL(cc1.fCoinBase, false);
@@ -486,7 +490,7 @@ BOOST_AUTO_TEST_CASE(ccoins_serialization)
     BOOST_CHECK_EQUAL(HexStr(cc1.out.scriptPubKey), HexStr(GetScriptForDestination(CKeyID(uint160(ParseHex("816115944e077fe7c803cfa57f29b36bf87c1d35"))))));
 
     // Good example
-    CDataStream ss2(ParseHex("8ddf77bbd123008c988f1a4a4de2161e0f50aac7f17e7f9555caa4"), SER_DISK, CLIENT_VERSION);
+    CDataStream ss2(ParseHex("8ddf7780f1c80d008c988f1a4a4de2161e0f50aac7f17e7f9555caa4"), SER_DISK, CLIENT_VERSION);
     Coin cc2;
     ss2 >> cc2;
     BOOST_CHECK_EQUAL(cc2.fCoinBase, true);
@@ -495,7 +499,7 @@ BOOST_AUTO_TEST_CASE(ccoins_serialization)
     BOOST_CHECK_EQUAL(HexStr(cc2.out.scriptPubKey), HexStr(GetScriptForDestination(CKeyID(uint160(ParseHex("8c988f1a4a4de2161e0f50aac7f17e7f9555caa4"))))));
 
     // Smallest possible example
-    CDataStream ss3(ParseHex("000006"), SER_DISK, CLIENT_VERSION);
+    CDataStream ss3(ParseHex("000106"), SER_DISK, CLIENT_VERSION);
     Coin cc3;
     ss3 >> cc3;
     BOOST_CHECK_EQUAL(cc3.fCoinBase, false);
@@ -504,7 +508,7 @@ BOOST_AUTO_TEST_CASE(ccoins_serialization)
     BOOST_CHECK_EQUAL(cc3.out.scriptPubKey.size(), 0);
 
     // scriptPubKey that ends beyond the end of the stream
-    CDataStream ss4(ParseHex("000007"), SER_DISK, CLIENT_VERSION);
+    CDataStream ss4(ParseHex("000107"), SER_DISK, CLIENT_VERSION);
     try {
         Coin cc4;
         ss4 >> cc4;
@@ -517,7 +521,7 @@ BOOST_AUTO_TEST_CASE(ccoins_serialization)
     uint64_t x = 3000000000ULL;
     tmp << VARINT(x);
     BOOST_CHECK_EQUAL(HexStr(tmp.begin(), tmp.end()), "8a95c0bb00");
-    CDataStream ss5(ParseHex("00008a95c0bb00"), SER_DISK, CLIENT_VERSION);
+    CDataStream ss5(ParseHex("00018a95c0bb00"), SER_DISK, CLIENT_VERSION);
     try {
         Coin cc5;
         ss5 >> cc5;
@@ -526,6 +530,191 @@ BOOST_AUTO_TEST_CASE(ccoins_serialization)
     }
 }
 
+namespace
+{
+//! Coin record as written before COIN_DB_VERSION 1
+struct LegacyCoinRecord
+{
+    Coin coin;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        uint32_t code = coin.nHeight * 2 + coin.fCoinBase;
+        ::Serialize(s, VARINT(code));
+        ::Serialize(s, CTxOutCompressor(REF(coin.out)));
+    }
+};
+}
+
+BOOST_AUTO_TEST_CASE(coins_upgrade_encoding)
+{
+    fs::path path = fs::temp_directory_path() / strprintf("test_bitcoin_coins_%lu_%i", (unsigned long)GetTime(), (int)InsecureRandRange(100000));
+    fs::create_directories(path);
+    gArgs.ForceSetArg("-datadir", path.string());
+    ClearDatadirCache();
+
+    std::vector<std::pair<COutPoint, Coin>> coins;
+    CScript script = CScript() << OP_TRUE;
+    coins.emplace_back(COutPoint(InsecureRand256(), 0), Coin(CTxOut(50 * COIN, script), 1, true));
+    coins.emplace_back(COutPoint(InsecureRand256(), 0), Coin(CTxOut(false, false, false, true, false, false, script), 2, false));
+    coins.emplace_back(COutPoint(InsecureRand256(), 3), Coin(CTxOut(true, false, false, true, false, false, script), 3, false));
+    coins.emplace_back(COutPoint(InsecureRand256(), 1), Coin(CTxOut(true, 1, 7, script), 4, false));
+
+    {
+        CDBWrapper db(GetDataDir() / "chainstate", 1 << 20, false, false, true);
+        CDBBatch batch(db);
+        for (const auto& entry : coins) {
+            batch.Write(std::make_pair('C', std::make_pair(entry.first.hash, VARINT(entry.first.n))), LegacyCoinRecord{entry.second});
+        }
+        BOOST_CHECK(db.WriteBatch(batch));
+    }
+
+    {
+        CCoinsViewDB view(1 << 20);
+        BOOST_CHECK(view.Upgrade());
+        for (const auto& entry : coins) {
+            Coin coin;
+            BOOST_CHECK(view.GetCoin(entry.first, coin));
+            BOOST_CHECK(coin == entry.second);
+        }
+    }
+
+    // Upgraded coins are not converted again
+    {
+        CCoinsViewDB view(1 << 20);
+        BOOST_CHECK(view.Upgrade());
+        for (const auto& entry : coins) {
+            Coin coin;
+            BOOST_CHECK(view.GetCoin(entry.first, coin));
+            BOOST_CHECK(coin == entry.second);
+        }
+    }
+
+    gArgs.ForceSetArg("-datadir", "");
+    ClearDatadirCache();
+    fs::remove_all(path);
+}
+
+BOOST_AUTO_TEST_CASE(coins_cursor_start)
+{
+    CCoinsViewDB view(1 << 20, true);
+    std::set<COutPoint> outpoints;
+    CCoinsMap map;
+    for (int i = 0; i < 500; i++) {
+        COutPoint outpoint(InsecureRand256(), InsecureRandBits(2));
+        outpoints.insert(outpoint);
+        CCoinsCacheEntry entry;
+        entry.coin = Coin(CTxOut(InsecureRandRange(MAX_MONEY), CScript() << OP_TRUE), 1, false);
+        entry.flags = CCoinsCacheEntry::DIRTY;
+        map.emplace(outpoint, std::move(entry));
+    }
+    BOOST_CHECK(view.BatchWrite(map, InsecureRand256()));
+
+    // Every cursor sees exactly the coins from the first output of hashStart on, in order
+    std::vector<uint256> starts = {uint256(), outpoints.begin()->hash, outpoints.rbegin()->hash, InsecureRand256()};
+    uint256 last;
+    memset(last.begin(), 0xff, last.size());
+    starts.push_back(last);
+    for (const uint256& hashStart : starts) {
+        std::unique_ptr<CCoinsViewCursor> cursor(view.Cursor(hashStart));
+        BOOST_CHECK(cursor->GetBestBlock() == view.GetBestBlock());
+        auto it = outpoints.lower_bound(COutPoint(hashStart, 0));
+        for (; cursor->Valid(); cursor->Next(), ++it) {
+            COutPoint key;
+            BOOST_CHECK(cursor->GetKey(key));
+            BOOST_REQUIRE(it != outpoints.end());
+            BOOST_CHECK(key == *it);
+        }
+        BOOST_CHECK(it == outpoints.end());
+    }
+}
+
+/** Counts the lookups that reach the database */
+class CCoinsViewReadCounter : public CCoinsViewBacked
+{
+public:
+    explicit CCoinsViewReadCounter(CCoinsView* view) : CCoinsViewBacked(view) {}
+    bool GetCoin(const COutPoint& outpoint, Coin& coin) const override
+    {
+        nReads++;
+        return CCoinsViewBacked::GetCoin(outpoint, coin);
+    }
+
+    mutable int nReads = 0;
+};
+
+BOOST_AUTO_TEST_CASE(credential_cache)
+{
+    LOCK(cs_main);
+    CCoinsViewTest base;
+    CCoinsViewReadCounter counter(&base);
+    CCoinsViewCredentials credentials(&counter, 2);
+
+    auto credential = [](const CKey& key) {
+        return Coin(CTxOut(false, false, false, true, false, false, GetScriptForDestination(key.GetPubKey().GetID())), 1, false);
+    };
+    CKey keyA, keyB, keyC;
+    keyA.MakeNewKey(true);
+    keyB.MakeNewKey(true);
+    keyC.MakeNewKey(true);
+
+    // Only the credentials written through the view are pinned
+    const COutPoint outA1(InsecureRand256(), 0), outCoin(InsecureRand256(), 1);
+    {
+        CCoinsViewCache cache(&credentials);
+        cache.AddCoin(outA1, credential(keyA), false);
+        cache.AddCoin(outCoin, Coin(CTxOut(50 * COIN, GetScriptForDestination(keyA.GetPubKey().GetID())), 1, false), false);
+        BOOST_CHECK(cache.Flush());
+    }
+    BOOST_CHECK_EQUAL(credentials.GetPinnedCount(), 1U);
+    {
+        CCoinsViewCache cache(&credentials);
+        BOOST_CHECK(!cache.AccessCoin(outA1).IsSpent());
+        BOOST_CHECK_EQUAL(counter.nReads, 0);
+        BOOST_CHECK(!cache.AccessCoin(outCoin).IsSpent());
+        BOOST_CHECK_EQUAL(counter.nReads, 1);
+        BOOST_CHECK_EQUAL(credentials.GetHits(), 1U);
+    }
+
+    // Spending the credential replaces it with the role repeat
+    const COutPoint outA2(InsecureRand256(), 0);
+    {
+        CCoinsViewCache cache(&credentials);
+        BOOST_CHECK(cache.SpendCoin(outA1));
+        cache.AddCoin(outA2, credential(keyA), false);
+        BOOST_CHECK(cache.Flush());
+    }
+    BOOST_CHECK_EQUAL(credentials.GetPinnedCount(), 1U);
+    Coin coin;
+    BOOST_CHECK(credentials.GetCoin(outA2, coin));
+    BOOST_CHECK(coin == credential(keyA));
+    BOOST_CHECK_EQUAL(counter.nReads, 1);
+
+    // Once full, the least active account makes room for the new one
+    const COutPoint outB(InsecureRand256(), 0), outC(InsecureRand256(), 0);
+    {
+        CCoinsViewCache cache(&credentials);
+        cache.AddCoin(outB, credential(keyB), false);
+        BOOST_CHECK(cache.Flush());
+        cache.AddCoin(outC, credential(keyC), false);
+        BOOST_CHECK(cache.Flush());
+    }
+    BOOST_CHECK_EQUAL(credentials.GetPinnedCount(), 2U);
+    BOOST_CHECK(credentials.GetCoin(outA2, coin));
+    BOOST_CHECK(credentials.GetCoin(outC, coin));
+    BOOST_CHECK_EQUAL(counter.nReads, 1);
+    BOOST_CHECK(credentials.GetCoin(outB, coin));
+    BOOST_CHECK_EQUAL(counter.nReads, 2);
+
+    // The spent credential was unpinned, the base view may keep it as spent
+    BOOST_CHECK(!credentials.GetCoin(outA1, coin) || coin.IsSpent());
+
+    // Disabled, nothing is pinned
+    CCoinsViewCredentials disabled(&counter, 0);
+    BOOST_CHECK(disabled.GetCoin(outA2, coin));
+    BOOST_CHECK_EQUAL(disabled.GetPinnedCount(), 0U);
+}
+
 const static COutPoint OUTPOINT;
 const static CAmount PRUNED = -1;
 const static CAmount ABSENT = -2;
@@ -3,10 +3,13 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <compressor.h>
+#include <streams.h>
+#include <utilstrencodings.h>
 #include <util.h>
 #include <test/test_bitcoin.h>
 
 #include <stdint.h>
+#include <version.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -62,4 +65,36 @@ BOOST_AUTO_TEST_CASE(compress_amounts)
         BOOST_CHECK(TestDecode(i));
 }
 
+bool static TestCoinTxOut(CTxOut txout, const std::string& hex) {
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << CCoinTxOutCompressor(txout);
+    BOOST_CHECK_EQUAL(HexStr(ss.begin(), ss.end()), hex);
+    CTxOut decoded;
+    ss >> REF(CCoinTxOutCompressor(decoded));
+    return ss.empty() && decoded == txout && HexStr(txout.scriptPubKey) == HexStr(decoded.scriptPubKey);
+}
+
+BOOST_AUTO_TEST_CASE(compress_coin_txouts)
+{
+    const CScript empty;
+
+    // Coin transfers: compressed amount above the type bits
+    BOOST_CHECK(TestCoinTxOut(CTxOut(0, empty), "0106"));
+    BOOST_CHECK(TestCoinTxOut(CTxOut(COIN, empty), "2506"));
+    BOOST_CHECK(TestCoinTxOut(CTxOut(50 * COIN, empty), "804906"));
+
+    // Role changes: the role bits above the type bits
+    BOOST_CHECK(TestCoinTxOut(CTxOut(false, false, false, true, false, false, empty), "1206"));
+    BOOST_CHECK(TestCoinTxOut(CTxOut(false, false, false, true, true, true, empty), "1e06"));
+    BOOST_CHECK(TestCoinTxOut(CTxOut(true, false, false, true, false, false, empty), "801206"));
+
+    // Policy changes: the raw policy bits
+    BOOST_CHECK(TestCoinTxOut(CTxOut(true, 1, 0, empty), "0f06"));
+
+    // Reserved role bits do not fit and are escaped
+    CTxOut reserved(false, false, false, true, false, false, empty);
+    reserved.nRole.nReserved = (1ULL << 58) - 1; // all the bits of the 58-bit field
+    BOOST_CHECK(TestCoinTxOut(reserved, "000280fefefefefefefefe4406"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
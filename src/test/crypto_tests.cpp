@@ -10,6 +10,7 @@
 #include <crypto/sha512.h>
 #include <crypto/hmac_sha256.h>
 #include <crypto/hmac_sha512.h>
+#include <hash.h>
 #include <random.h>
 #include <utilstrencodings.h>
 #include <test/test_bitcoin.h>
@@ -20,6 +21,14 @@
 #include <openssl/aes.h>
 #include <openssl/evp.h>
 
+namespace leveldb {
+namespace crc32c {
+// From leveldb/util/crc32c.h, which is not on the include path. It uses the
+// SSE4.2 implementation from port_posix_sse.cc when the CPU supports it.
+uint32_t Extend(uint32_t init_crc, const char* data, size_t n);
+}
+}
+
 BOOST_FIXTURE_TEST_SUITE(crypto_tests, BasicTestingSetup)
 
 template<typename Hasher, typename In, typename Out>
@@ -546,4 +555,80 @@ BOOST_AUTO_TEST_CASE(countbits_tests)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256d64)
+{
+    // Cover every combination of the 8-, 4-, 2- and 1-way implementations
+    for (int i = 0; i <= 32; ++i) {
+        unsigned char in[64 * 32];
+        unsigned char out1[32 * 32], out2[32 * 32];
+        for (int j = 0; j < 64 * i; ++j) {
+            in[j] = InsecureRandBits(8);
+        }
+        for (int j = 0; j < i; ++j) {
+            CHash256().Write(in + 64 * j, 64).Finalize(out1 + 32 * j);
+        }
+        SHA256D64(out2, in, i);
+        BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
+    }
+}
+
+static uint32_t CRC32C(const std::vector<unsigned char>& data, size_t offset = 0)
+{
+    return leveldb::crc32c::Extend(0, (const char*)data.data() + offset, data.size() - offset);
+}
+
+/** Bit at a time CRC32C, to check the table and SSE4.2 implementations against */
+static uint32_t CRC32CBitwise(const unsigned char* data, size_t len)
+{
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (crc & 1 ? 0x82f63b78 : 0);
+        }
+    }
+    return crc ^ 0xffffffff;
+}
+
+BOOST_AUTO_TEST_CASE(crc32c_testvectors)
+{
+    // RFC 3720 B.4, and the usual check value
+    BOOST_CHECK_EQUAL(CRC32C(std::vector<unsigned char>(32, 0x00)), 0x8a9136aaU);
+    BOOST_CHECK_EQUAL(CRC32C(std::vector<unsigned char>(32, 0xff)), 0x62a8ab43U);
+    std::vector<unsigned char> ascending(32);
+    for (int i = 0; i < 32; i++) ascending[i] = i;
+    BOOST_CHECK_EQUAL(CRC32C(ascending), 0x46dd794eU);
+    BOOST_CHECK_EQUAL(CRC32C(std::vector<unsigned char>{'1', '2', '3', '4', '5', '6', '7', '8', '9'}), 0xe3069283U);
+
+    // Long enough for the three-way implementation with 128 (384 bytes) and
+    // 1024 (3072 bytes) byte streams, and both followed by a tail
+    std::vector<unsigned char> pattern(3 * 1024 + 3 * 128 + 13);
+    for (size_t i = 0; i < pattern.size(); i++) pattern[i] = i * 7 + 1;
+    const std::vector<std::pair<size_t, uint32_t>> vectors = {
+        {384, 0x4e6d6a38}, {3072, 0x57288461}, {pattern.size(), 0x0371de12}
+    };
+    for (const auto& vector : vectors) {
+        BOOST_CHECK_EQUAL(CRC32C(std::vector<unsigned char>(vector.first, 0)),
+                          CRC32CBitwise(std::vector<unsigned char>(vector.first, 0).data(), vector.first));
+        BOOST_CHECK_EQUAL(CRC32C(std::vector<unsigned char>(pattern.begin(), pattern.begin() + vector.first)), vector.second);
+    }
+    BOOST_CHECK_EQUAL(CRC32C(std::vector<unsigned char>(384, 0)), 0xbaf62f36U);
+    BOOST_CHECK_EQUAL(CRC32C(std::vector<unsigned char>(3072, 0)), 0x20ad41a3U);
+
+    // Every alignment, and sizes around the stream boundaries
+    std::vector<unsigned char> data(2 * 3 * 1024 + 3 * 128 + 64);
+    for (unsigned char& c : data) c = InsecureRandBits(8);
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t len : {383, 384, 385, 767, 768, 3071, 3072, 3073, 3072 + 384, 6144 + 391}) {
+            std::vector<unsigned char> buffer(data.begin(), data.begin() + offset + len);
+            BOOST_CHECK_EQUAL(CRC32C(buffer, offset), CRC32CBitwise(buffer.data() + offset, len));
+        }
+    }
+
+    // Extending a CRC over pieces gives the CRC of the whole
+    const char* chars = (const char*)data.data();
+    BOOST_CHECK_EQUAL(leveldb::crc32c::Extend(leveldb::crc32c::Extend(0, chars, 1000), chars + 1000, data.size() - 1000),
+                      CRC32CBitwise(data.data(), data.size()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -6,6 +6,7 @@
 #include <script/sigcache.h>
 #include <test/test_bitcoin.h>
 #include <random.h>
+#include <set>
 #include <thread>
 
 /** Test Suite for CuckooCache
@@ -377,4 +378,75 @@ BOOST_AUTO_TEST_CASE(cuckoocache_generations)
     test_cache_generations<CuckooCache::cache<uint256, SignatureCacheHasher>>();
 }
 
+/** An element that compares equal by its key, and carries a value */
+struct KeyValue {
+    uint256 key;
+    uint32_t value;
+    bool operator==(const KeyValue& other) const { return key == other.key; }
+};
+
+struct KeyValueHasher {
+    template <uint8_t hash_select>
+    uint32_t operator()(const KeyValue& e) const
+    {
+        return SignatureCacheHasher().operator()<hash_select>(e.key);
+    }
+};
+
+/* Test that find brings back the value stored along with the key */
+BOOST_AUTO_TEST_CASE(cuckoocache_find)
+{
+    local_rand_ctx = FastRandomContext(true);
+    CuckooCache::cache<KeyValue, KeyValueHasher> cc{};
+    cc.setup_bytes(1 << 20);
+    std::vector<KeyValue> entries(1000);
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        insecure_GetRandHash(entries[i].key);
+        entries[i].value = i;
+        cc.insert(entries[i]);
+    }
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        KeyValue e;
+        e.key = entries[i].key;
+        e.value = 0xffffffff;
+        BOOST_CHECK(cc.find(e, false));
+        BOOST_CHECK_EQUAL(e.value, i);
+    }
+    KeyValue missing;
+    insecure_GetRandHash(missing.key);
+    missing.value = 0xffffffff;
+    BOOST_CHECK(!cc.find(missing, false));
+    BOOST_CHECK_EQUAL(missing.value, 0xffffffff);
+}
+
+/* Test that for_each visits the live elements only, and that they can be
+ * inserted into another cache */
+BOOST_AUTO_TEST_CASE(cuckoocache_for_each)
+{
+    local_rand_ctx = FastRandomContext(true);
+    CuckooCache::cache<uint256, SignatureCacheHasher> cc{};
+    cc.setup_bytes(1 << 20);
+    std::vector<uint256> hashes(1000);
+    for (uint256& h : hashes) {
+        insecure_GetRandHash(h);
+        cc.insert(h);
+    }
+    // Erase the first half
+    for (uint32_t i = 0; i < hashes.size() / 2; ++i)
+        BOOST_CHECK(cc.contains(hashes[i], true));
+
+    std::set<uint256> visited;
+    cc.for_each([&visited](const uint256& h) { visited.insert(h); });
+    BOOST_CHECK_EQUAL(visited.size(), hashes.size() / 2);
+    for (uint32_t i = 0; i < hashes.size(); ++i)
+        BOOST_CHECK_EQUAL(visited.count(hashes[i]), i < hashes.size() / 2 ? 0U : 1U);
+
+    CuckooCache::cache<uint256, SignatureCacheHasher> copy{};
+    copy.setup_bytes(1 << 20);
+    for (const uint256& h : visited)
+        copy.insert(h);
+    for (uint32_t i = 0; i < hashes.size(); ++i)
+        BOOST_CHECK_EQUAL(copy.contains(hashes[i], false), i >= hashes.size() / 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -197,6 +197,43 @@ BOOST_AUTO_TEST_CASE(existing_data_reindex)
     BOOST_CHECK_EQUAL(res3.ToString(), in2.ToString());
 }
 
+// Test the read counters, and that the checksum level controls verification.
+BOOST_AUTO_TEST_CASE(dbwrapper_read_stats)
+{
+    for (int nChecksums : {0, DEFAULT_DB_CHECKSUMS}) {
+        fs::path ph = fs::temp_directory_path() / fs::unique_path();
+        create_directories(ph);
+
+        std::unique_ptr<CDBWrapper> dbw = MakeUnique<CDBWrapper>(ph, (1 << 10), false, false, false, nChecksums);
+        for (uint32_t i = 0; i < 1000; i++) {
+            BOOST_CHECK(dbw->Write(i, uint256()));
+        }
+        // Reopen, so that the values are read from a table rather than the log
+        dbw.reset();
+        dbw = MakeUnique<CDBWrapper>(ph, (1 << 10), false, false, false, nChecksums);
+        const DBReadStats before = dbw->GetReadStats();
+
+        uint256 res;
+        for (uint32_t i = 0; i < 1000; i += 10) {
+            BOOST_CHECK(dbw->Read(i, res));
+        }
+        BOOST_CHECK(!dbw->Exists(uint32_t{1000}));
+
+        const DBReadStats after = dbw->GetReadStats();
+        BOOST_CHECK_EQUAL(after.nReads - before.nReads, 101U);
+        BOOST_CHECK_EQUAL(after.nReadBytes - before.nReadBytes, 100U * 32);
+        BOOST_CHECK(after.nBlocks > before.nBlocks);
+        BOOST_CHECK(after.nBlockBytes >= after.nReadBytes - before.nReadBytes);
+        if (nChecksums == 0) {
+            BOOST_CHECK_EQUAL(after.nChecksumBytes, 0U);
+        } else {
+            // Every block was verified, except for the 4 byte checksum itself
+            const uint64_t nBlocks = after.nBlocks - before.nBlocks;
+            BOOST_CHECK_EQUAL(after.nChecksumBytes - before.nChecksumBytes + 4 * nBlocks, after.nBlockBytes - before.nBlockBytes);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(iterator_ordering)
 {
     fs::path ph = fs::temp_directory_path() / fs::unique_path();
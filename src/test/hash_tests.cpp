@@ -45,6 +45,29 @@ BOOST_AUTO_TEST_CASE(murmurhash3)
 #undef T
 }
 
+BOOST_AUTO_TEST_CASE(murmurhash3_batch)
+{
+    // Check consistency between MurmurHash3 and MurmurHash3Batch, for every
+    // batch size the vectorized and scalar paths split into, and for lengths
+    // with every tail size.
+    for (size_t len = 0; len <= 40; len++) {
+        std::vector<unsigned char> data(len);
+        for (unsigned char& c : data) {
+            c = InsecureRandBits(8);
+        }
+        for (size_t n = 0; n <= 20; n++) {
+            std::vector<uint32_t> seeds(n), out(n);
+            for (uint32_t& seed : seeds) {
+                seed = InsecureRand32();
+            }
+            MurmurHash3Batch(seeds.data(), data.data(), data.size(), out.data(), n);
+            for (size_t i = 0; i < n; i++) {
+                BOOST_CHECK_EQUAL(out[i], MurmurHash3(seeds[i], data));
+            }
+        }
+    }
+}
+
 /*
    SipHash-2-4 output with
    k = 00 01 02 ...
@@ -145,6 +168,25 @@ BOOST_AUTO_TEST_CASE(siphash)
         BOOST_CHECK_EQUAL(SipHashUint256(k1, k2, x), sip256.Finalize());
         BOOST_CHECK_EQUAL(SipHashUint256Extra(k1, k2, x, n), sip288.Finalize());
     }
+
+    // Check consistency between SipHashUint256 and SipHashUint256Batch, for
+    // batch sizes covering every mix of the 8-way, 4-way and single paths.
+    for (size_t n = 0; n <= 20; ++n) {
+        uint64_t k1 = ctx.rand64();
+        uint64_t k2 = ctx.rand64();
+        std::vector<uint256> vals(n);
+        std::vector<const uint256*> ptrs(n);
+        for (size_t i = 0; i < n; ++i) {
+            vals[i] = InsecureRand256();
+            ptrs[i] = &vals[i];
+        }
+        std::vector<uint64_t> out(n + 1, 0);
+        SipHashUint256Batch(k1, k2, ptrs.data(), out.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            BOOST_CHECK_EQUAL(out[i], SipHashUint256(k1, k2, vals[i]));
+        }
+        BOOST_CHECK_EQUAL(out[n], 0U);
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
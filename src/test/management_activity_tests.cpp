@@ -0,0 +1,81 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/activity.h>
+#include <primitives/block.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(management_activity_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(management_activity_window)
+{
+    CManagementActivity activity(10);
+    BOOST_CHECK(activity.IsEmpty());
+    BOOST_CHECK_EQUAL(activity.GetBlocksCovered(), 0);
+
+    // Blocks 0..19 with h % 3 management transactions each
+    for (int h = 0; h < 20; h++) {
+        activity.Connect(h, h % 3);
+        BOOST_CHECK_EQUAL(activity.GetTipHeight(), h);
+        BOOST_CHECK_EQUAL(activity.GetBlocksCovered(), std::min(h + 1, 10));
+    }
+    // 19..10: 1+0+2+1+0+2+1+0+2+1
+    BOOST_CHECK_EQUAL(activity.GetCount(10), 10);
+    BOOST_CHECK_EQUAL(activity.GetCount(3), 3);
+    BOOST_CHECK_EQUAL(activity.GetCount(1), 1);
+    BOOST_CHECK_EQUAL(activity.GetCount(0), 0);
+
+    // The window is full, nothing can be added below it
+    BOOST_CHECK(!activity.Prepend(activity.GetBaseHeight(), 1));
+
+    // Disconnecting shrinks the window from the top
+    activity.Disconnect(19);
+    activity.Disconnect(18);
+    BOOST_CHECK_EQUAL(activity.GetTipHeight(), 17);
+    BOOST_CHECK_EQUAL(activity.GetBlocksCovered(), 8);
+    BOOST_CHECK_EQUAL(activity.GetCount(8), 9);
+
+    // Older blocks are filled in below
+    BOOST_CHECK_EQUAL(activity.GetBaseHeight(), 9);
+    BOOST_CHECK(!activity.Prepend(8, 2));
+    BOOST_CHECK(activity.Prepend(9, 0));
+    BOOST_CHECK(activity.Prepend(8, 2));
+    BOOST_CHECK(!activity.Prepend(7, 1));
+    BOOST_CHECK_EQUAL(activity.GetCount(10), 11);
+
+    // Reconnect on the new branch
+    activity.Connect(18, 5);
+    BOOST_CHECK_EQUAL(activity.GetCount(1), 5);
+    BOOST_CHECK_EQUAL(activity.GetCount(10), 14);
+
+    // A gap restarts the window, disconnecting below the tip clears it
+    activity.Connect(30, 4);
+    BOOST_CHECK_EQUAL(activity.GetBlocksCovered(), 1);
+    BOOST_CHECK_EQUAL(activity.GetCount(1), 4);
+    activity.Disconnect(29);
+    BOOST_CHECK(activity.IsEmpty());
+
+    // Filling in down to the genesis block
+    activity.Connect(2, 1);
+    BOOST_CHECK(activity.Prepend(1, 1));
+    BOOST_CHECK(activity.Prepend(0, 1));
+    BOOST_CHECK(!activity.Prepend(-1, 1));
+    BOOST_CHECK_EQUAL(activity.GetCount(3), 3);
+}
+
+BOOST_AUTO_TEST_CASE(management_activity_count)
+{
+    CBlock block;
+    for (int32_t nVersion = CTransaction::VERSION_COINBASE_TRANSFER; nVersion <= CTransaction::VERSION_POLICY_CHANGE_FEE; nVersion++) {
+        CMutableTransaction tx;
+        tx.nVersion = nVersion;
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+    // All but the coinbase and coin transfers
+    BOOST_CHECK_EQUAL(CountManagementTransactions(block), 9U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -179,4 +179,75 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ManagedVersionEstimates)
+{
+    CBlockPolicyEstimator feeEst;
+    CTxMemPool mpool(&feeEst);
+    TestMemPoolEntryHelper entry;
+    CAmount fee(20000);
+
+    CScript garbage;
+    for (unsigned int i = 0; i < 128; i++)
+        garbage.push_back('X');
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].scriptSig = garbage;
+    tx.vout.resize(1);
+    tx.vout[0].nValue=0LL;
+    CFeeRate feeRate(fee, GetVirtualTransactionSize(tx));
+
+    // Every block confirms a few coin transfers and many more fee exempt
+    // role changes, all in the next block
+    std::vector<CTransactionRef> block;
+    int blocknum = 0;
+    while (blocknum < 50) {
+        for (int k = 0; k < 25; k++) {
+            tx.nVersion = k < 5 ? CTransaction::VERSION_COIN_TRANSFER : CTransaction::VERSION_ROLE_CHANGE;
+            tx.vin[0].prevout.n = 10000*blocknum+k;
+            mpool.addUnchecked(tx.GetHash(), entry.Fee(k < 5 ? fee : 0).Time(GetTime()).Height(blocknum).FromTx(tx));
+            block.push_back(MakeTransactionRef(tx));
+        }
+        mpool.removeForBlock(block, ++blocknum);
+        block.clear();
+    }
+    BOOST_CHECK_EQUAL(mpool.size(), 0);
+
+    // The role changes do not pull the estimate down to zero
+    FeeCalculation feeCalc;
+    CFeeRate estimate = feeEst.estimateSmartFee(2, &feeCalc, false);
+    BOOST_CHECK(estimate.GetFeePerK() > feeRate.GetFeePerK() * 9 / 10);
+    BOOST_CHECK(estimate.GetFeePerK() <= feeRate.GetFeePerK() * 11 / 10);
+    BOOST_CHECK(feeCalc.reason != FeeReason::POLICY_MIN);
+
+    // The estimate never goes below the policy minimum
+    CFeeRate minFeeRate(feeRate.GetFeePerK() * 3);
+    feeEst.SetMinFeeRate(minFeeRate);
+    BOOST_CHECK(feeEst.estimateSmartFee(2, &feeCalc, false) == minFeeRate);
+    BOOST_CHECK(feeCalc.reason == FeeReason::POLICY_MIN);
+    feeEst.SetMinFeeRate(CFeeRate(0));
+    BOOST_CHECK(feeEst.estimateSmartFee(2, &feeCalc, false) == estimate);
+
+    // Both versions are tracked apart
+    bool fFoundTransfer = false, fFoundRoleChange = false;
+    for (const VersionEstimate& version : feeEst.estimateVersionFees()) {
+        BOOST_CHECK_EQUAL(version.inMempool, 0);
+        if (version.version == CTransaction::VERSION_COIN_TRANSFER) {
+            fFoundTransfer = true;
+            BOOST_CHECK(!version.feeExempt);
+            BOOST_CHECK(version.confirmed > 5);
+            BOOST_CHECK_EQUAL(llround(version.avgFeeRate), feeRate.GetFeePerK());
+            BOOST_CHECK_EQUAL(llround(version.avgBlocks), 1);
+        } else if (version.version == CTransaction::VERSION_ROLE_CHANGE) {
+            fFoundRoleChange = true;
+            BOOST_CHECK(version.feeExempt);
+            BOOST_CHECK(version.confirmed > 20);
+            BOOST_CHECK_EQUAL(llround(version.avgFeeRate), 0);
+        } else {
+            BOOST_CHECK_EQUAL(version.confirmed, 0);
+            BOOST_CHECK(version.avgFeeRate < 0);
+        }
+    }
+    BOOST_CHECK(fFoundTransfer && fFoundRoleChange);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
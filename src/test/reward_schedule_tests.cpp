@@ -0,0 +1,105 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <policy/reward.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(reward_schedule_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(reward_schedule_default_policy)
+{
+    // The default policy halves 50 coins every interval
+    for (int nInterval : {150, 1000, 210000}) {
+        CRewardSchedule schedule(CManagementPolicy::CActivePolicy(), nInterval);
+        for (int nHalvings = 0; nHalvings < 70; nHalvings++) {
+            CAmount nExpected = nHalvings < 64 ? (50 * COIN) >> nHalvings : 0;
+            BOOST_CHECK_EQUAL(schedule.GetSubsidy(nHalvings * nInterval), nExpected);
+            BOOST_CHECK_EQUAL(schedule.GetSubsidy((nHalvings + 1) * nInterval - 1), nExpected);
+        }
+    }
+
+    CRewardSchedule schedule(CManagementPolicy::CActivePolicy(), 150);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(-1), 0);
+    BOOST_CHECK_EQUAL(schedule.GetNextChangeHeight(0), 150);
+    BOOST_CHECK_EQUAL(schedule.GetNextChangeHeight(150), 300);
+    BOOST_CHECK_EQUAL(schedule.GetNextChangeHeight(1000000), -1);
+}
+
+BOOST_AUTO_TEST_CASE(reward_schedule_policy_changes)
+{
+    CManagementPolicy::CActivePolicy policy;
+    CRewardSchedule schedule(policy, 100);
+    const size_t nDefaultSteps = schedule.GetSteps().size();
+
+    // Fixed reward from height 250
+    CManagementPolicy::CActivePolicy fixed = policy;
+    fixed.fBlockRewardAuto = false;
+    fixed.nCurBlockReward = 10 * COIN;
+    schedule.SetPolicy(250, fixed);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(249), 1250000000);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(250), 10 * COIN);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(100000), 10 * COIN);
+    BOOST_CHECK_EQUAL(schedule.GetNextChangeHeight(250), -1);
+
+    // Slower decay with a floor from height 400, decaying from there on
+    CManagementPolicy::CActivePolicy decay = policy;
+    decay.nCurBlockReward = 8 * COIN;
+    decay.nCurBlockRewardDecay = 0.75;
+    decay.nMinBlockReward = 3 * COIN;
+    schedule.SetPolicy(400, decay);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(399), 10 * COIN);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(400), 8 * COIN);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(500), 6 * COIN);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(600), 450000000);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(700), 337500000);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(800), 3 * COIN);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(1000000), 3 * COIN);
+
+    // The decay is capped by nMaxBlockRewardDecay
+    decay.nMaxBlockRewardDecay = 0.5;
+    schedule.SetPolicy(400, decay);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(500), 4 * COIN);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(600), 3 * COIN);
+
+    // Setting a policy below a later one replaces it
+    schedule.SetPolicy(300, fixed);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(500), 10 * COIN);
+
+    // Undo back to the default policy
+    schedule.RemovePoliciesFrom(260);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(300), 10 * COIN);
+    schedule.RemovePoliciesFrom(0);
+    BOOST_CHECK_EQUAL(schedule.GetSteps().size(), nDefaultSteps);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(250), 1250000000);
+    BOOST_CHECK_EQUAL(schedule.GetSubsidy(300), 625000000);
+}
+
+BOOST_AUTO_TEST_CASE(reward_schedule_integer_decay)
+{
+    // 0.9 as a float is 15099494 / 2^24, each step rounds that ratio down.
+    // 50 coins times the ratio fits in 64 bits.
+    CManagementPolicy::CActivePolicy policy;
+    policy.nCurBlockRewardDecay = 0.9f;
+    CRewardSchedule schedule(policy, 10);
+    CAmount nExpected = 50 * COIN;
+    for (int nStep = 0; nStep < 100; nStep++) {
+        BOOST_CHECK_EQUAL(schedule.GetSubsidy(nStep * 10), nExpected);
+        nExpected = nExpected * 15099494 >> 24;
+    }
+
+    // Decays of the same ratio give the same schedule
+    BOOST_CHECK(schedule.IsBuiltFrom(policy, 10));
+    BOOST_CHECK(!schedule.IsBuiltFrom(policy, 11));
+    CManagementPolicy::CActivePolicy capped = policy;
+    capped.nCurBlockRewardDecay = 1.0;
+    capped.nMaxBlockRewardDecay = 0.9f;
+    BOOST_CHECK(schedule.IsBuiltFrom(capped, 10));
+    capped.nMaxBlockRewardDecay = 0.8f;
+    BOOST_CHECK(!schedule.IsBuiltFrom(capped, 10));
+    BOOST_CHECK(!schedule.IsBuiltFrom(CManagementPolicy::CActivePolicy(), 10));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,237 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <script/sigcache.h>
+
+#include <fs.h>
+#include <key.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/interpreter.h>
+#include <script/standard.h>
+#include <serialize.h>
+#include <streams.h>
+#include <util.h>
+#include <validation.h>
+#include <test/test_bitcoin.h>
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(sigcache_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(pubkey_cache)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    CScript scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+
+    CMutableTransaction txCredit;
+    txCredit.vin.resize(1);
+    txCredit.vout.resize(1);
+    txCredit.vout[0].scriptPubKey = scriptPubKey;
+    txCredit.vout[0].nValue = 1;
+    CMutableTransaction txSpend;
+    txSpend.vin.resize(1);
+    txSpend.vin[0].prevout = COutPoint(txCredit.GetHash(), 0);
+    txSpend.vout.resize(1);
+    std::vector<unsigned char> vchSig;
+    BOOST_CHECK(key.Sign(SignatureHash(scriptPubKey, txSpend, 0, SIGHASH_ALL, 1, SIGVERSION_BASE), vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    txSpend.vin[0].scriptSig = CScript() << vchSig << ToByteVector(key.GetPubKey());
+    const CTransaction tx(txSpend);
+    PrecomputedTransactionData txdata(tx);
+
+    // Without storing in the signature cache, each check verifies the
+    // signature again, but only the first one parses the key
+    PubKeyCacheStats before = GetPubKeyCacheStats();
+    for (int i = 0; i < 3; i++) {
+        ScriptError err;
+        BOOST_CHECK(VerifyScript(tx.vin[0].scriptSig, scriptPubKey, nullptr, SCRIPT_VERIFY_P2SH, CachingTransactionSignatureChecker(&tx, 0, 1, false, txdata), &err));
+    }
+    PubKeyCacheStats after = GetPubKeyCacheStats();
+    BOOST_CHECK(after.nCapacity > 0);
+    BOOST_CHECK_EQUAL(after.nMisses - before.nMisses, 1U);
+    BOOST_CHECK_EQUAL(after.nHits - before.nHits, 2U);
+
+    // A cached key still rejects the signatures of other keys
+    CKey other;
+    other.MakeNewKey(true);
+    std::vector<unsigned char> vchOtherSig;
+    BOOST_CHECK(other.Sign(SignatureHash(scriptPubKey, txSpend, 0, SIGHASH_ALL, 1, SIGVERSION_BASE), vchOtherSig));
+    vchOtherSig.push_back((unsigned char)SIGHASH_ALL);
+    CMutableTransaction txBad(txSpend);
+    txBad.vin[0].scriptSig = CScript() << vchOtherSig << ToByteVector(key.GetPubKey());
+    const CTransaction bad(txBad);
+    PrecomputedTransactionData baddata(bad);
+    ScriptError err;
+    BOOST_CHECK(!VerifyScript(bad.vin[0].scriptSig, scriptPubKey, nullptr, SCRIPT_VERIFY_P2SH, CachingTransactionSignatureChecker(&bad, 0, 1, false, baddata), &err));
+    BOOST_CHECK_EQUAL(GetPubKeyCacheStats().nHits - before.nHits, 3U);
+}
+
+BOOST_AUTO_TEST_CASE(sigcache_entries)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    CMutableTransaction txSpend;
+    txSpend.vin.resize(1);
+    const CTransaction tx(txSpend);
+    PrecomputedTransactionData txdata(tx);
+    const CachingTransactionSignatureChecker storing(&tx, 0, 0, true, txdata);
+    const CachingTransactionSignatureChecker checker(&tx, 0, 0, false, txdata);
+    uint256 hash = InsecureRand256();
+    std::vector<unsigned char> vchSig;
+    BOOST_CHECK(key.Sign(hash, vchSig));
+
+    // A signature found in the signature cache skips the public key cache.
+    // Lookups that don't store erase the entry they find, so the entry is
+    // only looked up with the storing checker before it is saved.
+    auto lookups = [] { PubKeyCacheStats stats = GetPubKeyCacheStats(); return stats.nHits + stats.nMisses; };
+    BOOST_CHECK(storing.VerifySignature(vchSig, key.GetPubKey(), hash));
+    uint64_t nLookups = lookups();
+    BOOST_CHECK(storing.VerifySignature(vchSig, key.GetPubKey(), hash));
+    BOOST_CHECK_EQUAL(lookups(), nLookups);
+
+    uint256 nonce;
+    std::vector<uint256> entries;
+    GetSignatureCacheEntries(nonce, entries);
+    BOOST_CHECK(!entries.empty());
+
+    // Erased entries are not saved
+    BOOST_CHECK(checker.VerifySignature(vchSig, key.GetPubKey(), hash));
+    BOOST_CHECK_EQUAL(lookups(), nLookups);
+    uint256 nonceAfter;
+    std::vector<uint256> entriesAfter;
+    GetSignatureCacheEntries(nonceAfter, entriesAfter);
+    BOOST_CHECK(nonceAfter == nonce);
+    BOOST_CHECK_EQUAL(entriesAfter.size(), entries.size() - 1);
+
+    // The entries only match with the salt they were made with
+    SetSignatureCacheEntries(InsecureRand256(), entries);
+    BOOST_CHECK(checker.VerifySignature(vchSig, key.GetPubKey(), hash));
+    BOOST_CHECK_EQUAL(lookups(), nLookups + 1);
+
+    SetSignatureCacheEntries(nonce, entries);
+    BOOST_CHECK(storing.VerifySignature(vchSig, key.GetPubKey(), hash));
+    BOOST_CHECK_EQUAL(lookups(), nLookups + 1);
+}
+
+static std::vector<unsigned char> ReadCacheFile()
+{
+    std::vector<unsigned char> data;
+    FILE* file = fsbridge::fopen(GetDataDir() / "sigcache.dat", "rb");
+    BOOST_REQUIRE(file);
+    unsigned char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    fclose(file);
+    return data;
+}
+
+static void WriteCacheFile(const std::vector<unsigned char>& data)
+{
+    FILE* file = fsbridge::fopen(GetDataDir() / "sigcache.dat", "wb");
+    BOOST_REQUIRE(file);
+    BOOST_REQUIRE_EQUAL(fwrite(data.data(), 1, data.size(), file), data.size());
+    fclose(file);
+}
+
+/** Check that loading the cache file fails and leaves the caches as they are. */
+static void CheckLoadFails()
+{
+    uint256 nonce;
+    std::vector<uint256> entries;
+    GetSignatureCacheEntries(nonce, entries);
+    BOOST_CHECK(!LoadSignatureCaches());
+    uint256 nonceAfter;
+    std::vector<uint256> entriesAfter;
+    GetSignatureCacheEntries(nonceAfter, entriesAfter);
+    BOOST_CHECK(nonceAfter == nonce);
+    BOOST_CHECK(entriesAfter == entries);
+}
+
+BOOST_AUTO_TEST_CASE(sigcache_persist)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    CMutableTransaction txSpend;
+    txSpend.vin.resize(1);
+    const CTransaction tx(txSpend);
+    PrecomputedTransactionData txdata(tx);
+    const CachingTransactionSignatureChecker storing(&tx, 0, 0, true, txdata);
+    uint256 hash = InsecureRand256();
+    std::vector<unsigned char> vchSig;
+    BOOST_CHECK(key.Sign(hash, vchSig));
+    BOOST_CHECK(storing.VerifySignature(vchSig, key.GetPubKey(), hash));
+
+    uint256 nonce;
+    std::vector<uint256> entries;
+    GetSignatureCacheEntries(nonce, entries);
+    BOOST_CHECK(!entries.empty());
+
+    // No file yet
+    CheckLoadFails();
+
+    // Round trip, after replacing the caches
+    BOOST_CHECK(DumpSignatureCaches());
+    SetSignatureCacheEntries(InsecureRand256(), std::vector<uint256>());
+    BOOST_CHECK(LoadSignatureCaches());
+    uint256 nonceLoaded;
+    std::vector<uint256> entriesLoaded;
+    GetSignatureCacheEntries(nonceLoaded, entriesLoaded);
+    BOOST_CHECK(nonceLoaded == nonce);
+    BOOST_CHECK(entriesLoaded == entries);
+    BOOST_CHECK(storing.VerifySignature(vchSig, key.GetPubKey(), hash));
+
+    // The file starts with the dump format version and the entries version,
+    // and nothing in it depends on the client version
+    const std::vector<unsigned char> data = ReadCacheFile();
+    BOOST_REQUIRE(data.size() > 12 + 32);
+    CDataStream header(std::vector<unsigned char>(data.begin(), data.begin() + 12), SER_DISK, 0);
+    uint64_t nDumpVersion;
+    uint32_t nEntriesVersion;
+    header >> nDumpVersion >> nEntriesVersion;
+    BOOST_CHECK_EQUAL(nDumpVersion, 2U);
+    BOOST_CHECK_EQUAL(nEntriesVersion, 1U);
+
+    SetSignatureCacheEntries(InsecureRand256(), std::vector<uint256>());
+
+    // Another dump format
+    std::vector<unsigned char> corrupt(data);
+    corrupt[0] ^= 1;
+    WriteCacheFile(corrupt);
+    CheckLoadFails();
+
+    // Entries of another version
+    corrupt = data;
+    corrupt[8] ^= 1;
+    WriteCacheFile(corrupt);
+    CheckLoadFails();
+
+    // Truncated in the signature entries, and at the end
+    WriteCacheFile(std::vector<unsigned char>(data.begin(), data.begin() + 12 + 32 + 1));
+    CheckLoadFails();
+    WriteCacheFile(std::vector<unsigned char>(data.begin(), data.end() - 1));
+    CheckLoadFails();
+
+    // Garbage
+    corrupt.resize(data.size());
+    GetRandBytes(corrupt.data(), corrupt.size());
+    WriteCacheFile(corrupt);
+    CheckLoadFails();
+
+    // Empty
+    WriteCacheFile(std::vector<unsigned char>());
+    CheckLoadFails();
+
+    WriteCacheFile(data);
+    BOOST_CHECK(LoadSignatureCaches());
+    GetSignatureCacheEntries(nonceLoaded, entriesLoaded);
+    BOOST_CHECK(nonceLoaded == nonce);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,457 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/simulation.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <consensus/consensus.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
+#include <hash.h>
+#include <policy/policy.h>
+#include <pow.h>
+#include <txdb.h>
+#include <txmempool.h>
+#include <util.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <functional>
+
+double LatencyDistribution::Mean() const
+{
+    if (vSamples.empty())
+        return 0;
+    double dSum = 0;
+    for (int64_t nSample : vSamples)
+        dSum += nSample;
+    return dSum / vSamples.size();
+}
+
+int64_t LatencyDistribution::Percentile(double dFraction) const
+{
+    if (vSamples.empty())
+        return 0;
+    std::vector<int64_t> vSorted(vSamples);
+    std::sort(vSorted.begin(), vSorted.end());
+    size_t nIndex = std::min<size_t>(vSorted.size() - 1, dFraction * vSorted.size());
+    return vSorted[nIndex];
+}
+
+std::string LatencyDistribution::ToString() const
+{
+    return strprintf("n=%u mean=%.0fus p50=%dus p90=%dus p99=%dus max=%dus",
+        (unsigned int)Count(), Mean(), Percentile(0.5), Percentile(0.9), Percentile(0.99), Percentile(1.0));
+}
+
+std::string SimulationReport::ToString() const
+{
+    std::string strReport = strprintf("transactions: %d generated, %d confirmed in %d blocks\n", nTxsGenerated, nTxsConfirmed, nBlocksConnected);
+    strReport += strprintf("acceptance: %d accepted, %d orphans, %d already confirmed, %d rejected\n", nAccepted, nOrphans, nAlreadyConfirmed, nRejected);
+    for (const auto& reason : mapRejectReasons)
+        strReport += strprintf("  rejected %d times: %s\n", reason.second, reason.first);
+    strReport += "atmp:              " + atmp.ToString() + "\n";
+    strReport += "connect:           " + connect.ToString() + "\n";
+    strReport += "mempool update:    " + mempoolUpdate.ToString() + "\n";
+    strReport += "tx propagation:    " + txPropagation.ToString() + "\n";
+    strReport += "block propagation: " + blockPropagation.ToString() + "\n";
+    return strReport;
+}
+
+struct SimulatedNetwork::Node {
+    std::unique_ptr<CTxMemPool> pool;
+    //! The linked nodes, with the latency of the link
+    std::vector<std::pair<int, int64_t>> vPeers;
+    //! The transactions and blocks received so far
+    std::set<uint256> setSeen;
+    //! Transactions received before their parents
+    std::vector<CTransactionRef> vOrphans;
+    //! Simulated time at which the node is done with the messages it received
+    int64_t nBusyUntil = 0;
+    int nHeight = 0;
+};
+
+struct SimulatedNetwork::Event {
+    enum Type {
+        TX,
+        BLOCK,
+        MINE,
+    } type;
+    int64_t nTime;
+    uint64_t nSequence;
+    //! The receiving node, and the node that relayed it or -1
+    int nNode;
+    int nFrom;
+    CTransactionRef tx;
+    std::shared_ptr<const CBlock> block;
+    int nBlockHeight;
+    //! Simulated time the block was mined at, and the time its miner took to connect it
+    int64_t nMined;
+    int64_t nConnectCost;
+};
+
+SimulatedNetwork::SimulatedNetwork(const SimulationOptions& optionsIn, CChainGenerator& generatorIn)
+    : options(optionsIn), generator(generatorIn),
+      rand((CHashWriter(SER_GETHASH, 0) << std::string("simulation") << optionsIn.nSeed).GetHash())
+{
+    assert(options.nNodes > 0 && options.nLatencyMin <= options.nLatencyMax);
+    for (int i = 0; i < options.nNodes; i++) {
+        vNodes.emplace_back(new Node());
+        vNodes.back()->pool.reset(new CTxMemPool());
+    }
+
+    // A ring keeps the network connected, the other links are random
+    auto link = [this](int a, int b) {
+        for (const auto& peer : vNodes[a]->vPeers) {
+            if (peer.first == b)
+                return;
+        }
+        const int64_t nLatency = options.nLatencyMin + rand.randrange(options.nLatencyMax - options.nLatencyMin + 1);
+        vNodes[a]->vPeers.emplace_back(b, nLatency);
+        vNodes[b]->vPeers.emplace_back(a, nLatency);
+    };
+    for (int i = 1; i < options.nNodes; i++) {
+        link(i - 1, i);
+    }
+    for (int i = 0; i < options.nNodes && options.nNodes > 1; i++) {
+        for (int j = 1; j < options.nPeers; j++) {
+            int nPeer = rand.randrange(options.nNodes - 1);
+            link(i, nPeer < i ? nPeer : nPeer + 1);
+        }
+    }
+}
+
+SimulatedNetwork::~SimulatedNetwork()
+{
+}
+
+size_t SimulatedNetwork::GetMempoolSize(int nNode) const
+{
+    return vNodes[nNode]->pool->size();
+}
+
+void SimulatedNetwork::Schedule(Event event)
+{
+    event.nSequence = nEventSequence++;
+    vEvents.push_back(std::move(event));
+    std::push_heap(vEvents.begin(), vEvents.end(), [](const Event& a, const Event& b) {
+        return std::tie(a.nTime, a.nSequence) > std::tie(b.nTime, b.nSequence);
+    });
+}
+
+/** Send the event to every peer of nNode but the one it came from, once nNode is done with it */
+void SimulatedNetwork::Relay(int nNode, const Event& event)
+{
+    const Node& node = *vNodes[nNode];
+    for (const auto& peer : node.vPeers) {
+        if (peer.first == event.nFrom)
+            continue;
+        Event relayed = event;
+        relayed.nTime = node.nBusyUntil + peer.second;
+        relayed.nNode = peer.first;
+        relayed.nFrom = nNode;
+        Schedule(relayed);
+    }
+}
+
+bool SimulatedNetwork::AcceptTransaction(int nNode, const CTransactionRef& tx, bool& fMissingInputs)
+{
+    Node& node = *vNodes[nNode];
+
+    CValidationState state;
+    fMissingInputs = false;
+    const int64_t nStart = GetTimeMicros();
+    bool fAccepted;
+    {
+        LOCK(cs_main);
+        fAccepted = AcceptToMemoryPool(*node.pool, state, tx, &fMissingInputs, nullptr, false, 0);
+    }
+    const int64_t nElapsed = GetTimeMicros() - nStart;
+    report.atmp.Add(nElapsed);
+    node.nBusyUntil += nElapsed;
+
+    if (fAccepted) {
+        report.nAccepted++;
+        report.txPropagation.Add(node.nBusyUntil - mapTxs[tx->GetHash()].second);
+    } else if (!fMissingInputs) {
+        report.nRejected++;
+        report.mapRejectReasons[state.GetRejectReason()]++;
+    }
+    return fAccepted;
+}
+
+void SimulatedNetwork::RetryOrphans(int nNode)
+{
+    Node& node = *vNodes[nNode];
+    bool fProgress = true;
+    while (fProgress) {
+        fProgress = false;
+        for (auto it = node.vOrphans.begin(); it != node.vOrphans.end();) {
+            bool fMissingInputs;
+            if (setConfirmed.count((*it)->GetHash())) {
+                it = node.vOrphans.erase(it);
+            } else if (AcceptTransaction(nNode, *it, fMissingInputs)) {
+                Event event;
+                event.type = Event::TX;
+                event.nFrom = -1;
+                event.tx = *it;
+                Relay(nNode, event);
+                it = node.vOrphans.erase(it);
+                fProgress = true;
+            } else if (!fMissingInputs) {
+                it = node.vOrphans.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void SimulatedNetwork::ReceiveTransaction(const Event& event)
+{
+    Node& node = *vNodes[event.nNode];
+    const uint256& hash = event.tx->GetHash();
+    if (!node.setSeen.insert(hash).second)
+        return;
+    if (setConfirmed.count(hash)) {
+        report.nAlreadyConfirmed++;
+        return;
+    }
+
+    node.nBusyUntil = std::max(node.nBusyUntil, event.nTime);
+    bool fMissingInputs;
+    if (AcceptTransaction(event.nNode, event.tx, fMissingInputs)) {
+        Relay(event.nNode, event);
+        RetryOrphans(event.nNode);
+    } else if (fMissingInputs) {
+        report.nOrphans++;
+        node.vOrphans.push_back(event.tx);
+    }
+}
+
+void SimulatedNetwork::ReceiveBlock(const Event& event)
+{
+    Node& node = *vNodes[event.nNode];
+    if (!node.setSeen.insert(event.block->GetHash()).second)
+        return;
+
+    // The block was connected by its miner already, charge the node the same time
+    node.nBusyUntil = std::max(node.nBusyUntil, event.nTime) + event.nConnectCost;
+    const int64_t nStart = GetTimeMicros();
+    node.pool->removeForBlock(event.block->vtx, event.nBlockHeight);
+    const int64_t nElapsed = GetTimeMicros() - nStart;
+    report.mempoolUpdate.Add(nElapsed);
+    node.nBusyUntil += nElapsed;
+    node.nHeight = std::max(node.nHeight, event.nBlockHeight);
+
+    report.blockPropagation.Add(node.nBusyUntil - event.nMined);
+    Relay(event.nNode, event);
+    RetryOrphans(event.nNode);
+}
+
+std::shared_ptr<const CBlock> SimulatedNetwork::CreateBlock(int nNode, int64_t nTime)
+{
+    const CChainParams& chainparams = Params();
+    const Consensus::Params& consensus = chainparams.GetConsensus();
+
+    // The mempool transactions in the order they were generated, in which
+    // parents come before their children
+    std::vector<std::pair<int, CTransactionRef>> vTxs;
+    {
+        CTxMemPool& pool = *vNodes[nNode]->pool;
+        LOCK(pool.cs);
+        for (const CTxMemPoolEntry& entry : pool.mapTx) {
+            vTxs.emplace_back(mapTxs[entry.GetTx().GetHash()].first, entry.GetSharedTx());
+        }
+    }
+    std::sort(vTxs.begin(), vTxs.end(), [](const std::pair<int, CTransactionRef>& a, const std::pair<int, CTransactionRef>& b) {
+        return a.first < b.first;
+    });
+
+    LOCK(cs_main);
+    const CBlockIndex* pindexPrev = chainActive.Tip();
+    const int nHeight = pindexPrev->nHeight + 1;
+    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+    CBlock& block = *pblock;
+    block.nVersion = ComputeBlockVersion(pindexPrev, consensus);
+    block.hashPrevBlock = pindexPrev->GetBlockHash();
+    block.nTime = std::max<int64_t>(pindexPrev->GetMedianTimePast() + 1, chainparams.GenesisBlock().nTime + nTime / 1000000);
+    block.nBits = GetNextWorkRequired(pindexPrev, &block, consensus);
+
+    CMutableTransaction coinbase;
+    coinbase.nVersion = CTransaction::VERSION_COINBASE_TRANSFER;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vin[0].scriptSig = CScript() << nHeight << OP_0;
+    coinbase.vout.emplace_back(GetBlockSubsidy(nHeight, consensus, chainparams.GetManagementPolicy()), CScript() << OP_TRUE);
+    block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+
+    // Stop at the first transaction that does not fit, its children must not go in
+    int64_t nBlockWeight = GetTransactionWeight(*block.vtx[0]) + 4000;
+    for (const auto& tx : vTxs) {
+        nBlockWeight += GetTransactionWeight(*tx.second);
+        if (nBlockWeight > MAX_BLOCK_WEIGHT)
+            break;
+        block.vtx.push_back(tx.second);
+    }
+
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    while (!CheckProofOfWork(block.GetHash(), block.nBits, consensus))
+        ++block.nNonce;
+    return pblock;
+}
+
+void SimulatedNetwork::MineBlock(const Event& event)
+{
+    // Only nodes that received the tip can extend it
+    std::vector<int> vMiners;
+    {
+        LOCK(cs_main);
+        for (int i = 0; i < options.nNodes; i++) {
+            if (vNodes[i]->nHeight == chainActive.Height())
+                vMiners.push_back(i);
+        }
+    }
+    assert(!vMiners.empty());
+    const int nMiner = vMiners[rand.randrange(vMiners.size())];
+    Node& node = *vNodes[nMiner];
+    node.nBusyUntil = std::max(node.nBusyUntil, event.nTime);
+
+    std::shared_ptr<const CBlock> pblock = CreateBlock(nMiner, event.nTime);
+    const int64_t nStart = GetTimeMicros();
+    ProcessNewBlock(Params(), pblock, true, nullptr);
+    const int64_t nConnectCost = GetTimeMicros() - nStart;
+
+    int nHeight;
+    {
+        LOCK(cs_main);
+        if (chainActive.Tip()->GetBlockHash() != pblock->GetHash()) {
+            report.mapRejectReasons["block-not-connected"]++;
+            return;
+        }
+        nHeight = chainActive.Height();
+    }
+    report.connect.Add(nConnectCost);
+    report.nBlocksConnected++;
+    report.nTxsConfirmed += pblock->vtx.size() - 1;
+    for (const CTransactionRef& tx : pblock->vtx) {
+        setConfirmed.insert(tx->GetHash());
+    }
+
+    Event block;
+    block.type = Event::BLOCK;
+    block.nTime = event.nTime;
+    block.nNode = nMiner;
+    block.nFrom = -1;
+    block.block = pblock;
+    block.nBlockHeight = nHeight;
+    block.nMined = event.nTime;
+    block.nConnectCost = nConnectCost;
+
+    node.nBusyUntil += nConnectCost;
+    node.setSeen.insert(pblock->GetHash());
+    const int64_t nUpdateStart = GetTimeMicros();
+    node.pool->removeForBlock(pblock->vtx, nHeight);
+    const int64_t nElapsed = GetTimeMicros() - nUpdateStart;
+    report.mempoolUpdate.Add(nElapsed);
+    node.nBusyUntil += nElapsed;
+    node.nHeight = nHeight;
+    Relay(nMiner, block);
+}
+
+SimulationReport SimulatedNetwork::Run()
+{
+    for (int nBlock = 1; nBlock <= options.nBlocks; nBlock++) {
+        const int64_t nIntervalStart = (nBlock - 1) * options.nBlockInterval;
+        CAmount nCreatedInBlock = 0;
+        for (int i = 0; i < options.nTxsPerBlock; i++) {
+            CTransactionRef tx = generator.NextTransaction(nCreatedInBlock);
+            if (!tx)
+                continue;
+
+            Event event;
+            event.type = Event::TX;
+            event.nTime = nIntervalStart + options.nBlockInterval * i / options.nTxsPerBlock;
+            event.nNode = rand.randrange(options.nNodes);
+            event.nFrom = -1;
+            event.tx = tx;
+            mapTxs[tx->GetHash()] = std::make_pair(report.nTxsGenerated++, event.nTime);
+            Schedule(event);
+        }
+
+        Event mine;
+        mine.type = Event::MINE;
+        mine.nTime = nBlock * options.nBlockInterval;
+        mine.nNode = -1;
+        mine.nFrom = -1;
+        Schedule(mine);
+    }
+
+    while (!vEvents.empty()) {
+        std::pop_heap(vEvents.begin(), vEvents.end(), [](const Event& a, const Event& b) {
+            return std::tie(a.nTime, a.nSequence) > std::tie(b.nTime, b.nSequence);
+        });
+        Event event = std::move(vEvents.back());
+        vEvents.pop_back();
+
+        switch (event.type) {
+        case Event::TX:
+            ReceiveTransaction(event);
+            break;
+        case Event::BLOCK:
+            ReceiveBlock(event);
+            break;
+        case Event::MINE:
+            MineBlock(event);
+            break;
+        }
+    }
+    return report;
+}
+
+SimulationSetup::SimulationSetup(uint64_t nSeed, const std::string& strProfile) : TestingSetup(CBaseChainParams::REGTEST)
+{
+    const WorkloadProfile* profile = FindWorkloadProfile(strProfile);
+    if (!profile)
+        throw std::invalid_argument("unknown workload profile");
+    generator.reset(new CChainGenerator(nSeed, *profile, 8, 60));
+
+    // TestingSetup loaded the default genesis block, start over from the
+    // one of the generator
+    UnloadBlockIndex();
+    pcoinsTip.reset();
+    pcoinsdbview.reset();
+    pblocktree.reset();
+    fs::remove(GetDataDir() / "accounts.dat");
+    pblocktree.reset(new CBlockTreeDB(1 << 20, true));
+    pcoinsdbview.reset(new CCoinsViewDB(1 << 23, true));
+    pcoinsTip.reset(new CCoinsViewCache(pcoinsdbview.get()));
+    if (!LoadGenesisBlock(Params())) {
+        throw std::runtime_error("LoadGenesisBlock failed.");
+    }
+    CValidationState state;
+    if (!ActivateBestChain(state, Params())) {
+        throw std::runtime_error("ActivateBestChain failed.");
+    }
+
+    // The generated transactions pay no fee and may be non-standard, as on regtest
+    fRequireStandard = Params().RequireStandard();
+    ::minRelayTxFee = CFeeRate(0);
+    gArgs.ForceSetArg("-limitancestorcount", "1000000");
+    gArgs.ForceSetArg("-limitancestorsize", "1000000");
+    gArgs.ForceSetArg("-limitdescendantcount", "1000000");
+    gArgs.ForceSetArg("-limitdescendantsize", "1000000");
+}
+
+SimulationSetup::~SimulationSetup()
+{
+    fRequireStandard = true;
+    ::minRelayTxFee = CFeeRate(DEFAULT_MIN_RELAY_TX_FEE);
+    gArgs.ForceSetArg("-limitancestorcount", strprintf("%u", DEFAULT_ANCESTOR_LIMIT));
+    gArgs.ForceSetArg("-limitancestorsize", strprintf("%u", DEFAULT_ANCESTOR_SIZE_LIMIT));
+    gArgs.ForceSetArg("-limitdescendantcount", strprintf("%u", DEFAULT_DESCENDANT_LIMIT));
+    gArgs.ForceSetArg("-limitdescendantsize", strprintf("%u", DEFAULT_DESCENDANT_SIZE_LIMIT));
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_TEST_SIMULATION_H
+#define BITCOIN_TEST_SIMULATION_H
+
+#include <test/test_bitcoin.h>
+
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <workload.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+/** Parameters of a simulated network run */
+struct SimulationOptions {
+    //! Number of nodes and number of random links each node opens
+    int nNodes = 8;
+    int nPeers = 4;
+    //! One-way latency of each link in microseconds, drawn uniformly from [min, max]
+    int64_t nLatencyMin = 20000;
+    int64_t nLatencyMax = 100000;
+    //! Number of blocks mined, and transactions generated in between two blocks
+    int nBlocks = 10;
+    int nTxsPerBlock = 50;
+    //! Simulated time between two blocks in microseconds
+    int64_t nBlockInterval = 10 * 1000000;
+    //! Seed of the topology, latencies, transaction origins and miners
+    uint64_t nSeed = 0;
+};
+
+/** A set of latency samples in microseconds */
+class LatencyDistribution
+{
+public:
+    void Add(int64_t nMicros) { vSamples.push_back(nMicros); }
+    size_t Count() const { return vSamples.size(); }
+    double Mean() const;
+    //! The sample below which the given fraction of the samples lie
+    int64_t Percentile(double dFraction) const;
+    std::string ToString() const;
+
+private:
+    std::vector<int64_t> vSamples;
+};
+
+/** Outcome of a simulated network run */
+struct SimulationReport {
+    //! Wall clock time of AcceptToMemoryPool, at every node for every transaction
+    LatencyDistribution atmp;
+    //! Wall clock time of ProcessNewBlock at the miner, which connects the block
+    LatencyDistribution connect;
+    //! Wall clock time of the mempool update for a new block, at every node
+    LatencyDistribution mempoolUpdate;
+    //! Simulated time from the creation of a transaction to its acceptance at every node
+    LatencyDistribution txPropagation;
+    //! Simulated time from mining a block to connecting it at every other node
+    LatencyDistribution blockPropagation;
+
+    int nTxsGenerated = 0;
+    int nTxsConfirmed = 0;
+    int nBlocksConnected = 0;
+    int nAccepted = 0;
+    int nOrphans = 0;
+    //! Transactions that reached a node after the node's chain confirmed them
+    int nAlreadyConfirmed = 0;
+    int nRejected = 0;
+    std::map<std::string, int> mapRejectReasons;
+
+    std::string ToString() const;
+};
+
+/**
+ * Discrete event simulation of a network of nodes relaying a managed
+ * workload. Every node has its own mempool and runs AcceptToMemoryPool on
+ * every transaction it receives, at the cost it actually takes. The nodes
+ * process their messages one at a time, so a node that cannot keep up with
+ * the workload delays its relaying.
+ *
+ * All the nodes share the one chain state of the process: a block is
+ * connected once, by its miner, and the other nodes are charged the
+ * measured connect time when it reaches them. As a consequence, a node
+ * that did not receive a block yet already validates transactions against
+ * it, which shows up as nAlreadyConfirmed.
+ */
+class SimulatedNetwork
+{
+public:
+    SimulatedNetwork(const SimulationOptions& options, CChainGenerator& generator);
+    ~SimulatedNetwork();
+
+    SimulationReport Run();
+
+    size_t GetMempoolSize(int nNode) const;
+
+private:
+    struct Node;
+    struct Event;
+
+    void Schedule(Event event);
+    void Relay(int nNode, const Event& event);
+    bool AcceptTransaction(int nNode, const CTransactionRef& tx, bool& fMissingInputs);
+    void RetryOrphans(int nNode);
+    void ReceiveTransaction(const Event& event);
+    void ReceiveBlock(const Event& event);
+    void MineBlock(const Event& event);
+    std::shared_ptr<const CBlock> CreateBlock(int nNode, int64_t nTime);
+
+    const SimulationOptions options;
+    CChainGenerator& generator;
+    FastRandomContext rand;
+
+    std::vector<std::unique_ptr<Node>> vNodes;
+    std::vector<Event> vEvents;
+    uint64_t nEventSequence = 0;
+    //! Order in which the transactions were generated, which is a valid
+    //! block order, and simulated time they were created at
+    std::map<uint256, std::pair<int, int64_t>> mapTxs;
+    std::set<uint256> setConfirmed;
+    SimulationReport report;
+};
+
+/**
+ * Testing setup whose regtest genesis block grants the manager's roles to
+ * the key of a workload generator, with the relay settings of a regtest node
+ * and without mempool chain limits, so that the generator's transactions are
+ * accepted as soon as their parents are.
+ */
+struct SimulationSetup : public TestingSetup {
+    explicit SimulationSetup(uint64_t nSeed = 0, const std::string& strProfile = "mixed");
+    ~SimulationSetup();
+
+    std::unique_ptr<CChainGenerator> generator;
+};
+
+#endif // BITCOIN_TEST_SIMULATION_H
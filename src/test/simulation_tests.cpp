@@ -0,0 +1,36 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/simulation.h>
+
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(simulation_tests, SimulationSetup)
+
+BOOST_AUTO_TEST_CASE(simulated_network_confirms_workload)
+{
+    SimulationOptions options;
+    options.nNodes = 6;
+    options.nPeers = 3;
+    options.nBlocks = 4;
+    options.nTxsPerBlock = 20;
+
+    SimulatedNetwork network(options, *generator);
+    SimulationReport report = network.Run();
+    BOOST_TEST_MESSAGE(report.ToString());
+
+    BOOST_CHECK_EQUAL(report.nRejected, 0);
+    BOOST_CHECK_EQUAL(report.nBlocksConnected, options.nBlocks);
+    {
+        LOCK(cs_main);
+        BOOST_CHECK_EQUAL(chainActive.Height(), options.nBlocks);
+    }
+    BOOST_CHECK(report.nTxsConfirmed > 0);
+    BOOST_CHECK_EQUAL(report.connect.Count(), (size_t)options.nBlocks);
+    BOOST_CHECK_EQUAL(report.blockPropagation.Count(), (size_t)(options.nBlocks * (options.nNodes - 1)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -760,4 +760,102 @@ BOOST_AUTO_TEST_CASE(test_IsStandard)
     BOOST_CHECK(!IsStandardTx(t, reason));
 }
 
+BOOST_AUTO_TEST_CASE(test_IsWellFormedManagedTx)
+{
+    CKey keyIssuer, keyUser;
+    keyIssuer.MakeNewKey(true);
+    keyUser.MakeNewKey(true);
+    const CScript scriptIssuer = GetScriptForDestination(keyIssuer.GetPubKey().GetID());
+    const CScript scriptUser = GetScriptForDestination(keyUser.GetPubKey().GetID());
+
+    // A coin transfer from an account holding role R
+    CMutableTransaction t;
+    t.nVersion = CTransaction::VERSION_COIN_TRANSFER;
+    t.vin.resize(2);
+    t.vin[0].prevout = COutPoint(InsecureRand256(), 0);
+    t.vin[1].prevout = COutPoint(InsecureRand256(), 1);
+    t.vout.emplace_back(false, false, false, true, false, false, scriptIssuer);
+    t.vout.emplace_back(10 * CENT, scriptIssuer);
+    t.vout.emplace_back(90 * CENT, scriptUser);
+
+    std::string reason;
+    BOOST_CHECK(IsWellFormedManagedTx(t, reason));
+
+    t.vout[1].scriptPubKey = scriptUser;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-chng-address-mismatch");
+    t.vout[1].scriptPubKey = scriptIssuer;
+
+    t.vout[2].scriptPubKey = scriptIssuer;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-address-reuse");
+    t.vout[2].scriptPubKey = CScript() << OP_RETURN;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-vout-nodestination");
+    t.vout[2].scriptPubKey = scriptUser;
+
+    t.vout[0].scriptPubKey = CScript() << OP_1;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-cred-address-mismatch");
+    t.vout[0].scriptPubKey = scriptIssuer;
+
+    // The role repeat of an account that cannot issue transactions
+    t.vout[0].nRole.fRoleD = true;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-invalid-rolerepeat");
+    t.vout[0].nRole.fRoleD = false;
+
+    t.vout[0].nTxType = CTxOut::COIN_TRANSFER;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-missing-rolerepeat");
+    t.vout[0].nTxType = CTxOut::ROLE_CHANGE;
+
+    t.vout[2].nTxType = CTxOut::ROLE_CHANGE;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-invalid-vouttype");
+    t.vout[2].nTxType = CTxOut::COIN_TRANSFER;
+
+    t.vout.resize(1);
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-too-few-vout");
+
+    t.nVersion = 2;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-invalid-txversion");
+
+    // A manager granting role C, then changing it to M and C at once
+    t.nVersion = CTransaction::VERSION_ROLE_CREATION;
+    t.vin.resize(1);
+    t.vout.clear();
+    t.vout.emplace_back(true, false, false, true, false, false, scriptIssuer);
+    t.vout.emplace_back(false, true, false, true, false, false, scriptUser);
+    BOOST_CHECK(IsWellFormedManagedTx(t, reason));
+    t.vout[1].nRole.fRoleM = true;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-not-authorized");
+
+    // A role change replaces the input at the index of each of its outputs
+    t.nVersion = CTransaction::VERSION_ROLE_CHANGE;
+    t.vout[1].nRole.fRoleM = false;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-io-mismatch");
+    t.vin.resize(2);
+    t.vin[1].prevout = COutPoint(InsecureRand256(), 0);
+    BOOST_CHECK(IsWellFormedManagedTx(t, reason));
+
+    // ...and may drop all the roles of the issuer
+    t.vout[0].nRole = CRoleChangeMode();
+    BOOST_CHECK(IsWellFormedManagedTx(t, reason));
+    t.nVersion = CTransaction::VERSION_ROLE_CREATION;
+    BOOST_CHECK(!IsWellFormedManagedTx(t, reason));
+    BOOST_CHECK_EQUAL(reason, "bad-txns-invalid-rolerepeat");
+
+    // Forfeited coins may go back to the law enforcer
+    t.nVersion = CTransaction::VERSION_COIN_FORFEITURE;
+    t.vout.clear();
+    t.vout.emplace_back(false, false, true, true, false, false, scriptIssuer);
+    t.vout.emplace_back(10 * CENT, scriptIssuer);
+    BOOST_CHECK(IsWellFormedManagedTx(t, reason));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
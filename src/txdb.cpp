@@ -13,7 +13,9 @@
 #include <util.h>
 #include <ui_interface.h>
 #include <init.h>
+#include <validation.h>
 
+#include <algorithm>
 #include <stdint.h>
 
 #include <boost/thread.hpp>
@@ -22,6 +24,7 @@ static const char DB_COIN = 'C';
 static const char DB_COINS = 'c';
 static const char DB_BLOCK_FILES = 'f';
 static const char DB_TXINDEX = 't';
+static const char DB_ADDRESSUNSPENTINDEX = 'a';
 static const char DB_BLOCK_INDEX = 'b';
 
 static const char DB_BEST_BLOCK = 'B';
@@ -29,6 +32,8 @@ static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
+static const char DB_COIN_VERSION = 'V';
+static const char DB_COIN_UPGRADE = 'U';
 
 namespace {
 
@@ -54,7 +59,7 @@ struct CoinEntry {
 
 }
 
-CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true) 
+CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe, int nChecksums) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true, nChecksums) 
 {
 }
 
@@ -147,7 +152,110 @@ size_t CCoinsViewDB::EstimateSize() const
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
-CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe) {
+CCoinsViewCredentials::CCoinsViewCredentials(CCoinsView* viewIn, size_t nMaxEntriesIn) : CCoinsViewBacked(viewIn), nMaxEntries(nMaxEntriesIn)
+{
+}
+
+void CCoinsViewCredentials::Touch(const CTxDestination &dest, Entry &entry) const
+{
+    setByActivity.erase(std::make_pair(entry.nActivity, dest));
+    entry.nActivity++;
+    setByActivity.emplace(entry.nActivity, dest);
+}
+
+void CCoinsViewCredentials::Pin(const COutPoint &outpoint, const Coin &coin) const
+{
+    CTxDestination dest;
+    if (nMaxEntries == 0 || coin.out.nTxType != CTxOut::ROLE_CHANGE || !ExtractDestination(coin.out.scriptPubKey, dest))
+        return;
+
+    auto it = mapEntries.find(dest);
+    if (it == mapEntries.end()) {
+        if (mapEntries.size() >= nMaxEntries) {
+            // Drop the least active destination, which a new one replaces
+            auto itEvict = mapEntries.find(setByActivity.begin()->second);
+            if (!itEvict->second.outpoint.IsNull())
+                mapOutpoints.erase(itEvict->second.outpoint);
+            setByActivity.erase(setByActivity.begin());
+            mapEntries.erase(itEvict);
+        }
+        it = mapEntries.emplace(dest, Entry{COutPoint(), Coin(), 0}).first;
+        setByActivity.emplace(0, dest);
+    } else if (!it->second.outpoint.IsNull()) {
+        mapOutpoints.erase(it->second.outpoint);
+    }
+
+    it->second.outpoint = outpoint;
+    it->second.coin = coin;
+    mapOutpoints.emplace(outpoint, dest);
+    Touch(dest, it->second);
+}
+
+void CCoinsViewCredentials::Unpin(const COutPoint &outpoint) const
+{
+    auto it = mapOutpoints.find(outpoint);
+    if (it == mapOutpoints.end())
+        return;
+    Entry& entry = mapEntries.at(it->second);
+    entry.outpoint.SetNull();
+    entry.coin.Clear();
+    mapOutpoints.erase(it);
+}
+
+bool CCoinsViewCredentials::GetCoin(const COutPoint &outpoint, Coin &coin) const
+{
+    AssertLockHeld(cs_main);
+    auto it = mapOutpoints.find(outpoint);
+    if (it != mapOutpoints.end()) {
+        Entry& entry = mapEntries.at(it->second);
+        coin = entry.coin;
+        Touch(it->second, entry);
+        nHits++;
+        return true;
+    }
+    if (!base->GetCoin(outpoint, coin))
+        return false;
+    Pin(outpoint, coin);
+    return true;
+}
+
+bool CCoinsViewCredentials::HaveCoin(const COutPoint &outpoint) const
+{
+    AssertLockHeld(cs_main);
+    return mapOutpoints.count(outpoint) || base->HaveCoin(outpoint);
+}
+
+bool CCoinsViewCredentials::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock)
+{
+    AssertLockHeld(cs_main);
+    // The base view empties mapCoins, and must have written the coins
+    // before they are served from here
+    std::vector<COutPoint> vSpent;
+    std::vector<std::pair<COutPoint, Coin>> vCredentials;
+    for (const auto& entry : mapCoins) {
+        if (!(entry.second.flags & CCoinsCacheEntry::DIRTY))
+            continue;
+        if (entry.second.coin.IsSpent()) {
+            if (mapOutpoints.count(entry.first))
+                vSpent.push_back(entry.first);
+        } else if (entry.second.coin.out.nTxType == CTxOut::ROLE_CHANGE) {
+            vCredentials.emplace_back(entry.first, entry.second.coin);
+        }
+    }
+
+    if (!base->BatchWrite(mapCoins, hashBlock))
+        return false;
+
+    for (const COutPoint& outpoint : vSpent)
+        Unpin(outpoint);
+    for (const auto& credential : vCredentials)
+        Pin(credential.first, credential.second);
+    LogPrint(BCLog::COINDB, "Credential cache: %u pinned, %u written, %u lookups served\n",
+        (unsigned int)mapOutpoints.size(), (unsigned int)vCredentials.size(), (unsigned int)nHits);
+    return true;
+}
+
+CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe, int nChecksums) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe, false, nChecksums) {
 }
 
 bool CBlockTreeDB::ReadBlockFileInfo(int nFile, CBlockFileInfo &info) {
@@ -177,15 +285,30 @@ CCoinsViewCursor *CCoinsViewDB::Cursor() const
        only need read operations on it, use a const-cast to get around
        that restriction.  */
     i->pcursor->Seek(DB_COIN);
+    i->CacheKey();
+    return i;
+}
+
+CCoinsViewCursor *CCoinsViewDB::Cursor(const uint256 &hashStart) const
+{
+    CCoinsViewDBCursor *i = new CCoinsViewDBCursor(const_cast<CDBWrapper&>(db).NewIterator(), GetBestBlock());
+    // Coin keys are (DB_COIN, txid, VARINT(n)), so this seeks to the first
+    // output of the first transaction at or after hashStart.
+    i->pcursor->Seek(std::make_pair(DB_COIN, hashStart));
+    i->CacheKey();
+    return i;
+}
+
+void CCoinsViewDBCursor::CacheKey()
+{
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
+    if (pcursor->Valid()) {
+        CoinEntry entry(&keyTmp.second);
+        pcursor->GetKey(entry);
+        keyTmp.first = entry.key;
     } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+        keyTmp.first = 0; // Make sure Valid() and GetKey() return false
     }
-    return i;
 }
 
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
@@ -247,6 +370,39 @@ bool CBlockTreeDB::WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos>
     return WriteBatch(batch);
 }
 
+bool CBlockTreeDB::UpdateAddressUnspentIndex(const AddressUnspentUpdates &updates) {
+    CDBBatch batch(*this);
+    for (const auto& update : updates) {
+        if (update.second.IsSpent())
+            batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, update.first));
+        else
+            batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, update.first), update.second);
+    }
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::ReadAddressUnspentIndex(std::vector<uint160> vHashDest, std::vector<std::pair<CAddressUnspentKey, Coin> > &unspent) {
+    // Visit the destinations in key order, so that the iterator only ever seeks forward
+    std::sort(vHashDest.begin(), vHashDest.end());
+    vHashDest.erase(std::unique(vHashDest.begin(), vHashDest.end()), vHashDest.end());
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    for (const uint160& hashDest : vHashDest) {
+        pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, hashDest));
+        while (pcursor->Valid()) {
+            std::pair<char, CAddressUnspentKey> key;
+            if (!pcursor->GetKey(key) || key.first != DB_ADDRESSUNSPENTINDEX || key.second.hashDest != hashDest)
+                break;
+            Coin coin;
+            if (!pcursor->GetValue(coin))
+                return error("%s: failed to read value", __func__);
+            unspent.emplace_back(key.second, std::move(coin));
+            pcursor->Next();
+        }
+    }
+    return true;
+}
+
 bool CBlockTreeDB::WriteFlag(const std::string &name, bool fValue) {
     return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
 }
@@ -358,13 +514,122 @@ public:
     }
 };
 
+//! Legacy class to deserialize per-txout entries written before COIN_DB_VERSION 1.
+class CLegacyCoin
+{
+public:
+    Coin coin;
+
+    template<typename Stream>
+    void Unserialize(Stream &s) {
+        uint32_t code = 0;
+        ::Unserialize(s, VARINT(code));
+        coin.nHeight = code >> 1;
+        coin.fCoinBase = code & 1;
+        ::Unserialize(s, REF(CTxOutCompressor(coin.out)));
+    }
+};
+
+}
+
+/** Re-encode the per-txout entries with CCoinTxOutCompressor.
+ *
+ * Progress is committed together with each batch under DB_COIN_UPGRADE, so an
+ * interrupted upgrade resumes after the last converted coin.
+ */
+bool CCoinsViewDB::UpgradeCoinEncoding() {
+    int nVersion = 0;
+    if (db.Read(DB_COIN_VERSION, nVersion) && nVersion >= COIN_DB_VERSION) {
+        return true;
+    }
+
+    COutPoint resume;
+    bool fResume = db.Read(DB_COIN_UPGRADE, resume);
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    if (fResume) {
+        pcursor->Seek(CoinEntry(&resume));
+    } else {
+        pcursor->Seek(DB_COIN);
+    }
+
+    COutPoint outpoint;
+    CoinEntry entry(&outpoint);
+    if (!pcursor->Valid() || !pcursor->GetKey(entry) || entry.key != DB_COIN) {
+        // Nothing (left) to convert
+        CDBBatch batch(db);
+        batch.Erase(DB_COIN_UPGRADE);
+        batch.Write(DB_COIN_VERSION, COIN_DB_VERSION);
+        return db.WriteBatch(batch);
+    }
+
+    int64_t count = 0;
+    LogPrintf("Upgrading coin encoding of the utxo-set database...\n");
+    LogPrintf("[0%%]...");
+    uiInterface.ShowProgress(_("Upgrading UTXO database"), 0, true);
+    size_t batch_size = 1 << 24;
+    CDBBatch batch(db);
+    int reportDone = 0;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        if (ShutdownRequested()) {
+            break;
+        }
+        if (!pcursor->GetKey(entry) || entry.key != DB_COIN) {
+            break;
+        }
+        if (fResume && outpoint == resume) {
+            // Already converted before the interruption
+            pcursor->Next();
+            continue;
+        }
+        if (count++ % 256 == 0) {
+            uint32_t high = 0x100 * *outpoint.hash.begin() + *(outpoint.hash.begin() + 1);
+            int percentageDone = (int)(high * 100.0 / 65536.0 + 0.5);
+            uiInterface.ShowProgress(_("Upgrading UTXO database"), percentageDone, true);
+            if (reportDone < percentageDone/10) {
+                // report max. every 10% step
+                LogPrintf("[%d%%]...", percentageDone);
+                reportDone = percentageDone/10;
+            }
+        }
+        CLegacyCoin old_coin;
+        if (!pcursor->GetValue(old_coin)) {
+            return error("%s: cannot parse legacy Coin record", __func__);
+        }
+        batch.Write(entry, old_coin.coin);
+        resume = outpoint;
+        fResume = true;
+        if (batch.SizeEstimate() > batch_size) {
+            batch.Write(DB_COIN_UPGRADE, resume);
+            db.WriteBatch(batch);
+            batch.Clear();
+        }
+        pcursor->Next();
+    }
+    if (!ShutdownRequested()) {
+        batch.Erase(DB_COIN_UPGRADE);
+        batch.Write(DB_COIN_VERSION, COIN_DB_VERSION);
+    } else if (fResume) {
+        batch.Write(DB_COIN_UPGRADE, resume);
+    }
+    db.WriteBatch(batch);
+    uiInterface.ShowProgress("", 100, false);
+    LogPrintf("[%s].\n", ShutdownRequested() ? "CANCELLED" : "DONE");
+    return !ShutdownRequested();
 }
 
 /** Upgrade the database from older formats.
  *
- * Currently implemented: from the per-tx utxo model (0.8..0.14.x) to per-txout.
+ * Currently implemented:
+ * - from the CTxOutCompressor coin encoding to CCoinTxOutCompressor
+ * - from the per-tx utxo model (0.8..0.14.x) to per-txout
  */
 bool CCoinsViewDB::Upgrade() {
+    // Runs first, so that only coins in the old encoding are converted
+    if (!UpgradeCoinEncoding()) {
+        return false;
+    }
+
     std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
     pcursor->Seek(std::make_pair(DB_COINS, uint256()));
     if (!pcursor->Valid()) {
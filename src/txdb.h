@@ -6,13 +6,17 @@
 #ifndef BITCOIN_TXDB_H
 #define BITCOIN_TXDB_H
 
+#include <addressindex.h>
 #include <coins.h>
 #include <dbwrapper.h>
 #include <chain.h>
+#include <script/standard.h>
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -38,6 +42,10 @@ static const int64_t nMaxBlockDBCache = 2;
 static const int64_t nMaxBlockDBAndTxIndexCache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! Version of the coin encoding used in the chainstate, see CCoinTxOutCompressor
+static const int COIN_DB_VERSION = 1;
+//! -credentialcache default (number of accounts)
+static const int64_t DEFAULT_CREDENTIAL_CACHE_SIZE = 10000;
 
 struct CDiskTxPos : public CDiskBlockPos
 {
@@ -70,7 +78,7 @@ class CCoinsViewDB final : public CCoinsView
 protected:
     CDBWrapper db;
 public:
-    explicit CCoinsViewDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+    explicit CCoinsViewDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false, int nChecksums = DEFAULT_DB_CHECKSUMS);
 
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
@@ -78,6 +86,8 @@ public:
     std::vector<uint256> GetHeadBlocks() const override;
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
+    //! Cursor positioned at the first coin whose txid is not lower than hashStart
+    CCoinsViewCursor *Cursor(const uint256 &hashStart) const;
 
     //! Check if an account already exists
     bool CheckIfAccountExists(const Coin& coin) const override { return false; }
@@ -85,6 +95,11 @@ public:
     //! Attempt to update from an older database format. Returns whether an error occurred.
     bool Upgrade();
     size_t EstimateSize() const override;
+    DBReadStats GetReadStats() const { return db.GetReadStats(); }
+
+private:
+    //! Re-encode the coins written before COIN_DB_VERSION 1
+    bool UpgradeCoinEncoding();
 };
 
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
@@ -106,14 +121,66 @@ private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
 
+    //! Cache the key of the record the iterator is positioned on
+    void CacheKey();
+
     friend class CCoinsViewDB;
 };
 
+/**
+ * CCoinsView that keeps the role credentials of the most active accounts in
+ * memory, in between the coins cache and the coin database.
+ *
+ * Every managed transaction spends the credential of its sender as vin[0],
+ * so the same few accounts are looked up over and over. The coins cache
+ * forgets them whenever it is flushed, after which each of them is read
+ * back from the database. This view sees every coin the cache writes, and
+ * pins the latest unspent credential of each destination. When full, it
+ * drops the destination with the least activity, which counts the
+ * credentials written and the lookups served.
+ *
+ * Lookups update the pins, so even the const methods modify the view. Like
+ * the coins cache above it, it is only used with cs_main held.
+ */
+class CCoinsViewCredentials final : public CCoinsViewBacked
+{
+public:
+    CCoinsViewCredentials(CCoinsView* viewIn, size_t nMaxEntriesIn);
+
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    bool HaveCoin(const COutPoint &outpoint) const override;
+    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+
+    //! Number of credentials currently pinned
+    size_t GetPinnedCount() const { return mapOutpoints.size(); }
+    //! Number of lookups served without reading the database
+    uint64_t GetHits() const { return nHits; }
+
+private:
+    struct Entry {
+        //! Spent credentials are kept, with a null outpoint, until the new one
+        //! is written, so that the destination keeps its activity
+        COutPoint outpoint;
+        Coin coin;
+        uint64_t nActivity;
+    };
+
+    void Pin(const COutPoint &outpoint, const Coin &coin) const;
+    void Unpin(const COutPoint &outpoint) const;
+    void Touch(const CTxDestination &dest, Entry &entry) const;
+
+    const size_t nMaxEntries;
+    mutable std::map<CTxDestination, Entry> mapEntries;
+    mutable std::unordered_map<COutPoint, CTxDestination, SaltedOutpointHasher> mapOutpoints;
+    mutable std::set<std::pair<uint64_t, CTxDestination>> setByActivity;
+    mutable uint64_t nHits = 0;
+};
+
 /** Access to the block database (blocks/index/) */
 class CBlockTreeDB : public CDBWrapper
 {
 public:
-    explicit CBlockTreeDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+    explicit CBlockTreeDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false, int nChecksums = DEFAULT_DB_CHECKSUMS);
 
     CBlockTreeDB(const CBlockTreeDB&) = delete;
     CBlockTreeDB& operator=(const CBlockTreeDB&) = delete;
@@ -125,6 +192,9 @@ public:
     bool ReadReindexing(bool &fReindexing);
     bool ReadTxIndex(const uint256 &txid, CDiskTxPos &pos);
     bool WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos> > &vect);
+    bool UpdateAddressUnspentIndex(const AddressUnspentUpdates &updates);
+    /** Unspent outputs paying any of the destinations, read in a single sweep of the index */
+    bool ReadAddressUnspentIndex(std::vector<uint160> vHashDest, std::vector<std::pair<CAddressUnspentKey, Coin> > &unspent);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
@@ -6,6 +6,7 @@
 #include <validation.h>
 
 #include <accounts/db.h>
+#include <addressindex.h>
 #include <arith_uint256.h>
 #include <chain.h>
 #include <chainparams.h>
@@ -18,9 +19,11 @@
 #include <cuckoocache.h>
 #include <hash.h>
 #include <init.h>
+#include <policy/activity.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <policy/rbf.h>
+#include <policy/reward.h>
 #include <pow.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
@@ -166,7 +169,7 @@ public:
     bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock);
 
     // Block (dis)connection on a given view:
-    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view);
+    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, bool fJustCheck = false);
     bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex,
                     CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck = false);
 
@@ -217,6 +220,7 @@ int nScriptCheckThreads = 0;
 std::atomic_bool fImporting(false);
 std::atomic_bool fReindex(false);
 bool fTxIndex = false;
+bool fAddressIndex = false;
 bool fHavePruned = false;
 bool fPruneMode = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
@@ -237,6 +241,9 @@ CAmount maxTxFee = DEFAULT_TRANSACTION_MAXFEE;
 CBlockPolicyEstimator feeEstimator;
 CTxMemPool mempool(&feeEstimator);
 
+/** Management transactions per block of chainActive, guarded by cs_main */
+static CManagementActivity managementActivity;
+
 /** Constant stuff for coinbase transactions we create: */
 CScript COINBASE_FLAGS;
 
@@ -369,10 +376,10 @@ bool TestLockPointValidity(const LockPoints* lp)
     return true;
 }
 
-bool CheckSequenceLocks(const CTransaction &tx, int flags, LockPoints* lp, bool useExistingLockPoints)
+bool CheckSequenceLocks(const CTxMemPool& pool, const CTransaction &tx, int flags, LockPoints* lp, bool useExistingLockPoints)
 {
     AssertLockHeld(cs_main);
-    AssertLockHeld(mempool.cs);
+    AssertLockHeld(pool.cs);
 
     CBlockIndex* tip = chainActive.Tip();
     assert(tip != nullptr);
@@ -395,7 +402,7 @@ bool CheckSequenceLocks(const CTransaction &tx, int flags, LockPoints* lp, bool
     }
     else {
         // pcoinsTip contains the UTXO set for chainActive.Tip()
-        CCoinsViewMemPool viewMemPool(pcoinsTip.get(), mempool);
+        CCoinsViewMemPool viewMemPool(pcoinsTip.get(), pool);
         std::vector<int> prevheights;
         prevheights.resize(tx.vin.size());
         for (size_t txinIndex = 0; txinIndex < tx.vin.size(); txinIndex++) {
@@ -595,6 +602,10 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
     if (fRequireStandard && !IsStandardTx(tx, reason, witnessEnabled))
         return state.DoS(0, false, REJECT_NONSTANDARD, reason);
 
+    // Reject malformed managed transactions before looking up their inputs
+    if (!IsWellFormedManagedTx(tx, reason))
+        return state.Invalid(false, REJECT_INVALID, reason);
+
     // Do not work on transactions that are too small.
     // A transaction with 1 segwit input and 1 P2WPHK output has non-witness size of 82 bytes.
     // Transactions smaller than this are not relayed to reduce unnecessary malloc overhead.
@@ -693,7 +704,7 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
         // be mined yet.
         // Must keep pool.cs for this unless we change CheckSequenceLocks to take a
         // CoinsViewCache instead of create its own
-        if (!CheckSequenceLocks(tx, STANDARD_LOCKTIME_VERIFY_FLAGS, &lp))
+        if (!CheckSequenceLocks(pool, tx, STANDARD_LOCKTIME_VERIFY_FLAGS, &lp))
             return state.DoS(0, false, REJECT_NONSTANDARD, "non-BIP68-final");
 
         CAmount nFees = 0;
@@ -752,17 +763,10 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
             return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "mempool min fee not met", false, strprintf("%d < %d", nFees, mempoolRejectFee));
         }
 
-        switch (tx.nVersion)
-        {
-            case CTransaction::VERSION_ROLE_CREATION:
-            case CTransaction::VERSION_ROLE_CHANGE:
-            case CTransaction::VERSION_POLICY_CHANGE:
-                break;
-            default:
-                // No transactions are allowed below minRelayTxFee except from disconnected blocks
-                if (!bypass_limits && nModifiedFees < ::minRelayTxFee.GetFee(nSize)) {
-                    return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "min relay fee not met");
-                }
+        // No transactions are allowed below minRelayTxFee except from disconnected blocks
+        // and the fee exempt management transactions
+        if (!bypass_limits && !IsFeeExemptVersion(tx.nVersion) && nModifiedFees < ::minRelayTxFee.GetFee(nSize)) {
+            return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "min relay fee not met");
         }
 
         if (nAbsurdFee && nFees > nAbsurdFee)
@@ -1174,17 +1178,31 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
     return true;
 }
 
-CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams)
+/** Reward schedule of the selected chain, built on first use */
+static CCriticalSection cs_rewardSchedule;
+static std::unique_ptr<CRewardSchedule> rewardSchedule;
+
+/** Requires cs_rewardSchedule */
+static const CRewardSchedule& GetRewardScheduleLocked(const Consensus::Params& consensusParams, const CManagementPolicy& policy)
 {
-    int halvings = nHeight / consensusParams.nSubsidyHalvingInterval;
-    // Force block reward to zero when right shift is undefined.
-    if (halvings >= 64)
-        return 0;
-
-    CAmount nSubsidy = 50 * COIN;
-    // Subsidy is cut in half every 210,000 blocks which will occur approximately every 4 years.
-    nSubsidy >>= halvings;
-    return nSubsidy;
+    AssertLockHeld(cs_rewardSchedule);
+    const CManagementPolicy::CActivePolicy activePolicy = policy.GetActivePolicy();
+    if (!rewardSchedule || !rewardSchedule->IsBuiltFrom(activePolicy, consensusParams.nSubsidyHalvingInterval)) {
+        rewardSchedule.reset(new CRewardSchedule(activePolicy, consensusParams.nSubsidyHalvingInterval));
+    }
+    return *rewardSchedule;
+}
+
+CRewardSchedule GetRewardSchedule(const Consensus::Params& consensusParams, const CManagementPolicy& policy)
+{
+    LOCK(cs_rewardSchedule);
+    return GetRewardScheduleLocked(consensusParams, policy);
+}
+
+CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams, const CManagementPolicy& policy)
+{
+    LOCK(cs_rewardSchedule);
+    return GetRewardScheduleLocked(consensusParams, policy).GetSubsidy(nHeight);
 }
 
 bool IsInitialBlockDownload()
@@ -1356,7 +1374,7 @@ void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, int nHeight)
 bool CScriptCheck::operator()() {
     const CScript &scriptSig = ptxTo->vin[nIn].scriptSig;
     const CScriptWitness *witness = &ptxTo->vin[nIn].scriptWitness;
-    return VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *txdata), &error);
+    return VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.GetSigHashAmount(), cacheStore, *txdata), &error);
 }
 
 int GetSpendHeight(const CCoinsViewCache& inputs)
@@ -1520,7 +1538,27 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
     return true;
 }
 
-static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
+/** Abort with a message */
+bool AbortNode(const std::string& strMessage, const std::string& userMessage="")
+{
+    SetMiscWarning(strMessage);
+    LogPrintf("*** %s\n", strMessage);
+    uiInterface.ThreadSafeMessageBox(
+        userMessage.empty() ? _("Error: A fatal internal error occurred, see debug.log for details") : userMessage,
+        "", CClientUIInterface::MSG_ERROR);
+    StartShutdown();
+    return false;
+}
+
+bool AbortNode(CValidationState& state, const std::string& strMessage, const std::string& userMessage="")
+{
+    AbortNode(strMessage, userMessage);
+    return state.Error(strMessage);
+}
+
+} // namespace
+
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
 {
     CDiskBlockPos pos = pindex->GetUndoPos();
     if (pos.IsNull()) {
@@ -1551,26 +1589,6 @@ static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
     return true;
 }
 
-/** Abort with a message */
-bool AbortNode(const std::string& strMessage, const std::string& userMessage="")
-{
-    SetMiscWarning(strMessage);
-    LogPrintf("*** %s\n", strMessage);
-    uiInterface.ThreadSafeMessageBox(
-        userMessage.empty() ? _("Error: A fatal internal error occurred, see debug.log for details") : userMessage,
-        "", CClientUIInterface::MSG_ERROR);
-    StartShutdown();
-    return false;
-}
-
-bool AbortNode(CValidationState& state, const std::string& strMessage, const std::string& userMessage="")
-{
-    AbortNode(strMessage, userMessage);
-    return state.Error(strMessage);
-}
-
-} // namespace
-
 /**
  * Restore the UTXO in a Coin at a given COutPoint
  * @param undo The Coin to be restored.
@@ -1606,8 +1624,9 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
 }
 
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
- *  When FAILED is returned, view is left in an indeterminate state. */
-DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
+ *  When FAILED is returned, view is left in an indeterminate state.
+ *  With fJustCheck, the address index is left alone. */
+DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, bool fJustCheck)
 {
     bool fClean = true;
 
@@ -1622,12 +1641,18 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         return DISCONNECT_FAILED;
     }
 
+    const bool fUpdateAddressIndex = fAddressIndex && !fJustCheck;
+    AddressUnspentUpdates addressUpdates;
+
     // undo transactions in reverse order
     for (int i = block.vtx.size() - 1; i >= 0; i--) {
         const CTransaction &tx = *(block.vtx[i]);
         uint256 hash = tx.GetHash();
         bool is_coinbase = tx.IsCoinBase();
 
+        if (fUpdateAddressIndex)
+            RemoveAddressOutputs(tx, addressUpdates);
+
         // Check that all outputs are available and match the outputs in the block itself
         // exactly.
         for (size_t o = 0; o < tx.vout.size(); o++) {
@@ -1650,6 +1675,8 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
             }
             for (unsigned int j = tx.vin.size(); j-- > 0;) {
                 const COutPoint &out = tx.vin[j].prevout;
+                if (fUpdateAddressIndex)
+                    UpdateAddressInput(out, txundo.vprevout[j], true, addressUpdates);
                 int res = ApplyTxInUndo(std::move(txundo.vprevout[j]), view, out);
                 if (res == DISCONNECT_FAILED) return DISCONNECT_FAILED;
                 fClean = fClean && res != DISCONNECT_UNCLEAN;
@@ -1658,6 +1685,11 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         }
     }
 
+    if (fUpdateAddressIndex && !pblocktree->UpdateAddressUnspentIndex(addressUpdates)) {
+        error("DisconnectBlock(): failed to write address index");
+        return DISCONNECT_FAILED;
+    }
+
     // move best block pointer to prevout block
     view.SetBestBlock(pindex->pprev->GetBlockHash());
 
@@ -1728,6 +1760,17 @@ static bool WriteTxIndexDataForBlock(const CBlock& block, CValidationState& stat
     return true;
 }
 
+static bool WriteAddressIndexDataForBlock(const AddressUnspentUpdates& addressUpdates, CValidationState& state)
+{
+    if (!fAddressIndex) return true;
+
+    if (!pblocktree->UpdateAddressUnspentIndex(addressUpdates)) {
+        return AbortNode(state, "Failed to write address index");
+    }
+
+    return true;
+}
+
 static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
 
 void ThreadScriptCheck() {
@@ -2001,6 +2044,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     LogPrint(BCLog::BENCH, "    - Fork checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime2 - nTime1), nTimeForks * MICRO, nTimeForks * MILLI / nBlocksTotal);
 
     CBlockUndo blockundo;
+    AddressUnspentUpdates addressUpdates;
 
     CCheckQueueControl<CScriptCheck> control(fScriptChecks && nScriptCheckThreads ? &scriptcheckqueue : nullptr);
 
@@ -2072,6 +2116,16 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
             blockundo.vtxundo.push_back(CTxUndo());
         }
         UpdateCoins(tx, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight);
+
+        if (fAddressIndex) {
+            if (i > 0) {
+                const CTxUndo& txundo = blockundo.vtxundo.back();
+                for (size_t j = 0; j < tx.vin.size(); j++) {
+                    UpdateAddressInput(tx.vin[j].prevout, txundo.vprevout[j], false, addressUpdates);
+                }
+            }
+            AddAddressOutputs(tx, pindex->nHeight, addressUpdates);
+        }
     }
 
     UpdateAccountTree(chainparams, block);
@@ -2079,7 +2133,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     int64_t nTime3 = GetTimeMicros(); nTimeConnect += nTime3 - nTime2;
     LogPrint(BCLog::BENCH, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs (%.2fms/blk)]\n", (unsigned)block.vtx.size(), MILLI * (nTime3 - nTime2), MILLI * (nTime3 - nTime2) / block.vtx.size(), nInputs <= 1 ? 0 : MILLI * (nTime3 - nTime2) / (nInputs-1), nTimeConnect * MICRO, nTimeConnect * MILLI / nBlocksTotal);
 
-    CAmount blockReward = nFees + GetBlockSubsidy(pindex->nHeight, chainparams.GetConsensus());
+    CAmount blockReward = nFees + GetBlockSubsidy(pindex->nHeight, chainparams.GetConsensus(), chainparams.GetManagementPolicy());
     if (block.vtx[0]->GetValueOut() > blockReward)
         return state.DoS(100,
                          error("ConnectBlock(): coinbase pays too much (actual=%d vs limit=%d)",
@@ -2105,6 +2159,9 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     if (!WriteTxIndexDataForBlock(block, state, pindex))
         return false;
 
+    if (!WriteAddressIndexDataForBlock(addressUpdates, state))
+        return false;
+
     assert(pindex->phashBlock);
     // add this block to the view's block chain
     view.SetBestBlock(pindex->GetBlockHash());
@@ -2299,6 +2356,14 @@ void static UpdateTip(const CBlockIndex *pindexNew, const CChainParams& chainPar
             // notify GetWarnings(), called by Qt and the JSON-RPC code to warn the user:
             DoWarning(strWarning);
         }
+        // Check the management activity against the periodicity policy
+        const CManagementPolicy::CActivePolicy policy = chainParams.GetManagementPolicy().GetActivePolicy();
+        int64_t nManagementTx = 0;
+        if (policy.nManagementTxPeriodicity > 0 && pindexNew->nHeight + 1 >= policy.nManagementTxPeriodicity &&
+            GetManagementActivity(policy.nManagementTxPeriodicity, nManagementTx) && nManagementTx < policy.nManagementTxMinPerPeriod) {
+            warningMessages.push_back(strprintf(_("%d management transactions in the last %d blocks, expected at least %d"),
+                nManagementTx, policy.nManagementTxPeriodicity, policy.nManagementTxMinPerPeriod));
+        }
     }
     LogPrintf("%s: new best=%s height=%d version=0x%08x log2_work=%.8g tx=%lu date='%s' progress=%f cache=%.1fMiB(%utxo)", __func__,
       pindexNew->GetBlockHash().ToString(), pindexNew->nHeight, pindexNew->nVersion,
@@ -2311,6 +2376,37 @@ void static UpdateTip(const CBlockIndex *pindexNew, const CChainParams& chainPar
 
 }
 
+bool GetManagementActivity(int nBlocks, int64_t& nCount)
+{
+    AssertLockHeld(cs_main);
+    const CChainParams& chainparams = Params();
+    if (nBlocks < 0 || nBlocks > managementActivity.GetWindow() || nBlocks > chainActive.Height() + 1)
+        return false;
+    if (nBlocks == 0) {
+        nCount = 0;
+        return true;
+    }
+
+    // Blocks connected before the tracker started (at startup or after a
+    // reorg deeper than the window) are read back from disk once
+    CBlock block;
+    if (managementActivity.GetTipHeight() != chainActive.Height()) {
+        managementActivity.Clear();
+        if (!ReadBlockFromDisk(block, chainActive.Tip(), chainparams.GetConsensus()))
+            return false;
+        managementActivity.Connect(chainActive.Height(), CountManagementTransactions(block));
+    }
+    while (managementActivity.GetBlocksCovered() < nBlocks) {
+        const CBlockIndex* pindex = chainActive[managementActivity.GetBaseHeight()];
+        if (!ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()))
+            return false;
+        if (!managementActivity.Prepend(pindex->nHeight, CountManagementTransactions(block)))
+            return false;
+    }
+    nCount = managementActivity.GetCount(nBlocks);
+    return true;
+}
+
 /** Disconnect chainActive's tip.
   * After calling, the mempool will be in an inconsistent state, with
   * transactions from disconnected blocks being added to disconnectpool.  You
@@ -2359,6 +2455,7 @@ bool CChainState::DisconnectTip(CValidationState& state, const CChainParams& cha
     }
 
     chainActive.SetTip(pindexDelete->pprev);
+    managementActivity.Disconnect(pindexDelete->nHeight);
 
     UpdateTip(pindexDelete->pprev, chainparams);
     // Let wallets know transactions went from 1-confirmed to
@@ -2489,6 +2586,7 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
     disconnectpool.removeForBlock(blockConnecting.vtx);
     // Update chainActive & related variables.
     chainActive.SetTip(pindexNew);
+    managementActivity.Connect(pindexNew->nHeight, CountManagementTransactions(blockConnecting));
     UpdateTip(pindexNew, chainparams);
 
     int64_t nTime6 = GetTimeMicros(); nTimePostConnect += nTime6 - nTime5; nTimeTotal += nTime6 - nTime1;
@@ -3937,6 +4035,10 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
     pblocktree->ReadFlag("txindex", fTxIndex);
     LogPrintf("%s: transaction index %s\n", __func__, fTxIndex ? "enabled" : "disabled");
 
+    // Check whether we have an address index
+    pblocktree->ReadFlag("addressindex", fAddressIndex);
+    LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
+
     return true;
 }
 
@@ -4034,7 +4136,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
         // check level 3: check for inconsistencies during memory-only disconnect of tip blocks
         if (nCheckLevel >= 3 && pindex == pindexState && (coins.DynamicMemoryUsage() + pcoinsTip->DynamicMemoryUsage()) <= nCoinCacheUsage) {
             assert(coins.GetBestBlock() == pindex->GetBlockHash());
-            DisconnectResult res = g_chainstate.DisconnectBlock(block, pindex, coins);
+            DisconnectResult res = g_chainstate.DisconnectBlock(block, pindex, coins, true);
             if (res == DISCONNECT_FAILED) {
                 return error("VerifyDB(): *** irrecoverable inconsistency in block data at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
             }
@@ -4292,6 +4394,7 @@ void UnloadBlockIndex()
     for (int b = 0; b < VERSIONBITS_NUM_BITS; b++) {
         warningcache[b].clear();
     }
+    managementActivity.Clear();
 
     for (BlockMap::value_type& entry : mapBlockIndex) {
         delete entry.second;
@@ -4323,6 +4426,8 @@ bool LoadBlockIndex(const CChainParams& chainparams)
         // Use the provided setting for -txindex in the new database
         fTxIndex = gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX);
         pblocktree->WriteFlag("txindex", fTxIndex);
+        fAddressIndex = gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
+        pblocktree->WriteFlag("addressindex", fAddressIndex);
     }
     return true;
 }
@@ -4819,6 +4924,101 @@ bool DumpMempool(void)
     return true;
 }
 
+static const uint64_t SIGCACHE_DUMP_VERSION = 2;
+/**
+ * Version of the cache entries: how they are derived from the salt and the
+ * checks they stand for, and the rules those checks were made under. Bump it
+ * when either changes, so that entries saved by older builds are not trusted.
+ */
+static const uint32_t SIGCACHE_ENTRIES_VERSION = 1;
+
+bool LoadSignatureCaches()
+{
+    FILE* filestr = fsbridge::fopen(GetDataDir() / "sigcache.dat", "rb");
+    CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        LogPrintf("Failed to open signature cache file from disk. Continuing anyway.\n");
+        return false;
+    }
+
+    uint256 sigNonce, scriptNonce;
+    std::vector<uint256> sigEntries, scriptEntries;
+    try {
+        uint64_t version;
+        file >> version;
+        if (version != SIGCACHE_DUMP_VERSION) {
+            return false;
+        }
+        uint32_t nEntriesVersion;
+        file >> nEntriesVersion;
+        if (nEntriesVersion != SIGCACHE_ENTRIES_VERSION) {
+            LogPrintf("Ignoring signature cache entries of version %u\n", nEntriesVersion);
+            return false;
+        }
+        file >> sigNonce;
+        file >> sigEntries;
+        file >> scriptNonce;
+        file >> scriptEntries;
+    } catch (const std::exception& e) {
+        LogPrintf("Failed to deserialize signature cache data on disk: %s. Continuing anyway.\n", e.what());
+        return false;
+    }
+
+    SetSignatureCacheEntries(sigNonce, sigEntries);
+    {
+        LOCK(cs_main);
+        scriptExecutionCacheNonce = scriptNonce;
+        for (const uint256& entry : scriptEntries) {
+            scriptExecutionCache.insert(entry);
+        }
+    }
+
+    LogPrintf("Imported signature cache from disk: %u signatures, %u script executions\n", sigEntries.size(), scriptEntries.size());
+    return true;
+}
+
+bool DumpSignatureCaches()
+{
+    int64_t start = GetTimeMicros();
+
+    uint256 sigNonce, scriptNonce;
+    std::vector<uint256> sigEntries, scriptEntries;
+    GetSignatureCacheEntries(sigNonce, sigEntries);
+    {
+        LOCK(cs_main);
+        scriptNonce = scriptExecutionCacheNonce;
+        scriptExecutionCache.for_each([&scriptEntries](const uint256& entry) { scriptEntries.push_back(entry); });
+    }
+
+    int64_t mid = GetTimeMicros();
+
+    try {
+        FILE* filestr = fsbridge::fopen(GetDataDir() / "sigcache.dat.new", "wb");
+        if (!filestr) {
+            return false;
+        }
+
+        CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+
+        uint64_t version = SIGCACHE_DUMP_VERSION;
+        file << version;
+        file << SIGCACHE_ENTRIES_VERSION;
+        file << sigNonce;
+        file << sigEntries;
+        file << scriptNonce;
+        file << scriptEntries;
+        FileCommit(file.Get());
+        file.fclose();
+        RenameOver(GetDataDir() / "sigcache.dat.new", GetDataDir() / "sigcache.dat");
+        int64_t last = GetTimeMicros();
+        LogPrintf("Dumped signature cache: %gs to copy, %gs to dump\n", (mid-start)*MICRO, (last-mid)*MICRO);
+    } catch (const std::exception& e) {
+        LogPrintf("Failed to dump signature cache: %s. Continuing anyway.\n", e.what());
+        return false;
+    }
+    return true;
+}
+
 //! Guess how far we are in the verification process at the given block index
 double GuessVerificationProgress(const ChainTxData& data, const CBlockIndex *pindex) {
     if (pindex == nullptr)
@@ -33,12 +33,15 @@
 
 class CBlockIndex;
 class CBlockTreeDB;
+class CBlockUndo;
 class CChainParams;
 class CCoinsViewDB;
 class CInv;
 class CConnman;
 class CScriptCheck;
 class CBlockPolicyEstimator;
+class CManagementPolicy;
+class CRewardSchedule;
 class CTxMemPool;
 class CValidationState;
 struct ChainTxData;
@@ -134,6 +137,8 @@ static const bool DEFAULT_TXINDEX = false;
 static const unsigned int DEFAULT_BANSCORE_THRESHOLD = 100;
 /** Default for -persistmempool */
 static const bool DEFAULT_PERSIST_MEMPOOL = true;
+/** Default for -persistsigcache */
+static const bool DEFAULT_PERSIST_SIGCACHE = true;
 /** Default for -mempoolreplacement */
 static const bool DEFAULT_ENABLE_REPLACEMENT = true;
 /** Default for using fee filter */
@@ -171,6 +176,7 @@ extern std::atomic_bool fImporting;
 extern std::atomic_bool fReindex;
 extern int nScriptCheckThreads;
 extern bool fTxIndex;
+extern bool fAddressIndex;
 extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
@@ -280,7 +286,10 @@ bool IsInitialBlockDownload();
 bool GetTransaction(const uint256& hash, CTransactionRef& tx, const Consensus::Params& params, uint256& hashBlock, bool fAllowSlow = false, CBlockIndex* blockIndex = nullptr);
 /** Find the best known block, and make it the tip of the block chain */
 bool ActivateBestChain(CValidationState& state, const CChainParams& chainparams, std::shared_ptr<const CBlock> pblock = std::shared_ptr<const CBlock>());
-CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams);
+/** Subsidy of the block at nHeight, from the reward schedule of the chain's initial management policy */
+CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams, const CManagementPolicy& policy);
+/** Copy of the reward schedule used by GetBlockSubsidy() */
+CRewardSchedule GetRewardSchedule(const Consensus::Params& consensusParams, const CManagementPolicy& policy);
 
 /** Guess verification progress (as a fraction between 0.0=genesis and 1.0=current tip). */
 double GuessVerificationProgress(const ChainTxData& data, const CBlockIndex* pindex);
@@ -327,6 +336,16 @@ int VersionBitsTipStateSinceHeight(const Consensus::Params& params, Consensus::D
 /** Apply the effects of this transaction on the UTXO set represented by view */
 void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, int nHeight);
 
+/** Apply the role changes and creations of this block to the account tree (accounts.dat) */
+void UpdateAccountTree(const CChainParams& chainparams, const CBlock& block);
+
+/**
+ * Number of management transactions in the last nBlocks blocks of chainActive,
+ * up to MAX_MANAGEMENT_ACTIVITY_WINDOW. Constant time once the blocks have been
+ * seen by the tracker. Requires cs_main.
+ */
+bool GetManagementActivity(int nBlocks, int64_t& nCount);
+
 /** Transaction validation functions */
 
 /**
@@ -346,7 +365,8 @@ bool TestLockPointValidity(const LockPoints* lp);
 /**
  * Check if transaction will be BIP 68 final in the next block to be created.
  *
- * Simulates calling SequenceLocks() with data from the tip of the current active chain.
+ * Simulates calling SequenceLocks() with data from the tip of the current active chain
+ * and the transactions of pool.
  * Optionally stores in LockPoints the resulting height and time calculated and the hash
  * of the block needed for calculation or skips the calculation and uses the LockPoints
  * passed in for evaluation.
@@ -354,7 +374,7 @@ bool TestLockPointValidity(const LockPoints* lp);
  *
  * See consensus/consensus.h for flag definitions.
  */
-bool CheckSequenceLocks(const CTransaction &tx, int flags, LockPoints* lp = nullptr, bool useExistingLockPoints = false);
+bool CheckSequenceLocks(const CTxMemPool& pool, const CTransaction &tx, int flags, LockPoints* lp = nullptr, bool useExistingLockPoints = false);
 
 /**
  * Closure representing one script verification
@@ -398,6 +418,7 @@ void InitScriptExecutionCache();
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex);
 
 /** Functions for validating blocks and updating the block tree */
 
@@ -485,4 +506,10 @@ bool DumpMempool();
 /** Load the mempool from disk. */
 bool LoadMempool();
 
+/** Dump the signature and script execution caches, with their salts, to disk. */
+bool DumpSignatureCaches();
+
+/** Load the signature and script execution caches from disk. */
+bool LoadSignatureCaches();
+
 #endif // BITCOIN_VALIDATION_H
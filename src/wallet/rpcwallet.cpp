@@ -1168,6 +1168,129 @@ UniValue sendmany(const JSONRPCRequest& request)
     return wtx.GetHash().GetHex();
 }
 
+UniValue createaccounts(const JSONRPCRequest& request)
+{
+    CWallet * const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!EnsureWalletIsAvailable(pwallet, request.fHelp)) {
+        return NullUniValue;
+    }
+
+    if (request.fHelp || request.params.size() != 2)
+        throw std::runtime_error(
+            "createaccounts \"fromaddress\" [{\"address\":\"address\",\"roles\":\"roles\"},...]\n"
+            "\nCreate many accounts at once. The accounts are packed into as few role creation transactions\n"
+            "as the size limits allow. The transactions are chained through the role repeat of \"fromaddress\",\n"
+            "signed, and submitted together: either all of them enter the mempool or none does."
+            + HelpRequiringPassphrase(pwallet) + "\n"
+            "\nArguments:\n"
+            "1. \"fromaddress\"         (string, required) The address holding the credentials used to create the accounts\n"
+            "2. \"accounts\"            (array, required) A json array of accounts\n"
+            "    [\n"
+            "      {\n"
+            "        \"address\":\"address\", (string, required) The address of the new account\n"
+            "        \"roles\":\"roles\"      (string, required) The roles of the new account, e.g. \"...R..\"\n"
+            "      }\n"
+            "      ,...\n"
+            "    ]\n"
+            "\nResult:\n"
+            "[                          (array) The transaction ids of the chain, in submission order\n"
+            "  \"txid\"                 (string) The transaction id\n"
+            "  ,...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("createaccounts", "\"1D1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\" \"[{\\\"address\\\":\\\"1353tsE8YMTA4EuV7dgUXGjNFf9KpVvKHz\\\",\\\"roles\\\":\\\"...R..\\\"}]\"") +
+            "\nAs a json rpc call\n"
+            + HelpExampleRpc("createaccounts", "\"1D1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\", [{\"address\":\"1353tsE8YMTA4EuV7dgUXGjNFf9KpVvKHz\",\"roles\":\"...R..\"}]")
+        );
+
+    ObserveSafeMode();
+
+    // Make sure the results are valid at least up to the most recent block
+    // the user could have gotten from another RPC command prior to now
+    pwallet->BlockUntilSyncedToCurrentChain();
+
+    if (pwallet->GetBroadcastTransactions() && !g_connman) {
+        throw JSONRPCError(RPC_CLIENT_P2P_DISABLED, "Error: Peer-to-peer functionality missing or disabled");
+    }
+
+    RPCTypeCheck(request.params, {UniValue::VSTR, UniValue::VARR});
+
+    CTxDestination fromDest = DecodeDestination(request.params[0].get_str());
+    if (!IsValidDestination(fromDest)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Invalid Bitcoin address: ") + request.params[0].get_str());
+    }
+
+    const UniValue& accounts = request.params[1].get_array();
+    if (accounts.empty()) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid parameter, no accounts given");
+    }
+
+    std::set<CTxDestination> destinations;
+    std::vector<CTxOut> vAccounts;
+    vAccounts.reserve(accounts.size());
+    for (unsigned int idx = 0; idx < accounts.size(); idx++) {
+        const UniValue& o = accounts[idx].get_obj();
+        RPCTypeCheckObj(o,
+            {
+                {"address", UniValueType(UniValue::VSTR)},
+                {"roles", UniValueType(UniValue::VSTR)},
+            });
+
+        const std::string& strAddress = find_value(o, "address").get_str();
+        CTxDestination dest = DecodeDestination(strAddress);
+        if (!IsValidDestination(dest)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Invalid Bitcoin address: ") + strAddress);
+        }
+        if (dest == fromDest) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Invalid parameter, account uses the credentials address: ") + strAddress);
+        }
+        if (!destinations.insert(dest).second) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Invalid parameter, duplicated address: ") + strAddress);
+        }
+
+        CRoleChangeMode roles;
+        if (!ParseRoles(find_value(o, "roles").get_str(), roles)) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Invalid roles for address: ") + strAddress);
+        }
+
+        vAccounts.push_back(CTxOut(roles, GetScriptForDestination(dest)));
+    }
+
+    COutPoint credential;
+    CTxOut credentialOut;
+    {
+        LOCK2(cs_main, pwallet->cs_wallet);
+        if (!pwallet->FindCredential(fromDest, credential, credentialOut)) {
+            throw JSONRPCError(RPC_WALLET_ERROR, "No unspent credentials found in the wallet for this address");
+        }
+    }
+
+    // Signing a long chain takes a while and does not need the chainstate, so
+    // it runs without cs_main. Should the credential be spent meanwhile, the
+    // mempool rejects the chain when it is committed.
+    std::vector<CTransactionRef> vtx;
+    std::string strFailReason;
+    {
+        LOCK(pwallet->cs_wallet);
+        EnsureWalletIsUnlocked(pwallet);
+        if (!pwallet->CreateRoleCreationChain(credential, credentialOut, vAccounts, vtx, strFailReason)) {
+            throw JSONRPCError(RPC_WALLET_ERROR, strFailReason);
+        }
+    }
+
+    CValidationState state;
+    if (!pwallet->CommitTransactionChain(vtx, g_connman.get(), state)) {
+        strFailReason = strprintf("Transaction commit failed:: %s", state.GetRejectReason());
+        throw JSONRPCError(RPC_WALLET_ERROR, strFailReason);
+    }
+
+    UniValue result(UniValue::VARR);
+    for (const CTransactionRef& tx : vtx) {
+        result.push_back(tx->GetHash().GetHex());
+    }
+    return result;
+}
+
 UniValue addmultisigaddress(const JSONRPCRequest& request)
 {
     CWallet * const pwallet = GetWalletForJSONRPCRequest(request);
@@ -3562,6 +3685,7 @@ static const CRPCCommand commands[] =
     { "hidden",             "addwitnessaddress",        &addwitnessaddress,        {"address","p2sh"} },
     { "wallet",             "backupwallet",             &backupwallet,             {"destination"} },
     { "wallet",             "bumpfee",                  &bumpfee,                  {"txid", "options"} },
+    { "wallet",             "createaccounts",           &createaccounts,           {"fromaddress","accounts"} },
     { "wallet",             "dumpprivkey",              &dumpprivkey,              {"address"}  },
     { "wallet",             "dumpwallet",               &dumpwallet,               {"filename"} },
     { "wallet",             "encryptwallet",            &encryptwallet,            {"passphrase"} },
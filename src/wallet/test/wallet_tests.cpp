@@ -11,7 +11,9 @@
 #include <vector>
 
 #include <consensus/validation.h>
+#include <policy/policy.h>
 #include <rpc/server.h>
+#include <script/interpreter.h>
 #include <test/test_bitcoin.h>
 #include <validation.h>
 #include <wallet/coincontrol.h>
@@ -700,4 +702,68 @@ BOOST_FIXTURE_TEST_CASE(ListCoins, ListCoinsTestingSetup)
     BOOST_CHECK_EQUAL(list.begin()->second.size(), 2);
 }
 
+BOOST_AUTO_TEST_CASE(role_creation_chain)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    LOCK(pwalletMain->cs_wallet);
+    BOOST_CHECK(pwalletMain->AddKeyPubKey(key, key.GetPubKey()));
+
+    // Enough accounts for several transactions, with room in the mempool
+    // package limits for the whole chain
+    std::vector<CTxOut> vAccounts;
+    for (int i = 0; i < 8000; i++) {
+        vAccounts.emplace_back(false, false, false, true, false, false, GetScriptForDestination(CKeyID(uint160(insecure_rand_ctx.randbytes(20)))));
+    }
+    gArgs.ForceSetArg("-limitancestorsize", "2000");
+    gArgs.ForceSetArg("-limitdescendantsize", "2000");
+
+    // A legacy credential is signed link by link, a witness credential is
+    // linked first and signed on several threads.
+    const CKeyID keyID = key.GetPubKey().GetID();
+    for (const CScript& script : {GetScriptForDestination(keyID), GetScriptForDestination(WitnessV0KeyHash(keyID))}) {
+        const COutPoint credential(InsecureRand256(), 0);
+        const CTxOut credentialOut(true, false, false, true, false, false, script);
+
+        std::vector<CTransactionRef> vtx;
+        std::string strFailReason;
+        BOOST_CHECK(pwalletMain->CreateRoleCreationChain(credential, credentialOut, vAccounts, vtx, strFailReason));
+        BOOST_CHECK(vtx.size() > 2);
+
+        COutPoint prevout = credential;
+        size_t nAccounts = 0;
+        for (const CTransactionRef& tx : vtx) {
+            BOOST_CHECK(tx->nVersion == CTransaction::VERSION_ROLE_CREATION);
+            BOOST_CHECK(GetTransactionWeight(*tx) <= MAX_STANDARD_TX_WEIGHT);
+            BOOST_CHECK_EQUAL(tx->vin.size(), 1U);
+            BOOST_CHECK(tx->vin[0].prevout == prevout);
+            BOOST_CHECK(tx->vout[0] == credentialOut);
+            for (size_t i = 1; i < tx->vout.size(); i++) {
+                BOOST_CHECK(tx->vout[i] == vAccounts[nAccounts++]);
+            }
+
+            // The signature commits to the role bits of the spent credential
+            ScriptError serror;
+            BOOST_CHECK(VerifyScript(tx->vin[0].scriptSig, script, &tx->vin[0].scriptWitness, STANDARD_SCRIPT_VERIFY_FLAGS,
+                                     TransactionSignatureChecker(tx.get(), 0, credentialOut.GetSigHashAmount()), &serror));
+            if (!tx->vin[0].scriptWitness.IsNull()) {
+                BOOST_CHECK(!VerifyScript(tx->vin[0].scriptSig, script, &tx->vin[0].scriptWitness, STANDARD_SCRIPT_VERIFY_FLAGS,
+                                          TransactionSignatureChecker(tx.get(), 0, 0), &serror));
+            }
+            prevout = COutPoint(tx->GetHash(), 0);
+        }
+        BOOST_CHECK_EQUAL(nAccounts, vAccounts.size());
+    }
+
+    // With the default limits, the chain does not fit in the mempool
+    gArgs.ForceSetArg("-limitancestorsize", std::to_string(DEFAULT_ANCESTOR_SIZE_LIMIT));
+    gArgs.ForceSetArg("-limitdescendantsize", std::to_string(DEFAULT_DESCENDANT_SIZE_LIMIT));
+    std::vector<CTransactionRef> vtx;
+    std::string strFailReason;
+    const CTxOut credentialOut(true, false, false, true, false, false, GetScriptForDestination(keyID));
+    BOOST_CHECK(!pwalletMain->CreateRoleCreationChain(COutPoint(InsecureRand256(), 0), credentialOut, vAccounts, vtx, strFailReason));
+    BOOST_CHECK_EQUAL(strFailReason, "Too many accounts for a single unconfirmed transaction chain");
+    BOOST_CHECK(vtx.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
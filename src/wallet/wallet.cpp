@@ -3123,6 +3123,189 @@ bool CWallet::CommitTransaction(CWalletTx& wtxNew, CReserveKey& reservekey, CCon
     return true;
 }
 
+bool CWallet::FindCredential(const CTxDestination& dest, COutPoint& outpointRet, CTxOut& txoutRet) const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    // The wallet does not track spends of managed transactions (see
+    // AddToSpends), so the chain and the mempool are the authority here.
+    CCoinsViewMemPool viewMemPool(pcoinsTip.get(), mempool);
+    CCoinsViewCache view(&viewMemPool);
+    CTxDestination cur_dest;
+
+    for (const auto& entry : mapWallet) {
+        const CWalletTx& wtx = entry.second;
+        if (wtx.GetDepthInMainChain() < 0)
+            continue;
+        for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+            const CTxOut& txout = wtx.tx->vout[i];
+            if (txout.nTxType != CTxOut::ROLE_CHANGE)
+                continue;
+            if (!ExtractDestination(txout.scriptPubKey, cur_dest) || cur_dest != dest)
+                continue;
+            COutPoint outpoint(wtx.GetHash(), i);
+            if (view.AccessCoin(outpoint).IsSpent() || mempool.isSpent(outpoint))
+                continue;
+            outpointRet = outpoint;
+            txoutRet = txout;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CWallet::CreateRoleCreationChain(const COutPoint& credential, const CTxOut& credentialOut, const std::vector<CTxOut>& vAccounts,
+                                      std::vector<CTransactionRef>& vtxRet, std::string& strFailReason)
+{
+    AssertLockNotHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+    vtxRet.clear();
+
+    if (vAccounts.empty()) {
+        strFailReason = _("No accounts to create");
+        return false;
+    }
+
+    // Each transaction of the chain is limited by the standard weight, and
+    // the whole chain by the mempool ancestor/descendant limits, since it is
+    // submitted unconfirmed.
+    const size_t nMaxChainLength = std::min(gArgs.GetArg("-limitancestorcount", DEFAULT_ANCESTOR_LIMIT),
+                                            gArgs.GetArg("-limitdescendantcount", DEFAULT_DESCENDANT_LIMIT));
+    const int64_t nMaxChainWeight = std::min(gArgs.GetArg("-limitancestorsize", DEFAULT_ANCESTOR_SIZE_LIMIT),
+                                             gArgs.GetArg("-limitdescendantsize", DEFAULT_DESCENDANT_SIZE_LIMIT)) * 1000 * WITNESS_SCALE_FACTOR;
+
+    // Weight of a transaction holding only the dummy-signed credential and
+    // the role repeat. Every account then adds the weight of its output, plus
+    // some room for the vout count to grow.
+    CMutableTransaction txBase;
+    txBase.nVersion = CTransaction::VERSION_ROLE_CREATION;
+    txBase.vin.push_back(CTxIn(credential, CScript(), CTxIn::SEQUENCE_FINAL));
+    txBase.vout.push_back(CTxOut(credentialOut.nRole, credentialOut.scriptPubKey));
+    SignatureData sigdata;
+    if (!ProduceSignature(DummySignatureCreator(this), credentialOut.scriptPubKey, sigdata)) {
+        strFailReason = _("Signing transaction failed");
+        return false;
+    }
+    UpdateTransaction(txBase, 0, sigdata);
+    const int64_t nBaseWeight = GetTransactionWeight(txBase) + 8 * WITNESS_SCALE_FACTOR;
+
+    std::vector<CMutableTransaction> vmtx;
+    int64_t nChainWeight = 0;
+    int64_t nTxWeight = 0;
+    for (const CTxOut& account : vAccounts) {
+        const int64_t nOutWeight = ::GetSerializeSize(account, SER_NETWORK, PROTOCOL_VERSION) * WITNESS_SCALE_FACTOR;
+        if (vmtx.empty() || nTxWeight + nOutWeight > (int64_t)MAX_STANDARD_TX_WEIGHT) {
+            if (vmtx.size() == nMaxChainLength) {
+                strFailReason = _("Too many accounts for a single unconfirmed transaction chain");
+                return false;
+            }
+            CMutableTransaction txNew;
+            txNew.nVersion = CTransaction::VERSION_ROLE_CREATION;
+            txNew.vout.push_back(CTxOut(credentialOut.nRole, credentialOut.scriptPubKey));
+            vmtx.push_back(txNew);
+            nChainWeight += nBaseWeight;
+            nTxWeight = nBaseWeight;
+        }
+        vmtx.back().vout.push_back(account);
+        nTxWeight += nOutWeight;
+        nChainWeight += nOutWeight;
+        if (nChainWeight > nMaxChainWeight) {
+            strFailReason = _("Too many accounts for a single unconfirmed transaction chain");
+            return false;
+        }
+    }
+
+    // Sign one transaction of the chain, spending the given credential. Every
+    // link of the chain spends a role repeat of credentialOut, so all inputs
+    // commit to the same amount.
+    const CAmount nSigHashAmount = credentialOut.GetSigHashAmount();
+    auto sign = [this, &credentialOut, nSigHashAmount](CMutableTransaction& tx, const COutPoint& prevout) {
+        tx.vin.assign(1, CTxIn(prevout, CScript(), CTxIn::SEQUENCE_FINAL));
+        const CTransaction txConst(tx);
+        SignatureData sigdata;
+        if (!ProduceSignature(TransactionSignatureCreator(this, &txConst, 0, nSigHashAmount, SIGHASH_ALL), credentialOut.scriptPubKey, sigdata))
+            return false;
+        UpdateTransaction(tx, 0, sigdata);
+        return true;
+    };
+
+    // The txid of a transaction spending a witness program does not commit
+    // to its signature, so the whole chain can be linked first and signed in
+    // parallel. Otherwise each txid is only known once its input is signed.
+    int witnessversion;
+    std::vector<unsigned char> witnessprogram;
+    bool fSigned = true;
+    if (vmtx.size() > 1 && credentialOut.scriptPubKey.IsWitnessProgram(witnessversion, witnessprogram)) {
+        std::vector<COutPoint> vPrevouts(1, credential);
+        for (size_t i = 0; i + 1 < vmtx.size(); i++) {
+            vmtx[i].vin.assign(1, CTxIn(vPrevouts.back(), CScript(), CTxIn::SEQUENCE_FINAL));
+            vPrevouts.push_back(COutPoint(vmtx[i].GetHash(), 0));
+        }
+        const size_t nThreads = std::min<size_t>(vmtx.size(), std::max(1, GetNumCores()));
+        std::vector<char> vResults(vmtx.size(), 0);
+        boost::thread_group threadGroup;
+        for (size_t t = 0; t < nThreads; t++) {
+            threadGroup.create_thread([&, t] {
+                for (size_t i = t; i < vmtx.size(); i += nThreads)
+                    vResults[i] = sign(vmtx[i], vPrevouts[i]);
+            });
+        }
+        threadGroup.join_all();
+        fSigned = std::find(vResults.begin(), vResults.end(), 0) == vResults.end();
+    } else {
+        COutPoint prevout = credential;
+        for (CMutableTransaction& tx : vmtx) {
+            if (!sign(tx, prevout)) {
+                fSigned = false;
+                break;
+            }
+            prevout = COutPoint(tx.GetHash(), 0);
+        }
+    }
+    if (!fSigned) {
+        strFailReason = _("Signing transaction failed");
+        return false;
+    }
+
+    for (CMutableTransaction& tx : vmtx) {
+        if (GetTransactionWeight(tx) > MAX_STANDARD_TX_WEIGHT) {
+            strFailReason = _("Transaction too large");
+            return false;
+        }
+        vtxRet.push_back(MakeTransactionRef(std::move(tx)));
+    }
+    return true;
+}
+
+bool CWallet::CommitTransactionChain(const std::vector<CTransactionRef>& vtx, CConnman* connman, CValidationState& state)
+{
+    LOCK2(cs_main, cs_wallet);
+    assert(!vtx.empty());
+
+    for (size_t i = 0; i < vtx.size(); i++) {
+        LogPrintf("CommitTransactionChain: %u/%u\n%s", i + 1, vtx.size(), vtx[i]->ToString());
+        if (!AcceptToMemoryPool(mempool, state, vtx[i], nullptr /* pfMissingInputs */,
+                                nullptr /* plTxnReplaced */, false /* bypass_limits */, maxTxFee)) {
+            LogPrintf("CommitTransactionChain(): Transaction %u rejected, %s\n", i + 1, state.GetRejectReason());
+            // Removing the head of the chain also removes its descendants
+            if (i > 0)
+                mempool.removeRecursive(*vtx[0]);
+            return false;
+        }
+    }
+
+    for (const CTransactionRef& tx : vtx) {
+        CWalletTx wtxNew(this, tx);
+        AddToWallet(wtxNew);
+        CWalletTx& wtx = mapWallet[tx->GetHash()];
+        wtx.fInMempool = true;
+        if (fBroadcastTransactions)
+            wtx.RelayWalletTransaction(connman);
+    }
+    return true;
+}
+
 void CWallet::ListAccountCreditDebit(const std::string& strAccount, std::list<CAccountingEntry>& entries) {
     CWalletDB walletdb(*dbw);
     return walletdb.ListAccountCreditDebit(strAccount, entries);
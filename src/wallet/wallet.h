@@ -983,6 +983,27 @@ public:
                            std::string& strFailReason, const CCoinControl& coin_control, bool sign = true);
     bool CommitTransaction(CWalletTx& wtxNew, CReserveKey& reservekey, CConnman* connman, CValidationState& state);
 
+    /**
+     * Find the unspent role change output (credential) held by this wallet
+     * for the given address, looking at both the chain and the mempool.
+     */
+    bool FindCredential(const CTxDestination& dest, COutPoint& outpointRet, CTxOut& txoutRet) const;
+
+    /**
+     * Pack the given role outputs into a chain of VERSION_ROLE_CREATION
+     * transactions. Each transaction spends the role repeat of the previous
+     * one, the first one spends the given credential. Signing may run on
+     * several threads, so cs_main must not be held.
+     */
+    bool CreateRoleCreationChain(const COutPoint& credential, const CTxOut& credentialOut, const std::vector<CTxOut>& vAccounts,
+                                 std::vector<CTransactionRef>& vtxRet, std::string& strFailReason);
+
+    /**
+     * Submit a chain of transactions to the mempool. Either all of them are
+     * accepted, or the ones accepted so far are removed again.
+     */
+    bool CommitTransactionChain(const std::vector<CTransactionRef>& vtx, CConnman* connman, CValidationState& state);
+
     void ListAccountCreditDebit(const std::string& strAccount, std::list<CAccountingEntry>& entries);
     bool AddAccountingEntry(const CAccountingEntry&);
     bool AddAccountingEntry(const CAccountingEntry&, CWalletDB *pwalletdb);
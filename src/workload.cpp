@@ -0,0 +1,387 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <workload.h>
+
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <consensus/consensus.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
+#include <hash.h>
+#include <script/sign.h>
+#include <script/standard.h>
+#include <versionbits.h>
+
+static const WorkloadProfile WORKLOAD_PROFILES[] = {
+    // name         create change mint forfeit transfer policy
+    {"mixed",         20,     5,   10,     5,      58,      2},
+    {"hierarchy",     70,    20,    5,     0,       5,      0},
+    {"transfer",       5,     1,   10,     2,      82,      0},
+};
+
+const WorkloadProfile* FindWorkloadProfile(const std::string& name)
+{
+    for (const WorkloadProfile& profile : WORKLOAD_PROFILES) {
+        if (name == profile.name)
+            return &profile;
+    }
+    return nullptr;
+}
+
+std::string WorkloadProfileNames()
+{
+    std::string strNames;
+    for (const WorkloadProfile& profile : WORKLOAD_PROFILES)
+        strNames += (strNames.empty() ? "" : ", ") + std::string(profile.name);
+    return strNames;
+}
+
+CChainGenerator::CChainGenerator(uint64_t nSeed, const WorkloadProfile& profile, int nMaxDepth, int64_t nSpacing)
+    : nSeed(nSeed), profile(profile), nMaxDepth(nMaxDepth), nSpacing(nSpacing),
+      rand((CHashWriter(SER_GETHASH, 0) << std::string("workload") << nSeed).GetHash())
+{
+    // The manager's account is granted its roles by the genesis block
+    CKey managerKey = NewKey();
+    managerPubKey = managerKey.GetPubKey();
+    UpdateGenesisManager(CScript() << ToByteVector(managerPubKey) << OP_CHECKSIG);
+    minerScript = GetScriptForDestination(NewKey().GetPubKey().GetID());
+
+    const CBlock& genesis = Params().GenesisBlock();
+    const CTransaction& txMgr = *genesis.vtx[1];
+    GenAccount manager;
+    manager.script = txMgr.vout[0].scriptPubKey;
+    manager.roles = txMgr.vout[0].nRole;
+    manager.credential = COutPoint(txMgr.GetHash(), 0);
+    manager.credentialOut = txMgr.vout[0];
+    manager.nDepth = 0;
+    AddAccount(manager);
+
+    hashPrevBlock = genesis.GetHash();
+    nPrevTime = genesis.nTime;
+}
+
+CKey CChainGenerator::NewKey()
+{
+    CKey key;
+    for (uint32_t nCounter = 0; !key.IsValid(); nCounter++) {
+        uint256 hash = (CHashWriter(SER_GETHASH, 0) << std::string("key") << nSeed << nKeys << nCounter).GetHash();
+        key.Set(hash.begin(), hash.end(), true);
+    }
+    nKeys++;
+    keystore.AddKey(key);
+    return key;
+}
+
+void CChainGenerator::AddAccount(const GenAccount& account)
+{
+    const int nIndex = vAccounts.size();
+    vAccounts.push_back(account);
+    vAll.push_back(nIndex);
+    if (account.roles.fRoleM)
+        vManagers.push_back(nIndex);
+    if (account.roles.fRoleC)
+        vIssuers.push_back(nIndex);
+    if (account.roles.fRoleL)
+        vEnforcers.push_back(nIndex);
+    if (account.roles.fRoleA)
+        vAccountManagers.push_back(nIndex);
+}
+
+/** Pick a random account among the candidates, or -1 if none was found after a few tries */
+int CChainGenerator::PickAccount(const std::vector<int>& vCandidates, const std::function<bool(const GenAccount&)>& filter)
+{
+    if (vCandidates.empty())
+        return -1;
+    for (int nTry = 0; nTry < 16; nTry++) {
+        int nIndex = vCandidates[rand.randrange(vCandidates.size())];
+        if (filter(vAccounts[nIndex]))
+            return nIndex;
+    }
+    return -1;
+}
+
+// Only the credentials and fee inputs are signed, see CheckInputs()
+void CChainGenerator::Sign(CMutableTransaction& tx, const std::vector<CTxOut>& vSpent, size_t nSigned)
+{
+    for (size_t i = 0; i < nSigned; i++) {
+        bool fSigned = SignSignature(keystore, vSpent[i].scriptPubKey, tx, i, vSpent[i].nValue, SIGHASH_ALL);
+        assert(fSigned);
+    }
+}
+
+CTransactionRef CChainGenerator::Finish(CMutableTransaction& tx, int nActor, const std::vector<CTxOut>& vSpent, size_t nSigned)
+{
+    Sign(tx, vSpent, nSigned);
+    CTransactionRef ptx = MakeTransactionRef(tx);
+
+    // The role repeat is the actor's new credential
+    GenAccount& account = vAccounts[nActor];
+    account.credential = COutPoint(ptx->GetHash(), 0);
+    account.credentialOut = ptx->vout[0];
+    return ptx;
+}
+
+/** A manager or account manager grants roles to one to three new accounts */
+CTransactionRef CChainGenerator::CreateAccounts()
+{
+    const bool fManager = vAccountManagers.empty() || rand.randrange(4) != 0;
+    int nActor = PickAccount(fManager ? vManagers : vAccountManagers, [](const GenAccount& a) { return a.CanSign(); });
+    if (nActor < 0)
+        return nullptr;
+    const GenAccount& actor = vAccounts[nActor];
+
+    CMutableTransaction tx;
+    tx.nVersion = CTransaction::VERSION_ROLE_CREATION;
+    tx.vin.emplace_back(actor.credential);
+    tx.vout.emplace_back(actor.roles, actor.script);
+
+    std::vector<GenAccount> vNew;
+    for (int i = 1 + rand.randrange(3); i > 0; i--) {
+        GenAccount account;
+        account.script = GetScriptForDestination(NewKey().GetPubKey().GetID());
+        account.roles.fRoleR = true;
+        account.nDepth = actor.nDepth + 1;
+        // Managers may grant any role, account managers only R
+        if (actor.roles.fRoleM) {
+            switch (rand.randrange(8)) {
+                case 0: account.roles.fRoleM = account.nDepth < nMaxDepth; break;
+                case 1: account.roles.fRoleC = true; break;
+                case 2: account.roles.fRoleL = true; break;
+                case 3: account.roles.fRoleA = true; break;
+                default: break;
+            }
+        }
+        tx.vout.emplace_back(account.roles, account.script);
+        vNew.push_back(account);
+    }
+
+    CTransactionRef ptx = Finish(tx, nActor, {actor.credentialOut}, 1);
+    for (size_t i = 0; i < vNew.size(); i++) {
+        vNew[i].credential = COutPoint(ptx->GetHash(), i + 1);
+        vNew[i].credentialOut = ptx->vout[i + 1];
+        AddAccount(vNew[i]);
+    }
+    return ptx;
+}
+
+/** A manager or law enforcement account disables or re-enables another account */
+CTransactionRef CChainGenerator::ChangeRole()
+{
+    const bool fManager = vEnforcers.empty() || rand.randbool();
+    int nActor = PickAccount(fManager ? vManagers : vEnforcers, [](const GenAccount& a) { return a.CanSign(); });
+    if (nActor < 0)
+        return nullptr;
+    const GenAccount& actor = vAccounts[nActor];
+    // The root manager is never disabled, so that the chain can always grow
+    int nTarget = PickAccount(vAll, [&actor, this](const GenAccount& a) { return &a != &actor && &a != &vAccounts[0]; });
+    if (nTarget < 0)
+        return nullptr;
+    GenAccount& target = vAccounts[nTarget];
+
+    CRoleChangeMode newRoles = target.roles;
+    newRoles.fRoleD = !newRoles.fRoleD;
+
+    CMutableTransaction tx;
+    tx.nVersion = CTransaction::VERSION_ROLE_CHANGE;
+    tx.vin.emplace_back(actor.credential);
+    tx.vin.emplace_back(target.credential);
+    tx.vout.emplace_back(actor.roles, actor.script);
+    tx.vout.emplace_back(newRoles, target.script);
+
+    // The target's credential is replaced, not spent, and is left unsigned
+    CTransactionRef ptx = Finish(tx, nActor, {actor.credentialOut, target.credentialOut}, 1);
+    target.roles = newRoles;
+    target.credential = COutPoint(ptx->GetHash(), 1);
+    target.credentialOut = ptx->vout[1];
+    return ptx;
+}
+
+/** An issuer creates coins for one to three other accounts, within the block's creation limit */
+CTransactionRef CChainGenerator::CreateCoins(CAmount& nCreatedInBlock)
+{
+    int nActor = PickAccount(vIssuers, [](const GenAccount& a) { return a.CanSign(); });
+    if (nActor < 0)
+        return nullptr;
+    const GenAccount& actor = vAccounts[nActor];
+
+    CMutableTransaction tx;
+    tx.nVersion = CTransaction::VERSION_COIN_CREATION;
+    tx.vin.emplace_back(actor.credential);
+    tx.vout.emplace_back(actor.roles, actor.script);
+
+    std::vector<int> vRecipients;
+    for (int i = 1 + rand.randrange(3); i > 0; i--) {
+        CAmount nValue = (1 + rand.randrange(10)) * COIN;
+        if (nCreatedInBlock + nValue > Params().GetManagementPolicy().GetCoinCreationLimit())
+            break;
+        int nRecipient = PickAccount(vAll, [&actor](const GenAccount& a) { return &a != &actor; });
+        if (nRecipient < 0)
+            break;
+        nCreatedInBlock += nValue;
+        tx.vout.emplace_back(nValue, vAccounts[nRecipient].script);
+        vRecipients.push_back(nRecipient);
+    }
+    if (vRecipients.empty())
+        return nullptr;
+
+    CTransactionRef ptx = Finish(tx, nActor, {actor.credentialOut}, 1);
+    for (size_t i = 0; i < vRecipients.size(); i++)
+        vAccounts[vRecipients[i]].vCoins.emplace_back(COutPoint(ptx->GetHash(), i + 1), ptx->vout[i + 1]);
+    return ptx;
+}
+
+/** A law enforcement account seizes a coin of another account */
+CTransactionRef CChainGenerator::ForfeitCoins()
+{
+    int nActor = PickAccount(vEnforcers, [](const GenAccount& a) { return a.CanSign(); });
+    if (nActor < 0)
+        return nullptr;
+    const GenAccount& actor = vAccounts[nActor];
+    int nVictim = PickAccount(vAll, [&actor](const GenAccount& a) { return &a != &actor && !a.vCoins.empty(); });
+    if (nVictim < 0)
+        return nullptr;
+    GenAccount& victim = vAccounts[nVictim];
+    const std::pair<COutPoint, CTxOut> coin = victim.vCoins.back();
+    victim.vCoins.pop_back();
+
+    CMutableTransaction tx;
+    tx.nVersion = CTransaction::VERSION_COIN_FORFEITURE;
+    tx.vin.emplace_back(actor.credential);
+    tx.vin.emplace_back(coin.first);
+    tx.vout.emplace_back(actor.roles, actor.script);
+    tx.vout.emplace_back(coin.second.nValue, actor.script);
+
+    // The seized coin is left unsigned
+    CTransactionRef ptx = Finish(tx, nActor, {actor.credentialOut, coin.second}, 1);
+    vAccounts[nActor].vCoins.emplace_back(COutPoint(ptx->GetHash(), 1), ptx->vout[1]);
+    return ptx;
+}
+
+/** An account pays part of up to three of its coins to another account */
+CTransactionRef CChainGenerator::TransferCoins()
+{
+    int nActor = PickAccount(vAll, [](const GenAccount& a) { return a.CanSign() && !a.vCoins.empty(); });
+    if (nActor < 0)
+        return nullptr;
+    GenAccount& actor = vAccounts[nActor];
+    int nRecipient = PickAccount(vAll, [&actor](const GenAccount& a) { return &a != &actor; });
+    if (nRecipient < 0)
+        return nullptr;
+
+    CMutableTransaction tx;
+    tx.nVersion = CTransaction::VERSION_COIN_TRANSFER;
+    tx.vin.emplace_back(actor.credential);
+    std::vector<CTxOut> vSpent = {actor.credentialOut};
+    CAmount nValueIn = 0;
+    for (int i = std::min<int>(1 + rand.randrange(3), actor.vCoins.size()); i > 0; i--) {
+        tx.vin.emplace_back(actor.vCoins.back().first);
+        vSpent.push_back(actor.vCoins.back().second);
+        nValueIn += actor.vCoins.back().second.nValue;
+        actor.vCoins.pop_back();
+    }
+    const CAmount nPayment = nValueIn * (1 + rand.randrange(100)) / 100;
+    tx.vout.emplace_back(actor.roles, actor.script);
+    tx.vout.emplace_back(nValueIn - nPayment, actor.script);
+    tx.vout.emplace_back(nPayment, vAccounts[nRecipient].script);
+
+    CTransactionRef ptx = Finish(tx, nActor, vSpent, tx.vin.size());
+    if (ptx->vout[1].nValue > 0)
+        actor.vCoins.emplace_back(COutPoint(ptx->GetHash(), 1), ptx->vout[1]);
+    vAccounts[nRecipient].vCoins.emplace_back(COutPoint(ptx->GetHash(), 2), ptx->vout[2]);
+    return ptx;
+}
+
+/** A manager publishes one or two provisional policy parameters */
+CTransactionRef CChainGenerator::ChangePolicy()
+{
+    int nActor = PickAccount(vManagers, [](const GenAccount& a) { return a.CanSign(); });
+    if (nActor < 0)
+        return nullptr;
+    const GenAccount& actor = vAccounts[nActor];
+
+    CMutableTransaction tx;
+    tx.nVersion = CTransaction::VERSION_POLICY_CHANGE;
+    tx.vin.emplace_back(actor.credential);
+    tx.vout.emplace_back(actor.roles, actor.script);
+    // The policy outputs must not go to the actor's address, they are
+    // never spent
+    for (int i = 1 + rand.randrange(2); i > 0; i--)
+        tx.vout.emplace_back(false, 1 + rand.randrange(8), rand.rand32(), minerScript);
+
+    return Finish(tx, nActor, {actor.credentialOut}, 1);
+}
+
+CTransactionRef CChainGenerator::NextTransaction(CAmount& nCreatedInBlock)
+{
+    const int nTotalWeight = profile.nRoleCreation + profile.nRoleChange + profile.nCoinCreation + profile.nCoinForfeiture + profile.nCoinTransfer + profile.nPolicyChange;
+
+    // Fall back to account and coin creation when the picked transaction
+    // type is not possible yet, e.g. no account holds coins.
+    CTransactionRef ptx;
+    int nPick = rand.randrange(nTotalWeight);
+    if ((nPick -= profile.nRoleCreation) < 0)
+        ptx = CreateAccounts();
+    else if ((nPick -= profile.nRoleChange) < 0)
+        ptx = ChangeRole();
+    else if ((nPick -= profile.nCoinCreation) < 0)
+        ptx = CreateCoins(nCreatedInBlock);
+    else if ((nPick -= profile.nCoinForfeiture) < 0)
+        ptx = ForfeitCoins();
+    else if ((nPick -= profile.nCoinTransfer) < 0)
+        ptx = TransferCoins();
+    else
+        ptx = ChangePolicy();
+    if (!ptx)
+        ptx = CreateCoins(nCreatedInBlock);
+    if (!ptx)
+        ptx = CreateAccounts();
+    return ptx;
+}
+
+CBlock CChainGenerator::NextBlock(int nTxs)
+{
+    const Consensus::Params& consensus = Params().GetConsensus();
+    nHeight++;
+
+    CBlock block;
+    block.nVersion = VERSIONBITS_TOP_BITS;
+    block.hashPrevBlock = hashPrevBlock;
+    block.nTime = nPrevTime + nSpacing;
+    block.nBits = Params().GenesisBlock().nBits;
+
+    // Same subsidy as GetBlockSubsidy(), no fees are paid by the generated transactions
+    CMutableTransaction coinbase;
+    coinbase.nVersion = CTransaction::VERSION_COINBASE_TRANSFER;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vin[0].scriptSig = CScript() << nHeight << OP_0;
+    const int nHalvings = nHeight / consensus.nSubsidyHalvingInterval;
+    coinbase.vout.emplace_back(nHalvings >= 64 ? 0 : (50 * COIN) >> nHalvings, minerScript);
+    block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+
+    int64_t nBlockWeight = GetTransactionWeight(*block.vtx[0]) + 4000;
+    CAmount nCreatedInBlock = 0;
+    for (int i = 0; i < nTxs; i++) {
+        CTransactionRef ptx = NextTransaction(nCreatedInBlock);
+        if (!ptx)
+            continue;
+
+        nBlockWeight += GetTransactionWeight(*ptx);
+        block.vtx.push_back(ptx);
+        if (nBlockWeight + 4000 > MAX_BLOCK_WEIGHT)
+            break;
+    }
+
+    // Regtest difficulty, see CheckProofOfWork()
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    arith_uint256 bnTarget;
+    bnTarget.SetCompact(block.nBits);
+    while (UintToArith256(block.GetHash()) > bnTarget)
+        ++block.nNonce;
+
+    hashPrevBlock = block.GetHash();
+    nPrevTime = block.nTime;
+    return block;
+}
@@ -0,0 +1,117 @@
+// Copyright (c) 2018-2019 National Institute of Standards and Technology
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_WORKLOAD_H
+#define BITCOIN_WORKLOAD_H
+
+#include <amount.h>
+#include <key.h>
+#include <keystore.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/** Relative weights of the transaction types generated in each block */
+struct WorkloadProfile {
+    const char* name;
+    int nRoleCreation;
+    int nRoleChange;
+    int nCoinCreation;
+    int nCoinForfeiture;
+    int nCoinTransfer;
+    int nPolicyChange;
+};
+
+/** Find a workload profile by name, or nullptr if there is none */
+const WorkloadProfile* FindWorkloadProfile(const std::string& name);
+
+/** The names of all the workload profiles, comma separated */
+std::string WorkloadProfileNames();
+
+/** An account of the generated chain, along with the unspent coins it holds */
+struct GenAccount {
+    CScript script;
+    CRoleChangeMode roles;
+    COutPoint credential;
+    CTxOut credentialOut;
+    int nDepth;
+    std::vector<std::pair<COutPoint, CTxOut>> vCoins;
+
+    bool CanSign() const { return roles.fRoleR && !roles.fRoleD; }
+};
+
+/**
+ * Deterministic generator of a managed chain. Every account key and every
+ * decision is derived from the seed, so that the same seed and options
+ * always produce the same blocks.
+ *
+ * The generator grants the manager's roles to its own key in the regtest
+ * genesis block, so it has to be created before the genesis block is loaded.
+ * It assumes that every transaction it returns gets confirmed.
+ */
+class CChainGenerator
+{
+public:
+    CChainGenerator(uint64_t nSeed, const WorkloadProfile& profile, int nMaxDepth, int64_t nSpacing);
+
+    const CPubKey& GetManagerPubKey() const { return managerPubKey; }
+    CKey GetManagerKey() const
+    {
+        CKey key;
+        keystore.GetKey(managerPubKey.GetID(), key);
+        return key;
+    }
+    size_t GetAccountCount() const { return vAccounts.size(); }
+
+    /**
+     * Pick a transaction type according to the profile and build it, falling
+     * back to coin and account creation when the type is not possible yet.
+     * nCreatedInBlock is the value created so far by the block the
+     * transaction goes to, which has to stay within the policy limit.
+     */
+    CTransactionRef NextTransaction(CAmount& nCreatedInBlock);
+
+    /** Build the next block of the chain, with up to nTxs transactions */
+    CBlock NextBlock(int nTxs);
+
+private:
+    CKey NewKey();
+    void AddAccount(const GenAccount& account);
+    int PickAccount(const std::vector<int>& vCandidates, const std::function<bool(const GenAccount&)>& filter);
+    void Sign(CMutableTransaction& tx, const std::vector<CTxOut>& vSpent, size_t nSigned);
+    CTransactionRef Finish(CMutableTransaction& tx, int nActor, const std::vector<CTxOut>& vSpent, size_t nSigned);
+
+    CTransactionRef CreateAccounts();
+    CTransactionRef ChangeRole();
+    CTransactionRef CreateCoins(CAmount& nCreatedInBlock);
+    CTransactionRef ForfeitCoins();
+    CTransactionRef TransferCoins();
+    CTransactionRef ChangePolicy();
+
+    const uint64_t nSeed;
+    const WorkloadProfile& profile;
+    const int nMaxDepth;
+    const int64_t nSpacing;
+    FastRandomContext rand;
+
+    uint64_t nKeys = 0;
+    CBasicKeyStore keystore;
+    CPubKey managerPubKey;
+    CScript minerScript;
+
+    std::vector<GenAccount> vAccounts;
+    //! Accounts by the role that lets them issue transactions
+    std::vector<int> vAll, vManagers, vIssuers, vEnforcers, vAccountManagers;
+
+    uint256 hashPrevBlock;
+    uint32_t nPrevTime;
+    int nHeight = 0;
+};
+
+#endif // BITCOIN_WORKLOAD_H
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+# Copyright (c) 2018-2019 National Institute of Standards and Technology
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the createaccounts RPC.
+
+- Create enough accounts from the genesis manager's credential to need a
+  chain of several role creation transactions.
+- Check that the whole chain is accepted to the mempool and mined, and that
+  the account tree then holds the new accounts, consistent with the
+  chainstate.
+- Check that invalid requests are rejected without submitting anything.
+"""
+
+import os
+
+from test_framework.address import byte_to_base58, key_to_p2pkh
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal, assert_greater_than, assert_raises_rpc_error
+
+# The genesis block grants the manager's roles to this key (-managerpubkey)
+MANAGER_PUBKEY = "0261df352749b58049ac67b304c903e346dbf107fab4b8f0c6d2b05bcb58a5bdab"
+MANAGER_PRIVKEY = "cP9wj6TZrK8vcxUPtCfUTSXuayNkrrzTYEucpx5nRvU16S3RQQ5V"
+
+# A standard transaction holds fewer than 3000 account outputs, so this
+# needs a chain of two
+NUM_ACCOUNTS = 3000
+
+def random_address():
+    return byte_to_base58(os.urandom(20), 111)
+
+class CreateAccountsTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+        # Leave room in the package limits for a chain of several transactions
+        self.extra_args = [["-managerpubkey=%s" % MANAGER_PUBKEY, "-limitancestorsize=1000", "-limitdescendantsize=1000"]]
+
+    def setup_network(self, split=False):
+        # Connecting the block that creates the accounts takes a while, as the
+        # account tree is saved after each new account
+        self.add_nodes(self.num_nodes, self.extra_args, timewait=600)
+        self.start_nodes()
+
+    def run_test(self):
+        node = self.nodes[0]
+        manager = key_to_p2pkh(MANAGER_PUBKEY)
+        node.importprivkey(MANAGER_PRIVKEY)
+
+        self.log.info("Reject invalid requests")
+        assert_raises_rpc_error(-8, "no accounts given", node.createaccounts, manager, [])
+        assert_raises_rpc_error(-5, "Invalid Bitcoin address", node.createaccounts, manager, [{"address": "invalid", "roles": "...R.."}])
+        address = random_address()
+        assert_raises_rpc_error(-8, "duplicated address", node.createaccounts, manager,
+                                [{"address": address, "roles": "...R.."}, {"address": address, "roles": "...R.."}])
+        assert_raises_rpc_error(-8, "account uses the credentials address", node.createaccounts, manager, [{"address": manager, "roles": "...R.."}])
+        assert_raises_rpc_error(-4, "No unspent credentials", node.createaccounts, random_address(), [{"address": address, "roles": "...R.."}])
+        assert_equal(node.getrawmempool(), [])
+
+        self.log.info("Create %d accounts" % NUM_ACCOUNTS)
+        accounts = [{"address": random_address(), "roles": "...R.."} for _ in range(NUM_ACCOUNTS)]
+        txids = node.createaccounts(manager, accounts)
+        assert_greater_than(len(txids), 1)
+        assert_equal(sorted(node.getrawmempool()), sorted(txids))
+
+        # Each transaction spends the role repeat of the previous one
+        prevout = None
+        created = []
+        for txid in txids:
+            tx = node.getrawtransaction(txid, True)
+            assert_equal(len(tx["vin"]), 1)
+            if prevout is not None:
+                assert_equal((tx["vin"][0]["txid"], tx["vin"][0]["vout"]), prevout)
+            prevout = (txid, 0)
+            created += [out["scriptPubKey"]["addresses"][0] for out in tx["vout"][1:]]
+        assert_equal(created, [account["address"] for account in accounts])
+
+        self.log.info("Mine the chain")
+        node.generatetoaddress(1, random_address())
+        assert_equal(node.getrawmempool(), [])
+        for txid in txids:
+            assert_equal(node.getrawtransaction(txid, True)["confirmations"], 1)
+
+        result = node.verifyaccounts(2)
+        assert(result["valid"])
+        assert_equal(result["accounts"], NUM_ACCOUNTS + 1)
+        assert_equal(result["role_coins"], NUM_ACCOUNTS + 1)
+
+        self.log.info("Create more accounts from the new credential")
+        more = [{"address": random_address(), "roles": "...R.."} for _ in range(10)]
+        txids = node.createaccounts(manager, more)
+        assert_equal(len(txids), 1)
+        node.generatetoaddress(1, random_address())
+        result = node.verifyaccounts(2)
+        assert(result["valid"])
+        assert_equal(result["accounts"], NUM_ACCOUNTS + 11)
+
+if __name__ == '__main__':
+    CreateAccountsTest().main()